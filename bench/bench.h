@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2012, Ranjith TV
+ * All rights reserved.
+ *
+ * Licensed under the BSD 3-Clause ("BSD New" or "BSD Simplified") license.
+ * You may obtain a copy of the License at
+ *
+ * http://www.opensource.org/licenses/BSD-3-Clause
+ *
+ */
+
+#ifndef TRIE_BENCH_H
+#define TRIE_BENCH_H
+
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <cstdio>
+#include <ctime>
+
+#if __cplusplus >= 201103L
+#include <chrono>
+#endif
+
+namespace bench
+{
+
+// Wall clock time in seconds
+inline double now() {
+#if __cplusplus >= 201103L
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#else
+    return (double)std::clock() / CLOCKS_PER_SEC;
+#endif
+}
+
+// Deterministic pseudo random numbers, so that every run uses the same keys
+class Random
+{
+public:
+    Random(unsigned long seed = 1)
+            : mState(seed) {}
+
+    unsigned long next() {
+        mState = mState * 6364136223846793005ULL + 1442695040888963407ULL;
+        return (unsigned long)(mState >> 33);
+    }
+
+private:
+    unsigned long long mState;
+};
+
+// count keys of lowercase letters, minLength to maxLength symbols long
+inline std::vector<std::string> randomKeys(std::size_t count, std::size_t minLength, std::size_t maxLength,
+                                           unsigned long seed = 1) {
+    Random random(seed);
+    std::vector<std::string> keys;
+    keys.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        std::size_t length = minLength + random.next() % (maxLength - minLength + 1);
+        std::string key;
+        for (std::size_t j = 0; j < length; ++j) {
+            key += (char)('a' + random.next() % 26);
+        }
+        // appending the index makes duplicate keys unlikely
+        for (std::size_t n = i; ; n /= 26) {
+            key += (char)('a' + n % 26);
+            if (n < 26) {
+                break;
+            }
+        }
+        keys.push_back(key);
+    }
+    return keys;
+}
+
+inline std::size_t argument(int argc, char **argv, int index, std::size_t def) {
+    if (argc > index) {
+        return (std::size_t)std::strtoul(argv[index], 0, 10);
+    }
+    return def;
+}
+
+}
+
+#endif
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2012, Ranjith TV
+ * All rights reserved.
+ *
+ * Licensed under the BSD 3-Clause ("BSD New" or "BSD Simplified") license.
+ * You may obtain a copy of the License at
+ *
+ * http://www.opensource.org/licenses/BSD-3-Clause
+ *
+ */
+
+// Compares loading sorted keys one at a time using Trie::insertFast with Trie::bulkLoad,
+// the last row with path compression.
+// usage: bulk_load [number of keys]
+
+#include <trie.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cstdio>
+
+#include "bench.h"
+
+typedef std::vector< std::pair<std::string, std::size_t> > Pairs;
+
+template <typename TrieType>
+double insertAll(const Pairs &pairs, bool compressed) {
+    TrieType trie('\0', compressed);
+    double start = bench::now();
+    for (std::size_t i = 0; i < pairs.size(); ++i) {
+        trie.insertFast(pairs[i].first.c_str(), pairs[i].second);
+    }
+    return bench::now() - start;
+}
+
+template <typename TrieType>
+double bulkLoad(const Pairs &pairs, bool compressed) {
+    TrieType trie('\0', compressed);
+    double start = bench::now();
+    trie.bulkLoad(pairs.begin(), pairs.end());
+    return bench::now() - start;
+}
+
+double best(double current, double t) {
+    return (current == 0 || t < current) ? t : current;
+}
+
+template <typename TrieType>
+void run(const char *name, const Pairs &pairs, bool compressed = false) {
+    // best of a few alternating runs, so that both see a similar state of the heap
+    double insert = 0;
+    double bulk = 0;
+    for (int i = 0; i < 3; ++i) {
+        insert = best(insert, insertAll<TrieType>(pairs, compressed));
+        bulk = best(bulk, bulkLoad<TrieType>(pairs, compressed));
+    }
+
+    double n = pairs.size() / 1e6;
+    std::printf("%-10s %12.2f %12.2f %8.2fx\n", name, n / insert, n / bulk, insert / bulk);
+}
+
+int main(int argc, char **argv) {
+    std::size_t keyCount = bench::argument(argc, argv, 1, 300000);
+
+    std::vector<std::string> keys = bench::randomKeys(keyCount, 8, 24);
+    std::sort(keys.begin(), keys.end());
+    Pairs pairs;
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        pairs.push_back(std::make_pair(keys[i], i));
+    }
+
+    std::printf("%lu sorted keys\n", (unsigned long)keyCount);
+    std::printf("%-10s %12s %12s %9s\n", "items", "insertFast Mops/s", "bulkLoad", "speedup");
+
+    run<rtv::Trie<char, std::size_t> >("set", pairs);
+    run<rtv::Trie<char, std::size_t, std::less<char>,
+                  rtv::AdaptiveItems<char, std::size_t, std::less<char>, 256> > >("adaptive", pairs);
+    run<rtv::Trie<char, std::size_t, std::less<char>,
+                  rtv::AdaptiveItems<char, std::size_t, std::less<char>, 256, rtv::SymbolToIndexMapper<char>,
+                                     rtv::SlabAllocator<> > > >("slab", pairs);
+    run<rtv::Trie<char, std::size_t> >("compressed", pairs, true);
+
+    return 0;
+}
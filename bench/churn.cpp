@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2012, Ranjith TV
+ * All rights reserved.
+ *
+ * Licensed under the BSD 3-Clause ("BSD New" or "BSD Simplified") license.
+ * You may obtain a copy of the License at
+ *
+ * http://www.opensource.org/licenses/BSD-3-Clause
+ *
+ */
+
+// Continuous insertion and removal of session keys, the oldest key is erased
+// every time a new key is inserted so the number of live keys stays the same.
+// usage: churn [number of live keys] [number of operations]
+
+#include <trie.h>
+#include <string>
+#include <vector>
+#include <cstdio>
+
+#include "bench.h"
+
+std::string sessionKey(bench::Random &random) {
+    static const char digits[] = "0123456789abcdef";
+    std::string key("session/");
+    for (int i = 0; i < 40; ++i) {
+        key += digits[random.next() % 16];
+    }
+    return key;
+}
+
+template <typename TrieType>
+void run(const char *name, std::size_t live, std::size_t operations) {
+    bench::Random random(3);
+    std::vector<std::string> window(live);
+    TrieType trie('\0');
+    for (std::size_t i = 0; i < live; ++i) {
+        window[i] = sessionKey(random);
+        trie.insertFast(window[i].c_str(), i);
+    }
+
+    // the keys are replaced in batches so that erase and insert can be timed separately
+    const std::size_t batch = live < 100 ? live : 100;
+    double eraseTime = 0;
+    double insertTime = 0;
+    for (std::size_t i = 0; i < operations; i += batch) {
+        double start = bench::now();
+        for (std::size_t j = i; j < i + batch; ++j) {
+            trie.erase(window[j % live].c_str());
+        }
+        eraseTime += bench::now() - start;
+        for (std::size_t j = i; j < i + batch; ++j) {
+            window[j % live] = sessionKey(random);
+        }
+        start = bench::now();
+        for (std::size_t j = i; j < i + batch; ++j) {
+            trie.insertFast(window[j % live].c_str(), j);
+        }
+        insertTime += bench::now() - start;
+    }
+
+    std::printf("%-10s %12.3f %12.3f %10lu\n", name, operations / eraseTime / 1e6, operations / insertTime / 1e6,
+                (unsigned long)trie.size());
+}
+
+int main(int argc, char **argv) {
+    std::size_t live = bench::argument(argc, argv, 1, 2000);
+    std::size_t operations = bench::argument(argc, argv, 2, 200000);
+
+    std::printf("%lu live keys, %lu keys replaced\n", (unsigned long)live, (unsigned long)operations);
+    std::printf("%-10s %12s %12s %10s\n", "items", "erase Mops/s", "insert", "size");
+
+    run<rtv::Trie<char, std::size_t, std::less<char>,
+                  rtv::VectorItems<char, std::size_t, std::less<char>, 256> > >("vector", live, operations);
+    run<rtv::Trie<char, std::size_t, std::less<char>,
+                  rtv::VectorItems<char, std::size_t, std::less<char>, 256, rtv::SymbolToIndexMapper<char>,
+                                   rtv::SlabAllocator<> > > >("slab", live, operations);
+    run<rtv::Trie<char, std::size_t> >("set", live, operations);
+    run<rtv::Trie<char, std::size_t, std::less<char>,
+                  rtv::AdaptiveItems<char, std::size_t, std::less<char>, 256> > >("adaptive", live, operations);
+
+    return 0;
+}
@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2012, Ranjith TV
+ * All rights reserved.
+ *
+ * Licensed under the BSD 3-Clause ("BSD New" or "BSD Simplified") license.
+ * You may obtain a copy of the License at
+ *
+ * http://www.opensource.org/licenses/BSD-3-Clause
+ *
+ */
+
+// Compares a Trie guarded by a mutex with ConcurrentTrie, when reader threads look up keys
+// and one writer thread modifies a key for every 1000 lookups.
+// usage: concurrent_read [number of keys] [maximum number of readers]
+
+#include <trie.h>
+#include <concurrent_trie.h>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <cstdio>
+
+#include "bench.h"
+
+// Trie behind a mutex, as the shared Tries are used without ConcurrentTrie
+class LockedTrie
+{
+public:
+    LockedTrie()
+            : mTrie('\0') {}
+
+    bool get(const char *key, std::size_t &value) {
+        std::lock_guard<std::mutex> lock(mLock);
+        const std::size_t *found = mTrie.get(key);
+        if (found) {
+            value = *found;
+        }
+        return found != 0;
+    }
+
+    void insertOrAssign(const char *key, std::size_t value) {
+        std::lock_guard<std::mutex> lock(mLock);
+        mTrie.insertOrAssign(key, value);
+    }
+
+    void erase(const char *key) {
+        std::lock_guard<std::mutex> lock(mLock);
+        mTrie.erase(key);
+    }
+
+private:
+    rtv::Trie<char, std::size_t> mTrie;
+    std::mutex mLock;
+};
+
+class SharedTrie
+{
+public:
+    SharedTrie()
+            : mTrie('\0') {}
+
+    bool get(const char *key, std::size_t &value) {
+        return mTrie.get(key, value);
+    }
+
+    void insertOrAssign(const char *key, std::size_t value) {
+        mTrie.insertOrAssign(key, value);
+    }
+
+    void erase(const char *key) {
+        mTrie.erase(key);
+    }
+
+private:
+    rtv::ConcurrentTrie<char, std::size_t> mTrie;
+};
+
+template <typename TrieType>
+double run(const std::vector<std::string> &keys, unsigned int readers, std::size_t lookupsPerReader) {
+    TrieType trie;
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        trie.insertOrAssign(keys[i].c_str(), i);
+    }
+
+    std::atomic<std::size_t> lookups(0);
+    std::atomic<bool> done(false);
+    std::vector<std::thread> threads;
+    double start = bench::now();
+    for (unsigned int r = 0; r < readers; ++r) {
+        threads.push_back(std::thread([&, r]() {
+            bench::Random random(r + 1);
+            std::size_t found = 0;
+            for (std::size_t i = 0; i < lookupsPerReader; ++i) {
+                std::size_t value;
+                found += trie.get(keys[random.next() % keys.size()].c_str(), value);
+                // published in batches, so the readers do not contend on the counter
+                if (i % 1000 == 999) {
+                    lookups += 1000;
+                }
+            }
+            if (found == 0) {
+                std::printf("nothing found\n");
+            }
+        }));
+    }
+
+    // a modification for every 1000 lookups
+    std::thread writer([&]() {
+        bench::Random random(1000);
+        std::size_t writes = 0;
+        while (!done.load()) {
+            if (lookups.load() / 1000 > writes) {
+                std::size_t i = random.next() % keys.size();
+                if (writes % 2) {
+                    trie.insertOrAssign(keys[i].c_str(), i);
+                } else {
+                    trie.erase(keys[i].c_str());
+                }
+                ++writes;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    for (unsigned int r = 0; r < readers; ++r) {
+        threads[r].join();
+    }
+    double elapsed = bench::now() - start;
+    done.store(true);
+    writer.join();
+    return elapsed;
+}
+
+int main(int argc, char **argv) {
+    std::size_t keyCount = bench::argument(argc, argv, 1, 100000);
+    unsigned int maxReaders = (unsigned int)bench::argument(argc, argv, 2,
+                                                            std::max(std::thread::hardware_concurrency(), 1u));
+    const std::size_t lookupsPerReader = 200000;
+
+    std::vector<std::string> keys = bench::randomKeys(keyCount, 8, 24);
+
+    std::printf("%lu keys, %lu lookups per reader\n", (unsigned long)keyCount, (unsigned long)lookupsPerReader);
+    std::printf("%8s %14s %14s %9s\n", "readers", "mutex Mops/s", "concurrent", "speedup");
+    for (unsigned int readers = 1; readers <= maxReaders; readers *= 2) {
+        double locked = run<LockedTrie>(keys, readers, lookupsPerReader);
+        double shared = run<SharedTrie>(keys, readers, lookupsPerReader);
+        double n = readers * lookupsPerReader / 1e6;
+        std::printf("%8u %14.2f %14.2f %8.2fx\n", readers, n / locked, n / shared, locked / shared);
+    }
+
+    return 0;
+}
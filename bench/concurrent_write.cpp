@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2012, Ranjith TV
+ * All rights reserved.
+ *
+ * Licensed under the BSD 3-Clause ("BSD New" or "BSD Simplified") license.
+ * You may obtain a copy of the License at
+ *
+ * http://www.opensource.org/licenses/BSD-3-Clause
+ *
+ */
+
+// Compares a Trie guarded by a mutex with ConcurrentTrie, when every thread updates counters
+// under a subtree of its own: each operation assigns a counter and every 8th erases one.
+// usage: concurrent_write [number of keys per thread] [maximum number of threads]
+
+#include <trie.h>
+#include <concurrent_trie.h>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <cstdio>
+
+#include "bench.h"
+
+// Trie behind a mutex, as the shared Tries are used without ConcurrentTrie
+class LockedTrie
+{
+public:
+    LockedTrie()
+            : mTrie('\0') {}
+
+    void insertOrAssign(const char *key, std::size_t value) {
+        std::lock_guard<std::mutex> lock(mLock);
+        mTrie.insertOrAssign(key, value);
+    }
+
+    void erase(const char *key) {
+        std::lock_guard<std::mutex> lock(mLock);
+        mTrie.erase(key);
+    }
+
+private:
+    rtv::Trie<char, std::size_t> mTrie;
+    std::mutex mLock;
+};
+
+class SharedTrie
+{
+public:
+    SharedTrie()
+            : mTrie('\0') {}
+
+    void insertOrAssign(const char *key, std::size_t value) {
+        mTrie.insertOrAssign(key, value);
+    }
+
+    void erase(const char *key) {
+        mTrie.erase(key);
+    }
+
+private:
+    rtv::ConcurrentTrie<char, std::size_t> mTrie;
+};
+
+template <typename TrieType>
+double run(const std::vector<std::string> &keys, unsigned int threads, std::size_t operationsPerThread) {
+    TrieType trie;
+    std::vector<std::thread> writers;
+    double start = bench::now();
+    for (unsigned int t = 0; t < threads; ++t) {
+        writers.push_back(std::thread([&, t]() {
+            // the thread number is the first symbol, so the threads write to disjoint subtrees
+            std::vector<std::string> own(keys.size());
+            for (std::size_t i = 0; i < keys.size(); ++i) {
+                own[i] = std::string(1, (char)('A' + t)) + keys[i];
+            }
+            bench::Random random(t + 1);
+            for (std::size_t i = 0; i < operationsPerThread; ++i) {
+                const std::string &key = own[random.next() % own.size()];
+                if (i % 8 == 7) {
+                    trie.erase(key.c_str());
+                } else {
+                    trie.insertOrAssign(key.c_str(), i);
+                }
+            }
+        }));
+    }
+    for (unsigned int t = 0; t < threads; ++t) {
+        writers[t].join();
+    }
+    return bench::now() - start;
+}
+
+int main(int argc, char **argv) {
+    std::size_t keyCount = bench::argument(argc, argv, 1, 50000);
+    unsigned int maxThreads = (unsigned int)bench::argument(argc, argv, 2,
+                                                            std::max(std::thread::hardware_concurrency(), 1u));
+    const std::size_t operationsPerThread = 300000;
+
+    std::vector<std::string> keys = bench::randomKeys(keyCount, 8, 24);
+
+    std::printf("%lu keys per thread, %lu operations per thread\n", (unsigned long)keyCount,
+                (unsigned long)operationsPerThread);
+    std::printf("%8s %14s %14s %9s\n", "threads", "mutex Mops/s", "concurrent", "speedup");
+    for (unsigned int threads = 1; threads <= maxThreads; threads *= 2) {
+        double locked = run<LockedTrie>(keys, threads, operationsPerThread);
+        double shared = run<SharedTrie>(keys, threads, operationsPerThread);
+        double n = threads * operationsPerThread / 1e6;
+        std::printf("%8u %14.2f %14.2f %8.2fx\n", threads, n / locked, n / shared, locked / shared);
+    }
+
+    return 0;
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2012, Ranjith TV
+ * All rights reserved.
+ *
+ * Licensed under the BSD 3-Clause ("BSD New" or "BSD Simplified") license.
+ * You may obtain a copy of the License at
+ *
+ * http://www.opensource.org/licenses/BSD-3-Clause
+ *
+ */
+
+// Compares the memory and the lookups of Tries with the DoubleArrayTrie made from them by rtv::freeze.
+// The memory of a Trie is measured as the growth of the heap while it is filled, which needs glibc.
+// The Trie of VectorItems takes about 2KB a node, so the default number of keys is kept small.
+// usage: freeze [number of keys] [number of lookups]
+
+#include <trie.h>
+#include <double_array_trie.h>
+#include <string>
+#include <vector>
+#include <cstdio>
+
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+#include <malloc.h>
+#define BENCH_HEAP_USED() mallinfo2().uordblks
+#else
+#define BENCH_HEAP_USED() 0
+#endif
+
+#include "bench.h"
+
+template <typename Lookup>
+double lookupRate(Lookup const &lookup, const std::vector<const char *> &order) {
+    std::size_t sum = 0;
+    double start = bench::now();
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        sum += *lookup.get(order[i]);
+    }
+    double elapsed = bench::now() - start;
+    if (sum == 0) {
+        std::printf("nothing found\n");
+    }
+    return order.size() / elapsed / 1e6;
+}
+
+template <typename TrieType>
+void run(const char *name, const std::vector<std::string> &keys, const std::vector<const char *> &order) {
+    std::size_t before = BENCH_HEAP_USED();
+    TrieType *trie = new TrieType('\0');
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        trie->insert(keys[i].c_str(), i);
+    }
+    std::size_t trieMemory = BENCH_HEAP_USED() - before;
+
+    double start = bench::now();
+    rtv::DoubleArrayTrie<char, std::size_t> frozen = rtv::freeze(*trie);
+    double freezing = bench::now() - start;
+
+    double trieRate = lookupRate(*trie, order);
+    double frozenRate = lookupRate(frozen, order);
+    std::printf("%-8s %12.1f %12.1f %10.3f %12.2f %12.2f\n", name, trieMemory / 1048576.0,
+                frozen.memoryUsage() / 1048576.0, freezing, trieRate, frozenRate);
+    delete trie;
+}
+
+int main(int argc, char **argv) {
+    std::size_t keyCount = bench::argument(argc, argv, 1, 20000);
+    std::size_t lookups = bench::argument(argc, argv, 2, 1000000);
+
+    std::vector<std::string> keys = bench::randomKeys(keyCount, 8, 24);
+    bench::Random random(7);
+    std::vector<const char *> order(lookups);
+    for (std::size_t i = 0; i < lookups; ++i) {
+        order[i] = keys[random.next() % keys.size()].c_str();
+    }
+
+    std::printf("%lu keys, %lu lookups\n", (unsigned long)keyCount, (unsigned long)lookups);
+    std::printf("%-8s %12s %12s %10s %12s %12s\n", "items", "Trie MB", "frozen MB", "freeze s",
+                "Trie Mops/s", "frozen");
+    run< rtv::Trie<char, std::size_t> >("set", keys, order);
+    run< rtv::Trie<char, std::size_t, std::less<char>,
+                   rtv::VectorItems<char, std::size_t, std::less<char>, 256> > >("vector", keys, order);
+    run< rtv::Trie<char, std::size_t, std::less<char>,
+                   rtv::AdaptiveItems<char, std::size_t, std::less<char> > > >("adaptive", keys, order);
+
+    return 0;
+}
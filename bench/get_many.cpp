@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2012, Ranjith TV
+ * All rights reserved.
+ *
+ * Licensed under the BSD 3-Clause ("BSD New" or "BSD Simplified") license.
+ * You may obtain a copy of the License at
+ *
+ * http://www.opensource.org/licenses/BSD-3-Clause
+ *
+ */
+
+// Compares looking up keys one at a time using Trie::get with batched lookup using Trie::getMany.
+// usage: get_many [number of keys] [number of lookups] [batch size]
+
+#include <trie.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+
+#include "bench.h"
+
+template <typename TrieType>
+void run(const char *name, const std::vector<std::string> &keys, std::size_t lookups, std::size_t batch) {
+    TrieType trie('\0');
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        trie.insert(keys[i].c_str(), i);
+    }
+
+    bench::Random random(7);
+    std::vector<const char *> order(lookups);
+    for (std::size_t i = 0; i < lookups; ++i) {
+        order[i] = keys[random.next() % keys.size()].c_str();
+    }
+
+    std::size_t sum = 0;
+    double start = bench::now();
+    for (std::size_t i = 0; i < lookups; ++i) {
+        sum += *trie.get(order[i]);
+    }
+    double single = bench::now() - start;
+
+    std::vector<std::size_t *> values(batch);
+    std::size_t batchSum = 0;
+    start = bench::now();
+    for (std::size_t i = 0; i < lookups; i += batch) {
+        std::size_t count = std::min(batch, lookups - i);
+        trie.getMany(&order[i], count, &values[0]);
+        for (std::size_t j = 0; j < count; ++j) {
+            batchSum += *values[j];
+        }
+    }
+    double batched = bench::now() - start;
+
+    std::printf("%-10s %12.2f %12.2f %8.2fx%s\n", name,
+                lookups / single / 1e6, lookups / batched / 1e6, single / batched,
+                sum == batchSum ? "" : "  (mismatch)");
+}
+
+int main(int argc, char **argv) {
+    std::size_t keyCount = bench::argument(argc, argv, 1, 300000);
+    std::size_t lookups = bench::argument(argc, argv, 2, 2000000);
+    std::size_t batch = bench::argument(argc, argv, 3, 64);
+
+    std::vector<std::string> keys = bench::randomKeys(keyCount, 8, 24);
+
+    std::printf("%lu keys, %lu lookups, batches of %lu\n",
+                (unsigned long)keyCount, (unsigned long)lookups, (unsigned long)batch);
+    std::printf("%-10s %12s %12s %9s\n", "items", "get Mops/s", "getMany", "speedup");
+
+    run<rtv::Trie<char, std::size_t> >("set", keys, lookups, batch);
+    run<rtv::Trie<char, std::size_t, std::less<char>,
+                  rtv::AdaptiveItems<char, std::size_t, std::less<char>, 256> > >("adaptive", keys, lookups, batch);
+    run<rtv::Trie<char, std::size_t, std::less<char>,
+                  rtv::AdaptiveItems<char, std::size_t, std::less<char>, 256, rtv::SymbolToIndexMapper<char>,
+                                     rtv::SlabAllocator<> > > >("slab", keys, lookups, batch);
+
+    return 0;
+}
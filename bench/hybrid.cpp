@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2012, Ranjith TV
+ * All rights reserved.
+ *
+ * Licensed under the BSD 3-Clause ("BSD New" or "BSD Simplified") license.
+ * You may obtain a copy of the License at
+ *
+ * http://www.opensource.org/licenses/BSD-3-Clause
+ *
+ */
+
+// Prints the report of Trie::stats for the keys, telling the bytes HybridItems takes with each cutoff depth,
+// then measures the memory and the lookups of HybridItems with the cutoffs 0 to 3.
+// The keys are read from a file, one a line, or made at random. The memory is measured as the growth
+// of the heap while the Trie is filled, which needs glibc.
+// usage: hybrid [file of keys | number of random keys] [number of lookups]
+
+#include <trie.h>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+#include <malloc.h>
+#define BENCH_HEAP_USED() mallinfo2().uordblks
+#else
+#define BENCH_HEAP_USED() 0
+#endif
+
+#include "bench.h"
+
+typedef rtv::HybridItems<char, std::size_t, std::less<char>, 0, 256> Hybrid0;
+typedef rtv::HybridItems<char, std::size_t, std::less<char>, 1, 256> Hybrid1;
+typedef rtv::HybridItems<char, std::size_t, std::less<char>, 2, 256> Hybrid2;
+typedef rtv::HybridItems<char, std::size_t, std::less<char>, 3, 256> Hybrid3;
+
+template <typename Items>
+void run(const char *name, const std::vector<std::string> &keys, const std::vector<const char *> &order) {
+    typedef rtv::Trie<char, std::size_t, std::less<char>, Items> TrieType;
+
+    std::size_t before = BENCH_HEAP_USED();
+    TrieType *trie = new TrieType('\0');
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        trie->insert(keys[i].c_str(), i);
+    }
+    std::size_t memory = BENCH_HEAP_USED() - before;
+
+    std::size_t sum = 0;
+    double start = bench::now();
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        sum += *trie->get(order[i]);
+    }
+    double lookup = bench::now() - start;
+    if (sum == 0) {
+        std::printf("nothing found\n");
+    }
+    std::printf("%-8s %12.1f %12.1f %12.2f\n", name, memory / 1048576.0, (double)memory / trie->size(),
+                order.size() / lookup / 1e6);
+    delete trie;
+}
+
+std::vector<std::string> readKeys(const char *path) {
+    std::vector<std::string> keys;
+    std::FILE *in = std::fopen(path, "r");
+    if (!in) {
+        return keys;
+    }
+    std::string key;
+    for (int c = std::fgetc(in); c != EOF; c = std::fgetc(in)) {
+        if (c == '\n') {
+            keys.push_back(key);
+            key.clear();
+        } else if (c != '\r' && c != '\0') {
+            key += (char)c;
+        }
+    }
+    if (!key.empty()) {
+        keys.push_back(key);
+    }
+    std::fclose(in);
+    return keys;
+}
+
+int main(int argc, char **argv) {
+    std::vector<std::string> keys;
+    if (argc > 1 && std::strtoul(argv[1], 0, 10) == 0) {
+        keys = readKeys(argv[1]);
+    } else {
+        keys = bench::randomKeys(bench::argument(argc, argv, 1, 100000), 8, 24);
+    }
+    std::size_t lookups = bench::argument(argc, argv, 2, 1000000);
+    if (keys.empty()) {
+        std::printf("no keys\n");
+        return 1;
+    }
+
+    bench::Random random(7);
+    std::vector<const char *> order(lookups);
+    for (std::size_t i = 0; i < lookups; ++i) {
+        order[i] = keys[random.next() % keys.size()].c_str();
+    }
+
+    // the counts do not depend on the Items of the Trie
+    rtv::TrieStats stats;
+    {
+        rtv::Trie<char, std::size_t> trie('\0');
+        for (std::size_t i = 0; i < keys.size(); ++i) {
+            trie.insert(keys[i].c_str(), i);
+        }
+        stats = trie.stats();
+    }
+    stats.report<Hybrid0>(stdout);
+
+    std::printf("\n%lu keys, %lu lookups\n", (unsigned long)keys.size(), (unsigned long)lookups);
+    std::printf("%-8s %12s %12s %12s\n", "cutoff", "MB", "bytes/key", "Mops/s");
+    run<Hybrid0>("0", keys, order);
+    run<Hybrid1>("1", keys, order);
+    run<Hybrid2>("2", keys, order);
+    run<Hybrid3>("3", keys, order);
+
+    return 0;
+}
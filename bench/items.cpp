@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2012, Ranjith TV
+ * All rights reserved.
+ *
+ * Licensed under the BSD 3-Clause ("BSD New" or "BSD Simplified") license.
+ * You may obtain a copy of the License at
+ *
+ * http://www.opensource.org/licenses/BSD-3-Clause
+ *
+ */
+
+// Compares the memory, the insertion and the lookups of a Trie with each of the Items policies.
+// The memory is measured as the growth of the heap while the Trie is filled, which needs glibc.
+// The Trie of VectorItems takes about 2KB a node, so the default number of keys is kept small.
+// The heap left by each Trie affects the ones made after it, a single policy is run by naming it.
+// usage: items [number of keys] [number of lookups] [set|adaptive|sorted|bitmap|vector]
+
+#include <trie.h>
+#include <string>
+#include <vector>
+#include <cstdio>
+
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+#include <malloc.h>
+#define BENCH_HEAP_USED() mallinfo2().uordblks
+#else
+#define BENCH_HEAP_USED() 0
+#endif
+
+#include "bench.h"
+
+template <typename TrieType>
+void run(const char *name, const std::vector<std::string> &keys, const std::vector<const char *> &order) {
+    std::size_t before = BENCH_HEAP_USED();
+    double start = bench::now();
+    TrieType *trie = new TrieType('\0');
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        trie->insert(keys[i].c_str(), i);
+    }
+    double insertion = bench::now() - start;
+    std::size_t memory = BENCH_HEAP_USED() - before;
+
+    std::size_t sum = 0;
+    start = bench::now();
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        sum += *trie->get(order[i]);
+    }
+    double lookup = bench::now() - start;
+    if (sum == 0) {
+        std::printf("nothing found\n");
+    }
+
+    std::printf("%-8s %12.1f %12.1f %12.3f %12.2f\n", name, memory / 1048576.0, (double)memory / keys.size(),
+                insertion, order.size() / lookup / 1e6);
+    delete trie;
+}
+
+int main(int argc, char **argv) {
+    std::size_t keyCount = bench::argument(argc, argv, 1, 20000);
+    std::size_t lookups = bench::argument(argc, argv, 2, 1000000);
+
+    std::vector<std::string> keys = bench::randomKeys(keyCount, 8, 24);
+    bench::Random random(7);
+    std::vector<const char *> order(lookups);
+    for (std::size_t i = 0; i < lookups; ++i) {
+        order[i] = keys[random.next() % keys.size()].c_str();
+    }
+
+    std::printf("%lu keys, %lu lookups\n", (unsigned long)keyCount, (unsigned long)lookups);
+    std::printf("%-8s %12s %12s %12s %12s\n", "items", "MB", "bytes/key", "insert s", "Mops/s");
+    std::string only = argc > 3 ? argv[3] : "";
+    if (only.empty() || only == "set") {
+        run< rtv::Trie<char, std::size_t> >("set", keys, order);
+    }
+    if (only.empty() || only == "adaptive") {
+        run< rtv::Trie<char, std::size_t, std::less<char>,
+                       rtv::AdaptiveItems<char, std::size_t, std::less<char> > > >("adaptive", keys, order);
+    }
+    if (only.empty() || only == "sorted") {
+        run< rtv::Trie<char, std::size_t, std::less<char>,
+                       rtv::SortedArrayItems<char, std::size_t, std::less<char> > > >("sorted", keys, order);
+    }
+    if (only.empty() || only == "bitmap") {
+        run< rtv::Trie<char, std::size_t, std::less<char>,
+                       rtv::BitmapItems<char, std::size_t, std::less<char>, 256> > >("bitmap", keys, order);
+    }
+    // the large arrays freed by this Trie slow down the Tries made after it, so it is the last
+    if (only.empty() || only == "vector") {
+        run< rtv::Trie<char, std::size_t, std::less<char>,
+                       rtv::VectorItems<char, std::size_t, std::less<char>, 256> > >("vector", keys, order);
+    }
+
+    return 0;
+}
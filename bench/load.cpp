@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2012, Ranjith TV
+ * All rights reserved.
+ *
+ * Licensed under the BSD 3-Clause ("BSD New" or "BSD Simplified") license.
+ * You may obtain a copy of the License at
+ *
+ * http://www.opensource.org/licenses/BSD-3-Clause
+ *
+ */
+
+// Compares loading keys using Trie::insert, which builds an Iterator for every key,
+// with Trie::insertFast.
+// usage: load [number of keys]
+
+#include <trie.h>
+#include <string>
+#include <vector>
+#include <cstdio>
+
+#include "bench.h"
+
+template <typename TrieType, bool Fast>
+double insertAll(TrieType &trie, const std::vector<std::string> &keys) {
+    double start = bench::now();
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        if (Fast) {
+            trie.insertFast(keys[i].c_str(), i);
+        } else {
+            trie.insert(keys[i].c_str(), i);
+        }
+    }
+    return bench::now() - start;
+}
+
+template <typename TrieType, bool Fast>
+double load(const std::vector<std::string> &keys) {
+    TrieType trie('\0');
+    return insertAll<TrieType, Fast>(trie, keys);
+}
+
+double best(double current, double t) {
+    return (current == 0 || t < current) ? t : current;
+}
+
+template <typename TrieType>
+void run(const char *name, const std::vector<std::string> &keys) {
+    // best of a few alternating runs, so that both see a similar state of the heap
+    double insert = 0;
+    double insertFast = 0;
+    for (int i = 0; i < 3; ++i) {
+        insert = best(insert, load<TrieType, false>(keys));
+        insertFast = best(insertFast, load<TrieType, true>(keys));
+    }
+
+    // inserting the keys again in to the same loaded Trie does no allocation
+    // and shows the cost of building the result of the insertion
+    double reinsert = 0;
+    double reinsertFast = 0;
+    TrieType trie('\0');
+    insertAll<TrieType, true>(trie, keys);
+    for (int i = 0; i < 3; ++i) {
+        reinsert = best(reinsert, insertAll<TrieType, false>(trie, keys));
+        reinsertFast = best(reinsertFast, insertAll<TrieType, true>(trie, keys));
+    }
+
+    double n = keys.size() / 1e6;
+    std::printf("%-10s %-8s %12.2f %12.2f %8.2fx\n", name, "load",
+                n / insert, n / insertFast, insert / insertFast);
+    std::printf("%-10s %-8s %12.2f %12.2f %8.2fx\n", name, "reinsert",
+                n / reinsert, n / reinsertFast, reinsert / reinsertFast);
+}
+
+int main(int argc, char **argv) {
+    std::size_t keyCount = bench::argument(argc, argv, 1, 300000);
+
+    std::vector<std::string> keys = bench::randomKeys(keyCount, 8, 24);
+
+    std::printf("%lu keys\n", (unsigned long)keyCount);
+    std::printf("%-10s %-8s %12s %12s %9s\n", "items", "", "insert Mops/s", "insertFast", "speedup");
+
+    run<rtv::Trie<char, std::size_t> >("set", keys);
+    run<rtv::Trie<char, std::size_t, std::less<char>,
+                  rtv::AdaptiveItems<char, std::size_t, std::less<char>, 256> > >("adaptive", keys);
+    run<rtv::Trie<char, std::size_t, std::less<char>,
+                  rtv::AdaptiveItems<char, std::size_t, std::less<char>, 256, rtv::SymbolToIndexMapper<char>,
+                                     rtv::SlabAllocator<> > > >("slab", keys);
+
+    return 0;
+}
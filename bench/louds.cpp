@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2012, Ranjith TV
+ * All rights reserved.
+ *
+ * Licensed under the BSD 3-Clause ("BSD New" or "BSD Simplified") license.
+ * You may obtain a copy of the License at
+ *
+ * http://www.opensource.org/licenses/BSD-3-Clause
+ *
+ */
+
+// Compares the memory and the lookups of a Trie, the DoubleArrayTrie and the LoudsTrie made from it.
+// The memory of the Trie is measured as the growth of the heap while it is filled, which needs glibc.
+// usage: louds [number of keys] [number of lookups]
+
+#include <trie.h>
+#include <double_array_trie.h>
+#include <louds_trie.h>
+#include <string>
+#include <vector>
+#include <cstdio>
+
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+#include <malloc.h>
+#define BENCH_HEAP_USED() mallinfo2().uordblks
+#else
+#define BENCH_HEAP_USED() 0
+#endif
+
+#include "bench.h"
+
+template <typename Lookup>
+double lookupRate(Lookup const &lookup, const std::vector<const char *> &order) {
+    std::size_t sum = 0;
+    double start = bench::now();
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        sum += *lookup.get(order[i]);
+    }
+    double elapsed = bench::now() - start;
+    if (sum == 0) {
+        std::printf("nothing found\n");
+    }
+    return order.size() / elapsed / 1e6;
+}
+
+void report(const char *name, double megabytes, double building, double rate) {
+    std::printf("%-16s %12.1f %10.3f %12.2f\n", name, megabytes, building, rate);
+}
+
+int main(int argc, char **argv) {
+    std::size_t keyCount = bench::argument(argc, argv, 1, 100000);
+    std::size_t lookups = bench::argument(argc, argv, 2, 1000000);
+
+    std::vector<std::string> keys = bench::randomKeys(keyCount, 4, 12);
+    bench::Random random(7);
+    std::vector<const char *> order(lookups);
+    for (std::size_t i = 0; i < lookups; ++i) {
+        order[i] = keys[random.next() % keys.size()].c_str();
+    }
+
+    std::size_t before = BENCH_HEAP_USED();
+    double start = bench::now();
+    rtv::Trie<char, std::size_t> trie('\0');
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        trie.insert(keys[i].c_str(), i);
+    }
+    double inserting = bench::now() - start;
+    std::size_t trieMemory = BENCH_HEAP_USED() - before;
+
+    start = bench::now();
+    rtv::DoubleArrayTrie<char, std::size_t> frozen = rtv::freeze(trie);
+    double freezing = bench::now() - start;
+
+    start = bench::now();
+    rtv::LoudsTrie<char, std::size_t> louds(trie);
+    double encoding = bench::now() - start;
+
+    std::printf("%lu keys, %lu nodes, %lu lookups\n", (unsigned long)keyCount, (unsigned long)louds.nodeCount(),
+                (unsigned long)lookups);
+    std::printf("%-16s %12s %10s %12s\n", "", "MB", "build s", "get Mops/s");
+    report("Trie", trieMemory / 1048576.0, inserting, lookupRate(trie, order));
+    report("DoubleArrayTrie", frozen.memoryUsage() / 1048576.0, freezing, lookupRate(frozen, order));
+    report("LoudsTrie", louds.memoryUsage() / 1048576.0, encoding, lookupRate(louds, order));
+    std::printf("LoudsTrie shape %.2f bits a node, values %.1f MB\n", (double)louds.shapeBits() / louds.nodeCount(),
+                louds.size() * sizeof(std::size_t) / 1048576.0);
+    return 0;
+}
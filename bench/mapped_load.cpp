@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2012, Ranjith TV
+ * All rights reserved.
+ *
+ * Licensed under the BSD 3-Clause ("BSD New" or "BSD Simplified") license.
+ * You may obtain a copy of the License at
+ *
+ * http://www.opensource.org/licenses/BSD-3-Clause
+ *
+ */
+
+// Compares getting a Trie ready by inserting every key with mapping a file written by Trie::save,
+// and the lookups of both.
+// usage: mapped_load [number of keys] [number of lookups] [file]
+
+#include <trie.h>
+#include <mapped_trie.h>
+#include <string>
+#include <vector>
+#include <cstdio>
+
+#include "bench.h"
+
+int main(int argc, char **argv) {
+    std::size_t keyCount = bench::argument(argc, argv, 1, 300000);
+    std::size_t lookups = bench::argument(argc, argv, 2, 1000000);
+    const char *path = argc > 3 ? argv[3] : "mapped_load.bin";
+
+    std::vector<std::string> keys = bench::randomKeys(keyCount, 8, 24);
+    bench::Random random(7);
+    std::vector<const char *> order(lookups);
+    for (std::size_t i = 0; i < lookups; ++i) {
+        order[i] = keys[random.next() % keys.size()].c_str();
+    }
+
+    rtv::Trie<char, std::size_t> trie('\0');
+    double start = bench::now();
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        trie.insert(keys[i].c_str(), i);
+    }
+    double insert = bench::now() - start;
+
+    start = bench::now();
+    if (!trie.save(path)) {
+        std::printf("could not write %s\n", path);
+        return 1;
+    }
+    double save = bench::now() - start;
+
+    // the first lookup is counted, as the process is ready only after it
+    rtv::MappedTrie<char, std::size_t> mapped;
+    start = bench::now();
+    if (!mapped.open(path) || !mapped.get(order[0])) {
+        std::printf("could not map %s\n", path);
+        return 1;
+    }
+    double open = bench::now() - start;
+
+    std::size_t sum = 0;
+    start = bench::now();
+    for (std::size_t i = 0; i < lookups; ++i) {
+        sum += *trie.get(order[i]);
+    }
+    double trieGet = bench::now() - start;
+
+    start = bench::now();
+    for (std::size_t i = 0; i < lookups; ++i) {
+        sum -= *mapped.get(order[i]);
+    }
+    double mappedGet = bench::now() - start;
+
+    std::printf("%lu keys, %lu lookups%s\n", (unsigned long)keyCount, (unsigned long)lookups, sum ? " (wrong sum)" : "");
+    std::printf("%-28s %10.4f s\n", "insert every key", insert);
+    std::printf("%-28s %10.4f s\n", "save", save);
+    std::printf("%-28s %10.4f s\n", "map and first lookup", open);
+    std::printf("%-28s %10.2f Mops/s\n", "Trie::get", lookups / trieGet / 1e6);
+    std::printf("%-28s %10.2f Mops/s\n", "MappedTrie::get", lookups / mappedGet / 1e6);
+
+    mapped.close();
+    std::remove(path);
+    return 0;
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2012, Ranjith TV
+ * All rights reserved.
+ *
+ * Licensed under the BSD 3-Clause ("BSD New" or "BSD Simplified") license.
+ * You may obtain a copy of the License at
+ *
+ * http://www.opensource.org/licenses/BSD-3-Clause
+ *
+ */
+
+// Counts the n-grams of a text of token numbers in a Trie with each of the Items policies for large alphabets,
+// then looks up the n-grams of the text in random order.
+// The tokens follow a Zipf like distribution, so the nodes near the root hold thousands of items.
+// The memory is measured as the growth of the heap while the Trie is filled, which needs glibc.
+// The heap left by each Trie affects the ones made after it, a single policy is run by naming it.
+// usage: ngram [number of tokens] [vocabulary size] [n] [set|sorted|hash]
+
+#include <trie.h>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cstdio>
+
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+#include <malloc.h>
+#define BENCH_HEAP_USED() mallinfo2().uordblks
+#else
+#define BENCH_HEAP_USED() 0
+#endif
+
+#include "bench.h"
+
+template <typename TrieType>
+void run(const char *name, const std::vector<unsigned int> &text, std::size_t n,
+         const std::vector<std::size_t> &order) {
+    std::size_t before = BENCH_HEAP_USED();
+    double start = bench::now();
+    TrieType *trie = new TrieType(0xffffffffu);
+    for (std::size_t i = 0; i + n <= text.size(); ++i) {
+        ++*trie->insertFast(&text[i], n, 0).first;
+    }
+    double counting = bench::now() - start;
+    std::size_t memory = BENCH_HEAP_USED() - before;
+
+    std::size_t sum = 0;
+    start = bench::now();
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        sum += *trie->get(&text[order[i]], n);
+    }
+    double lookup = bench::now() - start;
+
+    std::printf("%-8s %10lu %12.1f %12.1f %12.3f %12.2f\n", name, (unsigned long)trie->size(), memory / 1048576.0,
+                (double)memory / trie->size(), counting, order.size() / lookup / 1e6);
+    if (sum < order.size()) {
+        std::printf("missing n-grams\n");
+    }
+    delete trie;
+}
+
+int main(int argc, char **argv) {
+    std::size_t tokens = bench::argument(argc, argv, 1, 2000000);
+    std::size_t vocabulary = bench::argument(argc, argv, 2, 100000);
+    std::size_t n = bench::argument(argc, argv, 3, 3);
+
+    // token r is drawn with a probability propotional to 1 / (r + 1)
+    bench::Random random(5);
+    double logVocabulary = std::log((double)vocabulary + 1);
+    std::vector<unsigned int> text(tokens);
+    for (std::size_t i = 0; i < tokens; ++i) {
+        double uniform = (random.next() % 1000000 + 0.5) / 1000000;
+        text[i] = (unsigned int)(std::exp(uniform * logVocabulary) - 1);
+    }
+    std::vector<std::size_t> order(1000000);
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        order[i] = random.next() % (tokens - n + 1);
+    }
+
+    std::printf("%lu tokens, %lu words, %lu-grams, %lu lookups\n", (unsigned long)tokens, (unsigned long)vocabulary,
+                (unsigned long)n, (unsigned long)order.size());
+    std::printf("%-8s %10s %12s %12s %12s %12s\n", "items", "n-grams", "MB", "bytes/ngram", "count s", "Mops/s");
+    std::string only = argc > 4 ? argv[4] : "";
+    if (only.empty() || only == "set") {
+        run< rtv::Trie<unsigned int, unsigned int> >("set", text, n, order);
+    }
+    if (only.empty() || only == "sorted") {
+        run< rtv::Trie<unsigned int, unsigned int, std::less<unsigned int>,
+                       rtv::SortedArrayItems<unsigned int, unsigned int, std::less<unsigned int> > > >(
+                           "sorted", text, n, order);
+    }
+    if (only.empty() || only == "hash") {
+        run< rtv::Trie<unsigned int, unsigned int, std::less<unsigned int>,
+                       rtv::HashItems<unsigned int, unsigned int, std::less<unsigned int> > > >(
+                           "hash", text, n, order);
+    }
+
+    return 0;
+}
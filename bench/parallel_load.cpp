@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2012, Ranjith TV
+ * All rights reserved.
+ *
+ * Licensed under the BSD 3-Clause ("BSD New" or "BSD Simplified") license.
+ * You may obtain a copy of the License at
+ *
+ * http://www.opensource.org/licenses/BSD-3-Clause
+ *
+ */
+
+// Compares loading sorted keys using Trie::bulkLoad with Trie::parallelLoad on a growing
+// number of threads.
+// usage: parallel_load [number of keys] [maximum number of threads]
+
+#include <trie.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <thread>
+#include <cstdio>
+
+#include "bench.h"
+
+typedef std::vector< std::pair<std::string, std::size_t> > Pairs;
+
+template <typename TrieType>
+double load(const Pairs &pairs, unsigned int threads) {
+    {
+        // the first large allocation after destroying the Trie of the previous run merges all its
+        // freed blocks, keep that out of the timed region as the grouping of the keys would pay it
+        std::vector<char> large(1 << 24);
+    }
+    TrieType trie('\0');
+    double start = bench::now();
+    if (threads == 0) {
+        trie.bulkLoad(pairs.begin(), pairs.end());
+    } else {
+        trie.parallelLoad(pairs.begin(), pairs.end(), threads);
+    }
+    return bench::now() - start;
+}
+
+double best(double current, double t) {
+    return (current == 0 || t < current) ? t : current;
+}
+
+template <typename TrieType>
+void run(const char *name, const Pairs &pairs, unsigned int maxThreads) {
+    double bulk = 0;
+    for (int i = 0; i < 3; ++i) {
+        bulk = best(bulk, load<TrieType>(pairs, 0));
+    }
+    double n = pairs.size() / 1e6;
+    std::printf("%-10s %8s %12.2f\n", name, "bulk", n / bulk);
+
+    for (unsigned int threads = 1; threads <= maxThreads; threads *= 2) {
+        double parallel = 0;
+        for (int i = 0; i < 3; ++i) {
+            parallel = best(parallel, load<TrieType>(pairs, threads));
+        }
+        std::printf("%-10s %8u %12.2f %8.2fx\n", name, threads, n / parallel, bulk / parallel);
+    }
+}
+
+int main(int argc, char **argv) {
+    std::size_t keyCount = bench::argument(argc, argv, 1, 300000);
+    unsigned int maxThreads = (unsigned int)bench::argument(argc, argv, 2,
+                                                            std::max(std::thread::hardware_concurrency(), 1u));
+
+    std::vector<std::string> keys = bench::randomKeys(keyCount, 8, 24);
+    std::sort(keys.begin(), keys.end());
+    Pairs pairs;
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        pairs.push_back(std::make_pair(keys[i], i));
+    }
+
+    std::printf("%lu sorted keys\n", (unsigned long)keyCount);
+    std::printf("%-10s %8s %12s %9s\n", "items", "threads", "Mops/s", "speedup");
+
+    run<rtv::Trie<char, std::size_t> >("set", pairs, maxThreads);
+    run<rtv::Trie<char, std::size_t, std::less<char>,
+                  rtv::AdaptiveItems<char, std::size_t, std::less<char>, 256, rtv::SymbolToIndexMapper<char>,
+                                     rtv::SlabAllocator<> > > >("slab", pairs, maxThreads);
+
+    return 0;
+}
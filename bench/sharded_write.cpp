@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2012, Ranjith TV
+ * All rights reserved.
+ *
+ * Licensed under the BSD 3-Clause ("BSD New" or "BSD Simplified") license.
+ * You may obtain a copy of the License at
+ *
+ * http://www.opensource.org/licenses/BSD-3-Clause
+ *
+ */
+
+// Compares a Trie guarded by a mutex with ShardedTrie, when threads insert disjoint parts of the keys
+// and when threads do one write for every 9 lookups.
+// usage: sharded_write [number of keys] [maximum number of threads] [number of shards]
+
+#include <trie.h>
+#include <sharded_trie.h>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <cstdio>
+
+#include "bench.h"
+
+// Trie behind a mutex, as the shared Tries are used without ShardedTrie
+class LockedTrie
+{
+public:
+    explicit LockedTrie(std::size_t)
+            : mTrie('\0') {}
+
+    bool get(const char *key, std::size_t &value) {
+        std::lock_guard<std::mutex> lock(mLock);
+        const std::size_t *found = mTrie.get(key);
+        if (found) {
+            value = *found;
+        }
+        return found != 0;
+    }
+
+    void insertOrAssign(const char *key, std::size_t value) {
+        std::lock_guard<std::mutex> lock(mLock);
+        mTrie.insertOrAssign(key, value);
+    }
+
+private:
+    rtv::Trie<char, std::size_t> mTrie;
+    std::mutex mLock;
+};
+
+class ShardedTrie
+{
+public:
+    explicit ShardedTrie(std::size_t shards)
+            : mTrie('\0', shards) {}
+
+    bool get(const char *key, std::size_t &value) {
+        return mTrie.get(key, value);
+    }
+
+    void insertOrAssign(const char *key, std::size_t value) {
+        mTrie.insertOrAssign(key, value);
+    }
+
+private:
+    rtv::ShardedTrie<char, std::size_t> mTrie;
+};
+
+// each thread inserts every threads'th key
+template <typename TrieType>
+double write(const std::vector<std::string> &keys, unsigned int threads, std::size_t shards) {
+    TrieType trie(shards);
+    std::vector<std::thread> workers;
+    double start = bench::now();
+    for (unsigned int t = 0; t < threads; ++t) {
+        workers.push_back(std::thread([&, t]() {
+            for (std::size_t i = t; i < keys.size(); i += threads) {
+                trie.insertOrAssign(keys[i].c_str(), i);
+            }
+        }));
+    }
+    for (unsigned int t = 0; t < threads; ++t) {
+        workers[t].join();
+    }
+    return bench::now() - start;
+}
+
+// each thread does operations/threads operations, a write for every 9 lookups
+template <typename TrieType>
+double mixed(const std::vector<std::string> &keys, unsigned int threads, std::size_t shards,
+             std::size_t operations) {
+    TrieType trie(shards);
+    for (std::size_t i = 0; i < keys.size(); i += 2) {
+        trie.insertOrAssign(keys[i].c_str(), i);
+    }
+
+    std::vector<std::thread> workers;
+    double start = bench::now();
+    for (unsigned int t = 0; t < threads; ++t) {
+        workers.push_back(std::thread([&, t]() {
+            bench::Random random(t + 1);
+            std::size_t found = 0;
+            for (std::size_t i = 0; i < operations / threads; ++i) {
+                std::size_t k = random.next() % keys.size();
+                if (i % 10 == 9) {
+                    trie.insertOrAssign(keys[k].c_str(), k);
+                } else {
+                    std::size_t value;
+                    found += trie.get(keys[k].c_str(), value);
+                }
+            }
+            if (found == 0) {
+                std::printf("nothing found\n");
+            }
+        }));
+    }
+    for (unsigned int t = 0; t < threads; ++t) {
+        workers[t].join();
+    }
+    return bench::now() - start;
+}
+
+int main(int argc, char **argv) {
+    std::size_t keyCount = bench::argument(argc, argv, 1, 300000);
+    unsigned int maxThreads = (unsigned int)bench::argument(argc, argv, 2,
+                                                            std::max(std::thread::hardware_concurrency(), 1u));
+    std::size_t shards = bench::argument(argc, argv, 3, 16);
+    const std::size_t operations = 1000000;
+
+    std::vector<std::string> keys = bench::randomKeys(keyCount, 8, 24);
+
+    std::printf("%lu keys, %lu shards, %lu mixed operations\n", (unsigned long)keyCount, (unsigned long)shards,
+                (unsigned long)operations);
+    std::printf("%8s %14s %14s %9s %14s %14s %9s\n", "threads", "insert mutex", "sharded", "speedup",
+                "mixed mutex", "sharded", "speedup");
+    for (unsigned int threads = 1; threads <= maxThreads; threads *= 2) {
+        double lockedWrite = write<LockedTrie>(keys, threads, shards);
+        double shardedWrite = write<ShardedTrie>(keys, threads, shards);
+        double lockedMixed = mixed<LockedTrie>(keys, threads, shards, operations);
+        double shardedMixed = mixed<ShardedTrie>(keys, threads, shards, operations);
+        double w = keys.size() / 1e6;
+        double m = operations / 1e6;
+        std::printf("%8u %14.2f %14.2f %8.2fx %14.2f %14.2f %8.2fx\n", threads,
+                    w / lockedWrite, w / shardedWrite, lockedWrite / shardedWrite,
+                    m / lockedMixed, m / shardedMixed, lockedMixed / shardedMixed);
+    }
+
+    return 0;
+}
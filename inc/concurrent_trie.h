@@ -0,0 +1,812 @@
+/*
+ * Copyright (c) 2012, Ranjith TV
+ * All rights reserved.
+ *
+ * Licensed under the BSD 3-Clause ("BSD New" or "BSD Simplified") license.
+ * You may obtain a copy of the License at
+ *
+ * http://www.opensource.org/licenses/BSD-3-Clause
+ *
+ */
+
+#ifndef CONCURRENT_TRIE_H
+#define CONCURRENT_TRIE_H
+
+#include "trie.h"
+
+#ifdef RTV_HAS_CXX11
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <functional>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <cstddef>
+
+namespace rtv
+{
+
+/*!
+ * @brief Trie which can be read and modified by many threads at the same time.
+ *
+ * The lookups ConcurrentTrie::get, ConcurrentTrie::hasKey, ConcurrentTrie::find and
+ * ConcurrentTrie::startsWith never take a lock. Each node has a version lock (optimistic lock coupling):
+ * the lookups check that the versions of the nodes they passed did not change instead of locking them,
+ * and the modifications lock only the nodes they change, so writers of different subtrees do not wait for
+ * each other. An operation which finds that a node changed under it starts again from the root.
+ * A writer never changes the children of a node which are visible to the readers, it builds
+ * a new array of children and publishes it with a single atomic store.
+ * The arrays, nodes and values which are replaced or removed are retired and freed only when no
+ * reader which could still see them is active (epoch based reclamation).
+ *
+ * Each reader and writer holds one of ReaderSlots slots while it is in the Trie, a thread waits when all
+ * the slots are held.
+ * Requires C++11.
+ * @tparam T Type for each element in the key
+ * @tparam V Type of the value that the key will be representing, it should be copy constructible
+ * @tparam Cmp Comparison functor
+ */
+template < typename T,
+typename V,
+typename Cmp = std::less<T> > class ConcurrentTrie
+{
+private:
+    struct Node;
+
+    // Children of a node sorted by symbol, never changed once published
+    typedef std::vector< std::pair<T, Node *> > Children;
+
+    // The version is incremented by Locked when the node is locked and again when it is unlocked,
+    // a node unlinked from the Trie is left with the Obsolete bit set
+    struct Node {
+        Node()
+                : mChildren(0),
+                mValue(0),
+                mVersion(0) {}
+
+        std::atomic<Children *> mChildren;
+        std::atomic<V *> mValue;
+        std::atomic<unsigned long> mVersion;
+    };
+
+    // Object which is freed when the readers of the epoch it was retired in are done
+    struct Retired {
+        unsigned long mEpoch;
+        void *mObject;
+        void (*mDelete)(void *);
+    };
+
+    enum {
+        ReaderSlots = 128,
+        CacheLine = 64,
+        ReclaimBatch = 64
+    };
+
+    enum {
+        Obsolete = 1,
+        Locked = 2
+    };
+
+    // Epoch announced by a reader, 0 when the slot is free
+    struct Slot {
+        Slot()
+                : mEpoch(0) {}
+
+        std::atomic<unsigned long> mEpoch;
+        char mPadding[CacheLine - sizeof(std::atomic<unsigned long>)];
+    };
+
+    // Room made in the retired objects before a node is locked, so that retiring an object does not throw
+    // while the node is locked. The room which is not used is given back when it goes out of scope
+    class RetireRoom
+    {
+    public:
+        RetireRoom(ConcurrentTrie &trie, std::size_t count)
+                : mTrie(trie),
+                mCount(count) {
+            trie.reserveRetired(count);
+        }
+
+        ~RetireRoom() {
+            mTrie.releaseRetired(mCount);
+        }
+
+        void retire(void *object, void (*deleter)(void *)) {
+            --mCount;
+            mTrie.retire(object, deleter);
+        }
+
+    private:
+        RetireRoom(RetireRoom const &);
+        RetireRoom &operator=(RetireRoom const &);
+
+    private:
+        ConcurrentTrie &mTrie;
+        std::size_t mCount;
+    };
+
+public:
+    static const std::size_t npos = static_cast<std::size_t>(-1);
+
+    /*!
+     * @brief Keeps the values found by ConcurrentTrie::find alive.
+     *
+     * The thread is a reader of the Trie as long as the guard lives, so it should be short lived.
+     */
+    class ReadGuard
+    {
+    public:
+        /*!
+         * @param trie The Trie to be read
+         */
+        explicit ReadGuard(ConcurrentTrie const &trie)
+                : mTrie(trie),
+                mSlot(trie.enter()) {}
+
+        ~ReadGuard() {
+            mTrie.leave(mSlot);
+        }
+
+    private:
+        ReadGuard(ReadGuard const &);
+        ReadGuard &operator=(ReadGuard const &);
+
+    private:
+        ConcurrentTrie const &mTrie;
+        unsigned int mSlot;
+    };
+
+public:
+    /*!
+     * @param endSymbol The symbol which marks the end of key input
+     */
+    explicit ConcurrentTrie(const T &endSymbol)
+            : mEndSymbol(endSymbol),
+            mSize(0),
+            mEpoch(1),
+            mReserved(0),
+            mReclaimAt(0) {}
+
+    /*!
+     * No thread should be using the Trie when it is destroyed
+     */
+    ~ConcurrentTrie() {
+        deleteTree(mRoot.mChildren.load());
+        delete mRoot.mValue.load();
+        for (std::size_t i = 0; i < mRetired.size(); ++i) {
+            mRetired[i].mDelete(mRetired[i].mObject);
+        }
+    }
+
+    /*!
+     * Add a key with value in to the Trie, the value of a key already present is not changed
+     * @param key Key which should be inserted, should be terminated by 'end' symbol
+     * @param value The value that is to be set with the key
+     * @return true if the key is newly inserted, false otherwise
+     */
+    bool insert(const T *key, V const &value) {
+        return insert(key, npos, value, false);
+    }
+
+    /*!
+     * Add a key with value in to the Trie, the value of a key already present is not changed
+     * @param key Key which should be inserted, need not be terminated
+     * @param length Number of symbols in the key
+     * @param value The value that is to be set with the key
+     * @return true if the key is newly inserted, false otherwise
+     */
+    bool insert(const T *key, std::size_t length, V const &value) {
+        return insert(key, length, value, false);
+    }
+
+    /*!
+     * Add a key with value in to the Trie, the value of a key already present is replaced.
+     * Readers see either the old or the new value
+     * @param key Key which should be inserted, should be terminated by 'end' symbol
+     * @param value The value that is to be set with the key
+     * @return true if the key is newly inserted, false if the value was replaced
+     */
+    bool insertOrAssign(const T *key, V const &value) {
+        return insert(key, npos, value, true);
+    }
+
+    /*!
+     * Add a key with value in to the Trie, the value of a key already present is replaced
+     * @param key Key which should be inserted, need not be terminated
+     * @param length Number of symbols in the key
+     * @param value The value that is to be set with the key
+     * @return true if the key is newly inserted, false if the value was replaced
+     */
+    bool insertOrAssign(const T *key, std::size_t length, V const &value) {
+        return insert(key, length, value, true);
+    }
+
+    /*!
+     * Remove the entry with the given key from the Trie
+     * @param key Key which should be erased, should be terminated by 'end' symbol
+     * @return true if the given key is erased from the Trie, false otherwise
+     */
+    bool erase(const T *key) {
+        return erase(key, npos);
+    }
+
+    /*!
+     * Remove the entry with the given key from the Trie
+     * @param key Key which should be erased, need not be terminated
+     * @param length Number of symbols in the key
+     * @return true if the given key is erased from the Trie, false otherwise
+     */
+    bool erase(const T *key, std::size_t length) {
+        length = measure(key, length);
+        bool erased = false;
+        {
+            ReadGuard guard(*this);
+            // the value, the children of the parent and a node and its children for each symbol
+            RetireRoom room(*this, 2 * length + 2);
+            while (!tryErase(key, length, erased, room)) {
+            }
+        }
+        reclaim();
+        return erased;
+    }
+
+    /*!
+     * Copies the value of a key, without taking a lock
+     * @param key Key to be searched for, should be terminated by 'end' symbol
+     * @param value Set to the value of the key when it is found
+     * @return true if the key is found, false otherwise
+     */
+    bool get(const T *key, V &value) const {
+        return get(key, npos, value);
+    }
+
+    /*!
+     * Copies the value of a key, without taking a lock
+     * @param key Key to be searched for, need not be terminated
+     * @param length Number of symbols in the key
+     * @param value Set to the value of the key when it is found
+     * @return true if the key is found, false otherwise
+     */
+    bool get(const T *key, std::size_t length, V &value) const {
+        ReadGuard guard(*this);
+        const V *found = lookup(key, length);
+        if (found) {
+            value = *found;
+        }
+        return found != 0;
+    }
+
+    /*!
+     * Checks whether the given key is present in the Trie, without taking a lock
+     * @param key Key to be searched for, should be terminated by 'end' symbol
+     * @return true if the key is present
+     */
+    bool hasKey(const T *key) const {
+        return hasKey(key, npos);
+    }
+
+    /*!
+     * Checks whether the given key is present in the Trie, without taking a lock
+     * @param key Key to be searched for, need not be terminated
+     * @param length Number of symbols in the key
+     * @return true if the key is present
+     */
+    bool hasKey(const T *key, std::size_t length) const {
+        ReadGuard guard(*this);
+        return lookup(key, length) != 0;
+    }
+
+    /*!
+     * Retrieves the value of a key without copying it, without taking a lock
+     * @param guard Guard of this Trie held by the calling thread, the value stays valid as long as it lives
+     *              even if the key is erased or assigned meanwhile
+     * @param key Key to be searched for, should be terminated by 'end' symbol
+     * @return Pointer to the value of the key, 0 if the key is not present
+     */
+    const V *find(ReadGuard const &guard, const T *key) const {
+        return find(guard, key, npos);
+    }
+
+    /*!
+     * Retrieves the value of a key without copying it, without taking a lock
+     * @param guard Guard of this Trie held by the calling thread
+     * @param key Key to be searched for, need not be terminated
+     * @param length Number of symbols in the key
+     * @return Pointer to the value of the key, 0 if the key is not present
+     */
+    const V *find(ReadGuard const &guard, const T *key, std::size_t length) const {
+        (void)guard;
+        return lookup(key, length);
+    }
+
+    /*!
+     * Visits the elements whose key starts with the prefix in the order of Cmp, without taking a lock.
+     * The elements added or removed meanwhile may or may not be visited
+     * @param prefix Part of the key which should be searched, should be terminated by 'end' symbol
+     * @param callback Functor called as callback(const T *key, std::size_t length, V const &value)
+     *                 for each element, key is terminated by 'end' symbol and length does not count it.
+     *                 It should not modify the Trie
+     * @return The callback
+     */
+    template <typename Callback>
+    Callback startsWith(const T *prefix, Callback callback) const {
+        return startsWith(prefix, npos, callback);
+    }
+
+    /*!
+     * Visits the elements whose key starts with the prefix in the order of Cmp, without taking a lock
+     * @param prefix Part of the key which should be searched, need not be terminated
+     * @param length Number of symbols in the prefix
+     * @param callback Functor called as callback(const T *key, std::size_t length, V const &value)
+     * @return The callback
+     */
+    template <typename Callback>
+    Callback startsWith(const T *prefix, std::size_t length, Callback callback) const {
+        ReadGuard guard(*this);
+        length = measure(prefix, length);
+        const Node *node = &mRoot;
+        for (std::size_t i = 0; node && i < length; ++i) {
+            node = findChild(node->mChildren.load(), prefix[i]);
+        }
+        if (node) {
+            std::vector<T> key(prefix, prefix + length);
+            visit(node, key, callback);
+        }
+        return callback;
+    }
+
+    /*!
+     * Remove all the elements from the Trie
+     */
+    void clear() {
+        {
+            ReadGuard guard(*this);
+            RetireRoom room(*this, 2);
+            // every node is locked, so the writers which are in the middle of a change finish it first
+            std::vector<Node *> nodes;
+            lockTree(&mRoot, nodes);
+            Children *children = mRoot.mChildren.load();
+            V *value = mRoot.mValue.load();
+            mRoot.mChildren.store(0);
+            mRoot.mValue.store(0);
+            mSize.store(0);
+            for (std::size_t i = 1; i < nodes.size(); ++i) {
+                unlockObsolete(nodes[i]);
+            }
+            unlock(&mRoot);
+            room.retire(children, &deleteTree);
+            room.retire(value, &deleteValue);
+        }
+        reclaim();
+    }
+
+    /*!
+     * @return Number of elements in the Trie
+     */
+    std::size_t size() const {
+        return mSize.load();
+    }
+
+    /*!
+     * @return true if the Trie has no element
+     */
+    bool empty() const {
+        return size() == 0;
+    }
+
+    T endSymbol() const {
+        return mEndSymbol;
+    }
+
+private:
+    ConcurrentTrie(ConcurrentTrie const &);
+    ConcurrentTrie &operator=(ConcurrentTrie const &);
+
+    static bool equals(T const &v1, T const &v2) {
+        return !Cmp()(v1, v2) && !Cmp()(v2, v1);
+    }
+
+    static bool symbolLess(std::pair<T, Node *> const &child, T const &k) {
+        return Cmp()(child.first, k);
+    }
+
+    // Index of the first child not ordered before k
+    static std::size_t position(Children const &children, T const &k) {
+        return std::lower_bound(children.begin(), children.end(), k, &symbolLess) - children.begin();
+    }
+
+    static Node *findChild(const Children *children, T const &k) {
+        if (!children) {
+            return 0;
+        }
+        std::size_t pos = position(*children, k);
+        if (pos < children->size() && equals((*children)[pos].first, k)) {
+            return (*children)[pos].second;
+        }
+        return 0;
+    }
+
+    std::size_t measure(const T *key, std::size_t length) const {
+        if (length == npos) {
+            for (length = 0; key[length] != mEndSymbol; ++length) {
+            }
+        }
+        return length;
+    }
+
+    // Waits while the node is locked, false if the node is obsolete
+    static bool readLock(const Node *node, unsigned long &version) {
+        version = node->mVersion.load();
+        while (version & Locked) {
+            std::this_thread::yield();
+            version = node->mVersion.load();
+        }
+        return !(version & Obsolete);
+    }
+
+    // Whether the node is not changed since its version was read
+    static bool validate(const Node *node, unsigned long version) {
+        return node->mVersion.load() == version;
+    }
+
+    // Locks the node if it is not changed since its version was read
+    static bool upgrade(Node *node, unsigned long version) {
+        return node->mVersion.compare_exchange_strong(version, version + Locked);
+    }
+
+    static void lock(Node *node) {
+        unsigned long version;
+        while (!readLock(node, version) || !upgrade(node, version)) {
+        }
+    }
+
+    static void unlock(Node *node) {
+        node->mVersion.fetch_add(Locked);
+    }
+
+    static void unlockObsolete(Node *node) {
+        node->mVersion.fetch_add(Locked + Obsolete);
+    }
+
+    // Locks the node and all the nodes below it, parents before children
+    static void lockTree(Node *node, std::vector<Node *> &nodes) {
+        lock(node);
+        nodes.push_back(node);
+        const Children *children = node->mChildren.load();
+        if (children) {
+            for (std::size_t i = 0; i < children->size(); ++i) {
+                lockTree((*children)[i].second, nodes);
+            }
+        }
+    }
+
+    const V *lookup(const T *key, std::size_t length) const {
+        length = measure(key, length);
+        const V *found = 0;
+        while (!tryLookup(key, length, found)) {
+        }
+        return found;
+    }
+
+    // Each node is validated after the version of its child is read, false if the lookup should restart
+    bool tryLookup(const T *key, std::size_t length, const V *&found) const {
+        const Node *node = &mRoot;
+        unsigned long version;
+        readLock(node, version);
+        for (std::size_t i = 0; i < length; ++i) {
+            const Node *child = findChild(node->mChildren.load(), key[i]);
+            if (!child) {
+                found = 0;
+                return validate(node, version);
+            }
+            unsigned long childVersion;
+            if (!readLock(child, childVersion) || !validate(node, version)) {
+                return false;
+            }
+            node = child;
+            version = childVersion;
+        }
+        found = node->mValue.load();
+        return validate(node, version);
+    }
+
+    template <typename Callback>
+    void visit(const Node *node, std::vector<T> &key, Callback &callback) const {
+        const V *value = node->mValue.load();
+        if (value) {
+            key.push_back(mEndSymbol);
+            callback(&key[0], key.size() - 1, *value);
+            key.pop_back();
+        }
+        const Children *children = node->mChildren.load();
+        if (children) {
+            for (std::size_t i = 0; i < children->size(); ++i) {
+                key.push_back((*children)[i].first);
+                visit((*children)[i].second, key, callback);
+                key.pop_back();
+            }
+        }
+    }
+
+    bool insert(const T *key, std::size_t length, V const &value, bool assign) {
+        length = measure(key, length);
+        bool inserted = false;
+        {
+            ReadGuard guard(*this);
+            RetireRoom room(*this, 1);
+            while (!tryInsert(key, length, value, assign, inserted, room)) {
+            }
+        }
+        reclaim();
+        return inserted;
+    }
+
+    // Locks only the node which gets the value or the new children, false if the insert should restart.
+    // Everything which can throw is made before the node is locked, a node left locked would stop the readers
+    bool tryInsert(const T *key, std::size_t length, V const &value, bool assign, bool &inserted, RetireRoom &room) {
+        Node *node = &mRoot;
+        unsigned long version;
+        readLock(node, version);
+        std::size_t i = 0;
+        for (; i < length; ++i) {
+            Node *child = findChild(node->mChildren.load(), key[i]);
+            if (!child) {
+                break;
+            }
+            unsigned long childVersion;
+            if (!readLock(child, childVersion) || !validate(node, version)) {
+                return false;
+            }
+            node = child;
+            version = childVersion;
+        }
+
+        V *current = i < length ? 0 : node->mValue.load();
+        if (current && !assign) {
+            inserted = false;
+            return validate(node, version);
+        }
+
+        if (i < length) {
+            // the children read before the lock are those replaced when the version is still the same
+            Children *children = node->mChildren.load();
+            std::unique_ptr<Children, void (*)(void *)> chain(makeChain(key, i, length, value), &deleteTree);
+            std::unique_ptr<Children> updated(children ? new Children(*children) : new Children());
+            updated->insert(updated->begin() + position(*updated, key[i]), chain->front());
+            if (!upgrade(node, version)) {
+                return false;
+            }
+            node->mChildren.store(updated.release());
+            // the first node now belongs to the published children, only the array holding it is left
+            delete static_cast<Children *>(chain.release());
+            room.retire(children, &deleteChildren);
+        } else {
+            std::unique_ptr<V> added(new V(value));
+            if (!upgrade(node, version)) {
+                return false;
+            }
+            node->mValue.store(added.release());
+            room.retire(current, &deleteValue);
+        }
+        if (!current) {
+            mSize.fetch_add(1);
+        }
+        unlock(node);
+        inserted = current == 0;
+        return true;
+    }
+
+    // The nodes of key[first..length) with the value at the last of them, under an array holding only
+    // the node of key[first]. Made from the last node up, those made when one throws are deleted
+    static Children *makeChain(const T *key, std::size_t first, std::size_t length, V const &value) {
+        std::unique_ptr<V> added(new V(value));
+        std::unique_ptr<Children, void (*)(void *)> below(0, &deleteTree);
+        for (std::size_t j = length; j-- > first;) {
+            std::unique_ptr<Node> node(new Node());
+            std::unique_ptr<Children> array(new Children(1, std::make_pair(key[j], (Node *)0)));
+            node->mValue.store(added.release());
+            node->mChildren.store(below.release());
+            array->front().second = node.release();
+            below.reset(array.release());
+        }
+        return below.release();
+    }
+
+    // Locks the node of the key, and its parent and the nodes between them when they are unlinked,
+    // false if the erase should restart
+    bool tryErase(const T *key, std::size_t length, bool &erased, RetireRoom &room) {
+        std::vector<Node *> path(1, &mRoot);
+        std::vector<unsigned long> versions(1);
+        readLock(&mRoot, versions[0]);
+        for (std::size_t i = 0; i < length; ++i) {
+            Node *child = findChild(path.back()->mChildren.load(), key[i]);
+            if (!child) {
+                erased = false;
+                return validate(path.back(), versions.back());
+            }
+            unsigned long childVersion;
+            if (!readLock(child, childVersion) || !validate(path.back(), versions.back())) {
+                return false;
+            }
+            path.push_back(child);
+            versions.push_back(childVersion);
+        }
+        V *value = path.back()->mValue.load();
+        if (!value) {
+            erased = false;
+            return validate(path.back(), versions.back());
+        }
+
+        // nodes from path[top] which are left without a value and children are unlinked from path[top - 1]
+        std::size_t top = length + 1;
+        if (length > 0 && !path.back()->mChildren.load()) {
+            top = length;
+            while (top > 1 && !path[top - 1]->mValue.load()) {
+                const Children *children = path[top - 1]->mChildren.load();
+                if (!children || children->size() != 1) {
+                    break;
+                }
+                --top;
+            }
+        }
+
+        // the children left to path[top - 1] are made before it is locked, as in tryInsert
+        Children *children = top <= length ? path[top - 1]->mChildren.load() : 0;
+        std::unique_ptr<Children> remaining;
+        if (children && children->size() > 1) {
+            remaining.reset(new Children(*children));
+            remaining->erase(remaining->begin() + position(*remaining, key[top - 1]));
+        }
+        std::size_t first = std::min(top - 1, length);
+        for (std::size_t i = first; i <= length; ++i) {
+            if (!upgrade(path[i], versions[i])) {
+                while (i-- > first) {
+                    unlock(path[i]);
+                }
+                return false;
+            }
+        }
+
+        path.back()->mValue.store(0);
+        room.retire(value, &deleteValue);
+        mSize.fetch_sub(1);
+        if (top <= length) {
+            path[top - 1]->mChildren.store(remaining.release());
+            room.retire(children, &deleteChildren);
+            for (std::size_t i = top; i <= length; ++i) {
+                room.retire(path[i]->mChildren.load(), &deleteChildren);
+                room.retire(path[i], &deleteNode);
+                unlockObsolete(path[i]);
+            }
+            unlock(path[top - 1]);
+        } else {
+            unlock(path.back());
+        }
+        erased = true;
+        return true;
+    }
+
+    // Announces the current epoch in a free slot, the threads start looking from the slot they used last
+    unsigned int enter() const {
+        static thread_local unsigned int hint =
+            static_cast<unsigned int>(std::hash<std::thread::id>()(std::this_thread::get_id()) % ReaderSlots);
+        unsigned int slot = hint;
+        for (unsigned int tried = 0;; ++tried) {
+            unsigned long free = 0;
+            if (mSlots[slot].mEpoch.compare_exchange_strong(free, mEpoch.load())) {
+                hint = slot;
+                return slot;
+            }
+            slot = (slot + 1) % ReaderSlots;
+            if (tried && tried % ReaderSlots == 0) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void leave(unsigned int slot) const {
+        mSlots[slot].mEpoch.store(0);
+    }
+
+    // Makes room for count more retired objects than those already made room for
+    void reserveRetired(std::size_t count) {
+        std::lock_guard<std::mutex> lock(mRetireLock);
+        std::size_t needed = mRetired.size() + mReserved + count;
+        if (needed > mRetired.capacity()) {
+            mRetired.reserve(std::max(needed, 2 * mRetired.capacity()));
+        }
+        mReserved += count;
+    }
+
+    void releaseRetired(std::size_t count) {
+        std::lock_guard<std::mutex> lock(mRetireLock);
+        mReserved -= count;
+    }
+
+    // Takes the room made by reserveRetired, so the object is kept without allocating
+    void retire(void *object, void (*deleter)(void *)) {
+        Retired retired = { mEpoch.load(), object, deleter };
+        std::lock_guard<std::mutex> lock(mRetireLock);
+        --mReserved;
+        if (object) {
+            mRetired.push_back(retired);
+        }
+    }
+
+    // Frees the objects retired before the oldest epoch announced by a reader,
+    // left to the next writer when another writer is reclaiming.
+    // The objects which are kept are not looked at again until as many more are retired
+    void reclaim() {
+        std::unique_lock<std::mutex> lock(mRetireLock, std::try_to_lock);
+        if (!lock.owns_lock() || mRetired.size() < mReclaimAt) {
+            return;
+        }
+        unsigned long oldest = mEpoch.fetch_add(1) + 1;
+        for (unsigned int i = 0; i < ReaderSlots; ++i) {
+            unsigned long epoch = mSlots[i].mEpoch.load();
+            if (epoch && epoch < oldest) {
+                oldest = epoch;
+            }
+        }
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < mRetired.size(); ++i) {
+            if (mRetired[i].mEpoch < oldest) {
+                mRetired[i].mDelete(mRetired[i].mObject);
+            } else {
+                mRetired[kept++] = mRetired[i];
+            }
+        }
+        mRetired.resize(kept);
+        mReclaimAt = 2 * kept + ReclaimBatch;
+    }
+
+    static void deleteValue(void *object) {
+        delete static_cast<V *>(object);
+    }
+
+    static void deleteChildren(void *object) {
+        delete static_cast<Children *>(object);
+    }
+
+    // Only the node, its value and children are retired separately
+    static void deleteNode(void *object) {
+        delete static_cast<Node *>(object);
+    }
+
+    // The children and every node below them
+    static void deleteTree(void *object) {
+        Children *children = static_cast<Children *>(object);
+        if (children) {
+            for (std::size_t i = 0; i < children->size(); ++i) {
+                Node *node = (*children)[i].second;
+                deleteTree(node->mChildren.load());
+                delete node->mValue.load();
+                delete node;
+            }
+            delete children;
+        }
+    }
+
+private:
+    T mEndSymbol;
+    Node mRoot;
+    std::atomic<std::size_t> mSize;
+    std::atomic<unsigned long> mEpoch;
+    mutable Slot mSlots[ReaderSlots];
+    std::mutex mRetireLock;
+    std::vector<Retired> mRetired;
+    std::size_t mReserved;
+    std::size_t mReclaimAt;
+};
+
+template < typename T,
+typename V,
+typename Cmp > const std::size_t ConcurrentTrie<T, V, Cmp>::npos;
+
+}
+
+#endif
+
+#endif
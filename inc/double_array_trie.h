@@ -0,0 +1,425 @@
+/*
+ * Copyright (c) 2012, Ranjith TV
+ * All rights reserved.
+ *
+ * Licensed under the BSD 3-Clause ("BSD New" or "BSD Simplified") license.
+ * You may obtain a copy of the License at
+ *
+ * http://www.opensource.org/licenses/BSD-3-Clause
+ *
+ */
+
+#ifndef DOUBLE_ARRAY_TRIE_H
+#define DOUBLE_ARRAY_TRIE_H
+
+#include "trie.h"
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <cstddef>
+
+namespace rtv
+{
+
+// Type of the symbol codes of a DoubleArrayTrie, Wide when the symbols take more than a byte
+template <bool Wide> struct DoubleArrayCode {
+    typedef unsigned int Type;
+};
+
+template <> struct DoubleArrayCode<false> {
+    typedef unsigned short Type;
+};
+
+/*!
+ * @brief Read only Trie stored in two integer arrays (double array), built from a Trie by rtv::freeze.
+ *
+ * Each symbol used by the keys gets a code, 1 for the first symbol in the order of Cmp and so on.
+ * A node is a position s in the arrays, the node reached from s with the symbol of code c is
+ * t = base[s] + c if check[t] is s, which makes each step of a lookup a few array reads.
+ * The value of the node s is at base[s] when check[base[s]] is s.
+ * Each position also keeps the code of the first child of its node and the code of its next sibling,
+ * so the iteration visits only the codes in use. They take 2 bytes each for the symbols of one byte,
+ * 4 bytes each for wider symbols.
+ * Symbols of one byte are coded through a table, wider symbols by a binary search of the used symbols.
+ * The elements are iterated in the order of Cmp.
+ * @tparam T Type for each element in the key
+ * @tparam V Type of the value that the key will be representing
+ * @tparam Cmp Comparison functor
+ */
+template < typename T,
+typename V,
+typename Cmp = std::less<T> > class DoubleArrayTrie
+        : public ReadOnlyTrie<DoubleArrayTrie<T, V, Cmp>, T, V, int, unsigned int>
+{
+private:
+    friend class ReadOnlyTrie<DoubleArrayTrie<T, V, Cmp>, T, V, int, unsigned int>;
+
+public:
+    /*!
+     * Creates an empty DoubleArrayTrie
+     * @param endSymbol The symbol which marks the end of key input
+     */
+    explicit DoubleArrayTrie(const T &endSymbol)
+            : mEndSymbol(endSymbol),
+            mBase(1, 0),
+            mCheck(1, Root),
+            mLinks(1),
+            mLastFree(0),
+            mScanFrom(0) {}
+
+    /*!
+     * Builds the DoubleArrayTrie with the elements of a Trie, see rtv::freeze
+     * @param trie The Trie to be copied, it is not changed
+     */
+    template <typename Items>
+    explicit DoubleArrayTrie(Trie<T, V, Cmp, Items> const &trie)
+            : mEndSymbol(trie.endSymbol()),
+            mBase(1, 0),
+            mCheck(1, Root),
+            mLinks(1),
+            mLastFree(0),
+            mScanFrom(0) {
+        build(trie.begin(), trie.end());
+    }
+
+    /*!
+     * @return Number of elements
+     */
+    std::size_t size() const {
+        return mValues.size();
+    }
+
+    /*!
+     * @return true if there is no element
+     */
+    bool empty() const {
+        return mValues.empty();
+    }
+
+    T endSymbol() const {
+        return mEndSymbol;
+    }
+
+    /*!
+     * @return Number of bytes used by the arrays, the values and the symbol codes
+     */
+    std::size_t memoryUsage() const {
+        return sizeof(*this) + (mBase.capacity() + mCheck.capacity()) * sizeof(int) +
+               mLinks.capacity() * sizeof(Links) +
+               mValues.capacity() * sizeof(V) + mAlphabet.capacity() * sizeof(T) +
+               mByteCodes.capacity() * sizeof(unsigned int);
+    }
+
+    /*!
+     * @return Number of positions in the arrays, used or not
+     */
+    std::size_t arraySize() const {
+        return mBase.size();
+    }
+
+private:
+    enum {
+        Free = -1,
+        Root = -2,
+        ScanLimit = 64
+    };
+
+    // Node of the tree built from the elements before it is placed in the arrays
+    struct Pending {
+        Pending()
+                : mValue(0) {}
+
+        std::vector< std::pair<unsigned int, unsigned int> > mChilds;
+        std::size_t mValue;
+    };
+
+    // The codes of up to 256 symbols fit in 2 bytes
+    typedef typename DoubleArrayCode<(sizeof(T) > 1)>::Type Code;
+
+    // Codes of the first child of the node at a position and of its next sibling, 0 if there is none
+    struct Links {
+        Links()
+                : mFirst(0),
+                mNext(0) {}
+
+        Code mFirst;
+        Code mNext;
+    };
+
+    class SymbolLess
+    {
+    public:
+        bool operator()(T const &v1, T const &v2) const {
+            return Cmp()(v1, v2);
+        }
+    };
+
+    // Code of the symbol, 0 when no key uses it
+    unsigned int code(T const &symbol) const {
+        if (!mByteCodes.empty()) {
+            return mByteCodes[static_cast<unsigned char>(symbol)];
+        }
+        typename std::vector<T>::const_iterator found =
+            std::lower_bound(mAlphabet.begin(), mAlphabet.end(), symbol, SymbolLess());
+        if (found == mAlphabet.end() || Cmp()(symbol, *found)) {
+            return 0;
+        }
+        return (unsigned int)(found - mAlphabet.begin()) + 1;
+    }
+
+    // Node reached from state with the symbol of code, -1 if there is none
+    int transition(int state, unsigned int code) const {
+        std::size_t t = (std::size_t)mBase[state] + code;
+        if (t < mCheck.size() && mCheck[t] == state) {
+            return (int)t;
+        }
+        return -1;
+    }
+
+    const V *valueOf(int state) const {
+        std::size_t t = (std::size_t)mBase[state];
+        if (t < mCheck.size() && mCheck[t] == state) {
+            return &mValues[mBase[t]];
+        }
+        return 0;
+    }
+
+    bool root(int &state) const {
+        state = 0;
+        return true;
+    }
+
+    bool child(int state, T const &symbol, int &next) const {
+        unsigned int c = code(symbol);
+        int t = c ? transition(state, c) : -1;
+        if (t < 0) {
+            return false;
+        }
+        next = t;
+        return true;
+    }
+
+    // The edges of a node are the codes of its children, 0 ends them
+    std::pair<unsigned int, unsigned int> edges(int state) const {
+        return std::make_pair((unsigned int)mLinks[state].mFirst, 0u);
+    }
+
+    unsigned int nextEdge(int state, unsigned int code) const {
+        return mLinks[mBase[state] + code].mNext;
+    }
+
+    int target(int state, unsigned int code) const {
+        return mBase[state] + (int)code;
+    }
+
+    T label(unsigned int code) const {
+        return mAlphabet[code - 1];
+    }
+
+    template <typename ConstIter>
+    void build(ConstIter first, ConstIter last) {
+        // the tree of the elements, the children are appended in the order of the iteration
+        std::vector<Pending> pending(1);
+        std::vector<unsigned int> path(1, 0);
+        std::vector<T> pathKey;
+        std::vector<T> symbols;
+        for (; first != last; ++first) {
+            const T *key = first->first;
+            std::size_t common = 0;
+            while (common < pathKey.size() && key[common] != mEndSymbol && key[common] == pathKey[common]) {
+                ++common;
+            }
+            path.resize(common + 1);
+            pathKey.resize(common);
+            for (; key[common] != mEndSymbol; ++common) {
+                pending[path.back()].mChilds.push_back(std::make_pair((unsigned int)symbols.size(),
+                                                                      (unsigned int)pending.size()));
+                symbols.push_back(key[common]);
+                path.push_back((unsigned int)pending.size());
+                pathKey.push_back(key[common]);
+                pending.push_back(Pending());
+            }
+            mValues.push_back(*first->second);
+            pending[path.back()].mValue = mValues.size();
+        }
+
+        mAlphabet = symbols;
+        std::sort(mAlphabet.begin(), mAlphabet.end(), SymbolLess());
+        std::size_t unique = 0;
+        for (std::size_t i = 0; i < mAlphabet.size(); ++i) {
+            if (!unique || Cmp()(mAlphabet[unique - 1], mAlphabet[i])) {
+                mAlphabet[unique++] = mAlphabet[i];
+            }
+        }
+        mAlphabet.resize(unique);
+        if (sizeof(T) == 1) {
+            std::vector<unsigned int> byteCodes(256);
+            for (unsigned int i = 0; i < 256; ++i) {
+                byteCodes[i] = code(static_cast<T>(i));
+            }
+            mByteCodes.swap(byteCodes);
+        }
+        for (std::size_t n = 0; n < pending.size(); ++n) {
+            for (std::size_t i = 0; i < pending[n].mChilds.size(); ++i) {
+                pending[n].mChilds[i].first = code(symbols[pending[n].mChilds[i].first]);
+            }
+            std::sort(pending[n].mChilds.begin(), pending[n].mChilds.end());
+        }
+        std::vector<T>().swap(symbols);
+
+        // the nodes are placed parents first, each at the first base where all its codes are free
+        mFree.assign(1, 0);
+        mPrev.assign(1, 0);
+        mLastFree = 0;
+        mScanFrom = 0;
+        std::vector< std::pair<unsigned int, int> > queue(1, std::make_pair(0u, 0));
+        std::vector<unsigned int> codes;
+        for (std::size_t q = 0; q < queue.size(); ++q) {
+            Pending &node = pending[queue[q].first];
+            int state = queue[q].second;
+            codes.clear();
+            if (node.mValue) {
+                codes.push_back(0);
+            }
+            for (std::size_t i = 0; i < node.mChilds.size(); ++i) {
+                codes.push_back(node.mChilds[i].first);
+            }
+            if (codes.empty()) {
+                continue;
+            }
+            int base = place(codes);
+            mBase[state] = base;
+            if (node.mValue) {
+                mBase[base] = (int)node.mValue - 1;
+            }
+            if (!node.mChilds.empty()) {
+                mLinks[state].mFirst = (Code)node.mChilds[0].first;
+            }
+            for (std::size_t i = 0; i < node.mChilds.size(); ++i) {
+                if (i + 1 < node.mChilds.size()) {
+                    mLinks[base + node.mChilds[i].first].mNext = (Code)node.mChilds[i + 1].first;
+                }
+                queue.push_back(std::make_pair(node.mChilds[i].second, base + (int)node.mChilds[i].first));
+            }
+            for (std::size_t i = 0; i < codes.size(); ++i) {
+                mCheck[base + codes[i]] = state;
+            }
+            std::vector< std::pair<unsigned int, unsigned int> >().swap(node.mChilds);
+        }
+
+        std::size_t used = mCheck.size();
+        while (used > 1 && mCheck[used - 1] == Free) {
+            --used;
+        }
+        std::vector<int>(mBase.begin(), mBase.begin() + used).swap(mBase);
+        std::vector<int>(mCheck.begin(), mCheck.begin() + used).swap(mCheck);
+        std::vector<Links>(mLinks.begin(), mLinks.begin() + used).swap(mLinks);
+        std::vector<int>().swap(mFree);
+        std::vector<int>().swap(mPrev);
+        std::vector<V>(mValues).swap(mValues);
+    }
+
+    // Finds the base for the codes, sorted in increasing order, and takes the positions out of the free list.
+    // mFree[p] and mPrev[p] are the free positions after and before the free position p, position 0 is
+    // the root which is never free, so mFree[0] is the first free position and 0 ends the list.
+    // The nodes of several codes search from mScanFrom, the free positions skipped by a long search
+    // are left to the nodes of a single code which fit in any of them
+    int place(std::vector<unsigned int> const &codes) {
+        bool several = codes.size() > 1;
+        std::size_t scanned = 0;
+        for (std::size_t p = several && mScanFrom ? mScanFrom : mFree[0];; p = mFree[p], ++scanned) {
+            if (p == 0 || p == mCheck.size()) {
+                p = mCheck.size();
+                grow(p + codes.back() + 1);
+            }
+            if (p <= codes[0]) {
+                continue;
+            }
+            std::size_t base = p - codes[0];
+            if (base + codes.back() >= mCheck.size()) {
+                grow(base + codes.back() + 1);
+            }
+            bool fits = true;
+            for (std::size_t i = 1; i < codes.size() && fits; ++i) {
+                fits = mCheck[base + codes[i]] == Free;
+            }
+            if (fits) {
+                if (several && scanned > ScanLimit) {
+                    mScanFrom = p;
+                }
+                for (std::size_t i = 0; i < codes.size(); ++i) {
+                    take(base + codes[i]);
+                }
+                return (int)base;
+            }
+        }
+    }
+
+    // Adds free positions up to size, linked after the last free position
+    void grow(std::size_t size) {
+        std::size_t old = mCheck.size();
+        if (size <= old) {
+            return;
+        }
+        size = std::max(size, old * 2);
+        mBase.resize(size, 0);
+        mCheck.resize(size, Free);
+        mLinks.resize(size);
+        mFree.resize(size, 0);
+        mPrev.resize(size, 0);
+        std::size_t last = mLastFree;
+        for (std::size_t p = old; p < size; ++p) {
+            mFree[last] = (int)p;
+            mPrev[p] = (int)last;
+            last = p;
+        }
+        mFree[last] = 0;
+        mLastFree = last;
+    }
+
+    void take(std::size_t p) {
+        mCheck[p] = Root;
+        std::size_t prev = mPrev[p];
+        std::size_t next = mFree[p];
+        mFree[prev] = (int)next;
+        if (next) {
+            mPrev[next] = (int)prev;
+        } else {
+            mLastFree = prev;
+        }
+        if (mScanFrom == p) {
+            mScanFrom = next;
+        }
+    }
+
+private:
+    T mEndSymbol;
+    std::vector<int> mBase;
+    std::vector<int> mCheck;
+    std::vector<Links> mLinks;
+    std::vector<V> mValues;
+    std::vector<T> mAlphabet;
+    std::vector<unsigned int> mByteCodes;
+    std::vector<int> mFree;
+    std::vector<int> mPrev;
+    std::size_t mLastFree;
+    std::size_t mScanFrom;
+};
+
+/*!
+ * Converts a finished Trie in to a DoubleArrayTrie, which is smaller and faster to look up but read only
+ * @param trie The Trie to be converted, it is not changed
+ * @return DoubleArrayTrie with the elements of the Trie
+ */
+template < typename T,
+typename V,
+typename Cmp,
+typename Items > DoubleArrayTrie<T, V, Cmp> freeze(Trie<T, V, Cmp, Items> const &trie)
+{
+    return DoubleArrayTrie<T, V, Cmp>(trie);
+}
+
+}
+
+#endif
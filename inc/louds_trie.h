@@ -0,0 +1,425 @@
+/*
+ * Copyright (c) 2012, Ranjith TV
+ * All rights reserved.
+ *
+ * Licensed under the BSD 3-Clause ("BSD New" or "BSD Simplified") license.
+ * You may obtain a copy of the License at
+ *
+ * http://www.opensource.org/licenses/BSD-3-Clause
+ *
+ */
+
+#ifndef LOUDS_TRIE_H
+#define LOUDS_TRIE_H
+
+#include "trie.h"
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <cstddef>
+
+namespace rtv
+{
+
+/*!
+ * @brief Bits which count the ones before a position (rank) and find the position of a zero (select).
+ *
+ * The bits are appended by pushBack and are read only after seal, which builds the directories:
+ * a count of ones for every 512 bits and the block of every 8192nd zero, about 4% over the bits.
+ */
+class BitVector
+{
+public:
+    BitVector()
+            : mSize(0),
+            mZeros(0) {}
+
+    /*!
+     * Appends a bit, only before seal
+     */
+    void pushBack(bool bit) {
+        if (mSize % WordBits == 0) {
+            mWords.push_back(0);
+        }
+        if (bit) {
+            mWords.back() |= 1u << (mSize % WordBits);
+        }
+        ++mSize;
+    }
+
+    /*!
+     * Sets the last bit to one, only before seal
+     */
+    void setBack() {
+        mWords.back() |= 1u << ((mSize - 1) % WordBits);
+    }
+
+    /*!
+     * Appends the bits of another BitVector, only before seal
+     */
+    void append(BitVector const &oth) {
+        for (std::size_t i = 0; i < oth.size(); ++i) {
+            pushBack(oth[i]);
+        }
+    }
+
+    /*!
+     * Releases the spare memory and builds the rank and select directories
+     */
+    void seal() {
+        std::vector<unsigned int>(mWords).swap(mWords);
+        std::vector<std::size_t> supers;
+        std::vector<unsigned short> blocks;
+        std::size_t ones = 0;
+        std::size_t superOnes = 0;
+        for (std::size_t w = 0; w < mWords.size(); ++w) {
+            if (w % (SuperBits / WordBits) == 0) {
+                supers.push_back(ones);
+                superOnes = ones;
+            }
+            if (w % BlockWords == 0) {
+                blocks.push_back((unsigned short)(ones - superOnes));
+            }
+            ones += Bits::popCount(mWords[w]);
+        }
+        mSupers.swap(supers);
+        mBlocks.swap(blocks);
+        mZeros = mSize - ones;
+
+        std::vector<std::size_t> selects;
+        std::size_t block = 0;
+        for (std::size_t zero = 0; zero < mZeros; zero += SelectStep) {
+            while (block + 1 < mBlocks.size() && zerosBefore(block + 1) <= zero) {
+                ++block;
+            }
+            selects.push_back(block);
+        }
+        mSelects.swap(selects);
+    }
+
+    void swap(BitVector &oth) {
+        mWords.swap(oth.mWords);
+        mSupers.swap(oth.mSupers);
+        mBlocks.swap(oth.mBlocks);
+        mSelects.swap(oth.mSelects);
+        std::swap(mSize, oth.mSize);
+        std::swap(mZeros, oth.mZeros);
+    }
+
+    bool operator[](std::size_t pos) const {
+        return (mWords[pos / WordBits] >> (pos % WordBits)) & 1u;
+    }
+
+    /*!
+     * @return Number of bits
+     */
+    std::size_t size() const {
+        return mSize;
+    }
+
+    /*!
+     * @param pos Position less than size()
+     * @return Number of ones before the position
+     */
+    std::size_t rank1(std::size_t pos) const {
+        std::size_t word = pos / WordBits;
+        std::size_t block = word / BlockWords;
+        std::size_t ones = mSupers[block / (SuperBits / BlockBits)] + mBlocks[block];
+        for (std::size_t w = block * BlockWords; w < word; ++w) {
+            ones += Bits::popCount(mWords[w]);
+        }
+        unsigned int bit = (unsigned int)(pos % WordBits);
+        if (bit) {
+            ones += Bits::popCount(mWords[word] & ((1u << bit) - 1));
+        }
+        return ones;
+    }
+
+    /*!
+     * @param index Number of the zero, counting from 0, less than the number of zeros
+     * @return Position of the zero
+     */
+    std::size_t select0(std::size_t index) const {
+        std::size_t sample = index / SelectStep;
+        std::size_t low = mSelects[sample];
+        std::size_t high = sample + 1 < mSelects.size() ? mSelects[sample + 1] + 1 : mBlocks.size();
+        while (high - low > 1) {
+            std::size_t middle = low + (high - low) / 2;
+            if (zerosBefore(middle) <= index) {
+                low = middle;
+            } else {
+                high = middle;
+            }
+        }
+        index -= zerosBefore(low);
+        for (std::size_t w = low * BlockWords;; ++w) {
+            unsigned int zeros = WordBits - Bits::popCount(mWords[w]);
+            if (index < zeros) {
+                return w * WordBits + selectZero(mWords[w], (unsigned int)index);
+            }
+            index -= zeros;
+        }
+    }
+
+    /*!
+     * @param pos Position at or before a zero
+     * @return Position of the first zero at or after pos
+     */
+    std::size_t nextZero(std::size_t pos) const {
+        std::size_t word = pos / WordBits;
+        unsigned int zeros = ~mWords[word] >> (pos % WordBits);
+        if (zeros) {
+            return pos + Bits::lowestBit(zeros);
+        }
+        for (++word; !~mWords[word]; ++word) {
+        }
+        return word * WordBits + Bits::lowestBit(~mWords[word]);
+    }
+
+    /*!
+     * @return Number of bytes used by the bits and the directories
+     */
+    std::size_t memoryUsage() const {
+        return mWords.capacity() * sizeof(unsigned int) + mBlocks.capacity() * sizeof(unsigned short) +
+               (mSupers.capacity() + mSelects.capacity()) * sizeof(std::size_t);
+    }
+
+private:
+    // the words are expected to be of 32 bits
+    enum {
+        WordBits = 32,
+        BlockWords = 16,
+        BlockBits = WordBits * BlockWords,
+        SuperBits = 65536,
+        SelectStep = 8192
+    };
+
+    // Position of the zero numbered index in the word, the word has more zeros than index
+    static unsigned int selectZero(unsigned int word, unsigned int index) {
+        unsigned int pos = 0;
+        word = ~word;
+        for (unsigned int ones = Bits::popCount(word & 0xffu); ones <= index;
+             ones = Bits::popCount(word & 0xffu)) {
+            index -= ones;
+            word >>= 8;
+            pos += 8;
+        }
+        for (;; word >>= 1, ++pos) {
+            if (word & 1u) {
+                if (!index) {
+                    return pos;
+                }
+                --index;
+            }
+        }
+    }
+
+    std::size_t zerosBefore(std::size_t block) const {
+        return block * BlockBits - mSupers[block / (SuperBits / BlockBits)] - mBlocks[block];
+    }
+
+private:
+    std::vector<unsigned int> mWords;
+    std::vector<std::size_t> mSupers;
+    std::vector<unsigned short> mBlocks;
+    std::vector<std::size_t> mSelects;
+    std::size_t mSize;
+    std::size_t mZeros;
+};
+
+/*!
+ * @brief Read only succinct Trie, the shape is stored in about 2 bits for each node.
+ *
+ * The nodes are numbered level by level in the order of Cmp, the root is 0. The shape is a
+ * level order unary degree sequence (LOUDS): for each node, a one for each child followed by a zero.
+ * The children of node n are between the zeros numbered n - 1 and n, and the child at position p
+ * is the node p - n + 1, so moving down takes one select. The symbol leading to node m is label m - 1
+ * and the children of a node are searched by a binary search of their labels. The values are kept in
+ * the order of the nodes which have them, found by the rank of the node in the bits marking those nodes.
+ * The elements are iterated in the order of Cmp.
+ * @tparam T Type for each element in the key
+ * @tparam V Type of the value that the key will be representing
+ * @tparam Cmp Comparison functor
+ */
+template < typename T,
+typename V,
+typename Cmp = std::less<T> > class LoudsTrie
+        : public ReadOnlyTrie<LoudsTrie<T, V, Cmp>, T, V, std::size_t, std::size_t>
+{
+private:
+    friend class ReadOnlyTrie<LoudsTrie<T, V, Cmp>, T, V, std::size_t, std::size_t>;
+
+public:
+    /*!
+     * Creates an empty LoudsTrie
+     * @param endSymbol The symbol which marks the end of key input
+     */
+    explicit LoudsTrie(const T &endSymbol)
+            : mEndSymbol(endSymbol) {
+        mShape.pushBack(false);
+        mShape.seal();
+        mHasValue.pushBack(false);
+        mHasValue.seal();
+    }
+
+    /*!
+     * Builds the LoudsTrie with the elements of a Trie
+     * @param trie The Trie to be copied, it is not changed
+     */
+    template <typename Items>
+    explicit LoudsTrie(Trie<T, V, Cmp, Items> const &trie)
+            : mEndSymbol(trie.endSymbol()) {
+        build(trie.begin(), trie.end());
+    }
+
+    /*!
+     * @return Number of elements
+     */
+    std::size_t size() const {
+        return mValues.size();
+    }
+
+    /*!
+     * @return true if there is no element
+     */
+    bool empty() const {
+        return mValues.empty();
+    }
+
+    T endSymbol() const {
+        return mEndSymbol;
+    }
+
+    /*!
+     * @return Number of nodes, the root included
+     */
+    std::size_t nodeCount() const {
+        return mHasValue.size();
+    }
+
+    /*!
+     * @return Number of bits used by the shape of the Trie with its directories, without the labels and values
+     */
+    std::size_t shapeBits() const {
+        return mShape.memoryUsage() * 8;
+    }
+
+    /*!
+     * @return Number of bytes used by the shape, the labels and the values
+     */
+    std::size_t memoryUsage() const {
+        return sizeof(*this) + mShape.memoryUsage() + mHasValue.memoryUsage() +
+               mLabels.capacity() * sizeof(T) + mValues.capacity() * sizeof(V);
+    }
+
+private:
+    // First edge of the node and the edge after its last, edge e leads to node e + 1 with label e
+    std::pair<std::size_t, std::size_t> edges(std::size_t node) const {
+        std::size_t first = node ? mShape.select0(node - 1) + 1 : 0;
+        std::size_t last = mShape.nextZero(first);
+        return std::make_pair(first - node, last - node);
+    }
+
+    bool root(std::size_t &node) const {
+        node = 0;
+        return true;
+    }
+
+    bool child(std::size_t node, T const &symbol, std::size_t &next) const {
+        std::pair<std::size_t, std::size_t> range = edges(node);
+        typename std::vector<T>::const_iterator first = mLabels.begin() + range.first;
+        typename std::vector<T>::const_iterator last = mLabels.begin() + range.second;
+        typename std::vector<T>::const_iterator found = std::lower_bound(first, last, symbol, Cmp());
+        if (found == last || Cmp()(symbol, *found)) {
+            return false;
+        }
+        next = (std::size_t)(found - mLabels.begin()) + 1;
+        return true;
+    }
+
+    const V *valueOf(std::size_t node) const {
+        return mHasValue[node] ? &mValues[mHasValue.rank1(node)] : 0;
+    }
+
+    std::size_t nextEdge(std::size_t, std::size_t edge) const {
+        return edge + 1;
+    }
+
+    std::size_t target(std::size_t, std::size_t edge) const {
+        return edge + 1;
+    }
+
+    T label(std::size_t edge) const {
+        return mLabels[edge];
+    }
+
+    template <typename ConstIter>
+    void build(ConstIter first, ConstIter last) {
+        // the elements come in the order of Cmp, so the nodes of each depth come in the order of the
+        // levels and are appended to the level of their depth, a node is closed by the next on its level
+        std::vector<BitVector> shapes(1);
+        std::vector<BitVector> hasValues(1);
+        std::vector< std::vector<T> > labels(1);
+        std::vector< std::vector<V> > values(1);
+        std::vector<T> pathKey;
+        hasValues[0].pushBack(false);
+        for (; first != last; ++first) {
+            const T *key = first->first;
+            std::size_t depth = 0;
+            while (depth < pathKey.size() && key[depth] != mEndSymbol && key[depth] == pathKey[depth]) {
+                ++depth;
+            }
+            pathKey.resize(depth);
+            for (; key[depth] != mEndSymbol; ++depth) {
+                if (shapes.size() == depth + 1) {
+                    shapes.push_back(BitVector());
+                    hasValues.push_back(BitVector());
+                    labels.push_back(std::vector<T>());
+                    values.push_back(std::vector<V>());
+                } else {
+                    shapes[depth + 1].pushBack(false);
+                }
+                shapes[depth].pushBack(true);
+                labels[depth].push_back(key[depth]);
+                hasValues[depth + 1].pushBack(false);
+                pathKey.push_back(key[depth]);
+            }
+            hasValues[depth].setBack();
+            values[depth].push_back(*first->second);
+        }
+
+        std::size_t labelCount = 0;
+        std::size_t valueCount = 0;
+        for (std::size_t depth = 0; depth < shapes.size(); ++depth) {
+            shapes[depth].pushBack(false);
+            labelCount += labels[depth].size();
+            valueCount += values[depth].size();
+        }
+        mLabels.reserve(labelCount);
+        mValues.reserve(valueCount);
+        for (std::size_t depth = 0; depth < shapes.size(); ++depth) {
+            mShape.append(shapes[depth]);
+            mHasValue.append(hasValues[depth]);
+            mLabels.insert(mLabels.end(), labels[depth].begin(), labels[depth].end());
+            mValues.insert(mValues.end(), values[depth].begin(), values[depth].end());
+            BitVector().swap(shapes[depth]);
+            BitVector().swap(hasValues[depth]);
+            std::vector<T>().swap(labels[depth]);
+            std::vector<V>().swap(values[depth]);
+        }
+        mShape.seal();
+        mHasValue.seal();
+    }
+
+private:
+    T mEndSymbol;
+    BitVector mShape;
+    BitVector mHasValue;
+    std::vector<T> mLabels;
+    std::vector<V> mValues;
+};
+
+}
+
+#endif
@@ -0,0 +1,259 @@
+/*
+ * Copyright (c) 2012, Ranjith TV
+ * All rights reserved.
+ *
+ * Licensed under the BSD 3-Clause ("BSD New" or "BSD Simplified") license.
+ * You may obtain a copy of the License at
+ *
+ * http://www.opensource.org/licenses/BSD-3-Clause
+ *
+ */
+
+#ifndef MAPPED_TRIE_H
+#define MAPPED_TRIE_H
+
+#include "trie.h"
+
+#include <vector>
+#include <utility>
+#include <cstring>
+#include <cstddef>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace rtv
+{
+
+/*!
+ * @brief Read only Trie mapped in to memory from a file written by Trie::save.
+ *
+ * Opening the file does not read it, the lookups and the iteration run directly on the mapped pages
+ * which the operating system loads on first use. The processes which map the same file share its pages.
+ * open checks only the header, the nodes are checked against the counts of the header as they are read,
+ * so those of a corrupted file are seen as nodes without edges or value instead of leaving the mapping.
+ * The elements are iterated in the order of Cmp.
+ * @tparam T Type for each element in the key
+ * @tparam V Type of the value that the key will be representing, the same plain old data type as the saved Trie
+ * @tparam Cmp Comparison functor
+ */
+template < typename T,
+typename V,
+typename Cmp = std::less<T> > class MappedTrie
+        : public ReadOnlyTrie<MappedTrie<T, V, Cmp>, T, V, unsigned int, unsigned int>
+{
+private:
+    typedef TrieFileHeader::Node FileNode;
+
+    friend class ReadOnlyTrie<MappedTrie<T, V, Cmp>, T, V, unsigned int, unsigned int>;
+
+public:
+    MappedTrie()
+            : mData(0),
+            mLength(0),
+            mHeader(0),
+            mNodes(0),
+            mSymbols(0),
+            mTargets(0),
+            mValues(0),
+            mEndSymbol() {}
+
+    ~MappedTrie() {
+        close();
+    }
+
+    /*!
+     * Maps a file written by Trie::save, the file opened before is closed
+     * @param path Name of the file
+     * @return true if the file is mapped, false if it could not be mapped or is not a valid Trie of T, V
+     */
+    bool open(const char *path) {
+        close();
+        if (!map(path)) {
+            return false;
+        }
+        const char *data = static_cast<const char *>(mData);
+        const TrieFileHeader *header = reinterpret_cast<const TrieFileHeader *>(data);
+        if (mLength < sizeof(TrieFileHeader) ||
+            std::memcmp(header->mMagic, TrieFileHeader::magic(), 8) != 0 ||
+            header->mFormat != TrieFileHeader::Format || header->mSymbolSize != sizeof(T) ||
+            header->mValueSize != sizeof(V) || !header->fits(mLength) || header->mRoot >= header->mNodeCount) {
+            close();
+            return false;
+        }
+        mHeader = header;
+        mEndSymbol = *reinterpret_cast<const T *>(data + header->endSymbolOffset());
+        mNodes = reinterpret_cast<const FileNode *>(data + header->nodesOffset());
+        mSymbols = reinterpret_cast<const T *>(data + header->symbolsOffset());
+        mTargets = reinterpret_cast<const unsigned int *>(data + header->targetsOffset());
+        mValues = reinterpret_cast<const V *>(data + header->valuesOffset());
+        return true;
+    }
+
+    /*!
+     * Unmaps the file, the iterators and values taken from the MappedTrie are no more valid
+     */
+    void close() {
+        if (mData) {
+            unmap();
+        }
+        mData = 0;
+        mLength = 0;
+        mHeader = 0;
+    }
+
+    /*!
+     * @return true if a file is mapped
+     */
+    bool isOpen() const {
+        return mHeader != 0;
+    }
+
+    /*!
+     * @return Number of elements
+     */
+    std::size_t size() const {
+        return mHeader ? mHeader->mValueCount : 0;
+    }
+
+    /*!
+     * @return true if there is no element
+     */
+    bool empty() const {
+        return size() == 0;
+    }
+
+    T endSymbol() const {
+        return mEndSymbol;
+    }
+
+private:
+    MappedTrie(MappedTrie const &);
+    MappedTrie &operator=(MappedTrie const &);
+
+    bool root(unsigned int &node) const {
+        node = mHeader ? mHeader->mRoot : 0;
+        return mHeader != 0;
+    }
+
+    bool child(unsigned int node, T const &symbol, unsigned int &next) const {
+        std::pair<unsigned int, unsigned int> range = edges(node);
+        const T *first = mSymbols + range.first;
+        const T *last = mSymbols + range.second;
+        const T *found = std::lower_bound(first, last, symbol, Cmp());
+        if (found == last || Cmp()(symbol, *found)) {
+            return false;
+        }
+        next = target(node, (unsigned int)(found - mSymbols));
+        return true;
+    }
+
+    // No value past the nodes or if the index of the value is past the values
+    const V *valueOf(unsigned int node) const {
+        if (node >= mHeader->mNodeCount) {
+            return 0;
+        }
+        unsigned int value = mNodes[node].mValue;
+        return value && value <= mHeader->mValueCount ? &mValues[value - 1] : 0;
+    }
+
+    // No edge past the nodes or if the edges are not all in the file
+    std::pair<unsigned int, unsigned int> edges(unsigned int node) const {
+        if (node < mHeader->mNodeCount) {
+            const FileNode &fileNode = mNodes[node];
+            if (fileNode.mFirstEdge <= mHeader->mEdgeCount &&
+                fileNode.mEdgeCount <= mHeader->mEdgeCount - fileNode.mFirstEdge) {
+                return std::make_pair(fileNode.mFirstEdge, fileNode.mFirstEdge + fileNode.mEdgeCount);
+            }
+        }
+        return std::make_pair(0u, 0u);
+    }
+
+    unsigned int nextEdge(unsigned int, unsigned int edge) const {
+        return edge + 1;
+    }
+
+    // Trie::save writes a node after the nodes below it, an edge leading elsewhere leads past the nodes
+    // so that the lookups and the iteration end
+    unsigned int target(unsigned int node, unsigned int edge) const {
+        return mTargets[edge] < node ? mTargets[edge] : mHeader->mNodeCount;
+    }
+
+    T label(unsigned int edge) const {
+        return mSymbols[edge];
+    }
+
+#if defined(_WIN32)
+    bool map(const char *path) {
+        HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+        if (file == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        LARGE_INTEGER size;
+        HANDLE mapping = 0;
+        if (GetFileSizeEx(file, &size) && size.QuadPart > 0) {
+            mapping = CreateFileMappingA(file, 0, PAGE_READONLY, 0, 0, 0);
+        }
+        CloseHandle(file);
+        if (!mapping) {
+            return false;
+        }
+        // the view keeps the mapping alive
+        mData = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapping);
+        mLength = mData ? (std::size_t)size.QuadPart : 0;
+        return mData != 0;
+    }
+
+    void unmap() {
+        UnmapViewOfFile(mData);
+    }
+#else
+    bool map(const char *path) {
+        int file = ::open(path, O_RDONLY);
+        if (file < 0) {
+            return false;
+        }
+        struct stat status;
+        void *data = MAP_FAILED;
+        if (::fstat(file, &status) == 0 && status.st_size > 0) {
+            data = ::mmap(0, (std::size_t)status.st_size, PROT_READ, MAP_SHARED, file, 0);
+        }
+        // the mapping stays after the file is closed
+        ::close(file);
+        if (data == MAP_FAILED) {
+            return false;
+        }
+        mData = data;
+        mLength = (std::size_t)status.st_size;
+        return true;
+    }
+
+    void unmap() {
+        ::munmap(mData, mLength);
+    }
+#endif
+
+private:
+    void *mData;
+    std::size_t mLength;
+    const TrieFileHeader *mHeader;
+    const FileNode *mNodes;
+    const T *mSymbols;
+    const unsigned int *mTargets;
+    const V *mValues;
+    T mEndSymbol;
+};
+
+}
+
+#endif
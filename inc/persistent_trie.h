@@ -0,0 +1,586 @@
+/*
+ * Copyright (c) 2012, Ranjith TV
+ * All rights reserved.
+ *
+ * Licensed under the BSD 3-Clause ("BSD New" or "BSD Simplified") license.
+ * You may obtain a copy of the License at
+ *
+ * http://www.opensource.org/licenses/BSD-3-Clause
+ *
+ */
+
+#ifndef PERSISTENT_TRIE_H
+#define PERSISTENT_TRIE_H
+
+#include "trie.h"
+
+#ifdef RTV_HAS_CXX11
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cstddef>
+
+namespace rtv
+{
+
+/*!
+ * @brief Trie whose versions can be kept as immutable snapshots.
+ *
+ * PersistentTrie::snapshot returns in constant time a handle to the current version of the Trie,
+ * which can be read and iterated by any thread while the Trie is modified.
+ * The nodes are shared by the versions and reference counted. A modification copies only the
+ * nodes on the path from the root to the key which are shared with a snapshot (path copying),
+ * nodes referred only by the current version are modified in place.
+ * A version is freed when its last snapshot is destroyed.
+ *
+ * The modifications are serialized by a mutex, so a PersistentTrie can be modified by several threads.
+ * Requires C++11.
+ * @tparam T Type for each element in the key
+ * @tparam V Type of the value that the key will be representing, it should be copy constructible
+ * @tparam Cmp Comparison functor
+ */
+template < typename T,
+typename V,
+typename Cmp = std::less<T> > class PersistentTrie
+{
+private:
+    struct Node;
+
+    typedef std::vector< std::pair<T, Node *> > Children;
+
+    struct Node {
+        Node()
+                : mRefs(1),
+                mValue(0) {}
+
+        // The copy refers to the same children as oth
+        Node(Node const &oth)
+                : mRefs(1),
+                mValue(oth.mValue ? new V(*oth.mValue) : 0),
+                mChildren(oth.mChildren) {
+            for (std::size_t i = 0; i < mChildren.size(); ++i) {
+                acquire(mChildren[i].second);
+            }
+        }
+
+        ~Node() {
+            delete mValue;
+        }
+
+        std::atomic<std::size_t> mRefs;
+        V *mValue;
+        Children mChildren;
+
+    private:
+        Node &operator=(Node const &);
+    };
+
+public:
+    static const std::size_t npos = static_cast<std::size_t>(-1);
+
+    /*!
+     * @brief Iterator to the elements of a Snapshot, in the order of Cmp.
+     *
+     * It stays valid as long as the Snapshot it was taken from lives.
+     */
+    class ConstIterator
+    {
+    private:
+        typedef std::pair<const T *, const V *> KeyValuePair;
+
+        // Node being visited and the index of its next child to be visited
+        struct Frame {
+            const Node *mNode;
+            std::size_t mChild;
+        };
+
+    public:
+        ConstIterator()
+                : mKeyValuePair((const T *)0, (const V *)0) {}
+
+        ConstIterator(ConstIterator const &oth)
+                : mStack(oth.mStack),
+                mKey(oth.mKey),
+                mKeyValuePair(mKey.empty() ? (const T *)0 : &mKey[0], oth.mKeyValuePair.second) {}
+
+        ConstIterator &operator=(ConstIterator const &oth) {
+            if (this != &oth) {
+                mStack = oth.mStack;
+                mKey = oth.mKey;
+                mKeyValuePair = KeyValuePair(mKey.empty() ? (const T *)0 : &mKey[0], oth.mKeyValuePair.second);
+            }
+            return *this;
+        }
+
+        const KeyValuePair &operator*() const {
+            return mKeyValuePair;
+        }
+
+        const KeyValuePair *operator->() const {
+            return &mKeyValuePair;
+        }
+
+        bool operator==(ConstIterator const &oth) const {
+            if (mStack.size() != oth.mStack.size()) {
+                return false;
+            }
+            return mStack.empty() || (mStack.back().mNode == oth.mStack.back().mNode &&
+                                      mStack.back().mChild == oth.mStack.back().mChild);
+        }
+
+        bool operator!=(ConstIterator const &oth) const {
+            return !(*this == oth);
+        }
+
+        ConstIterator &operator++() {
+            next();
+            return *this;
+        }
+
+        ConstIterator operator++(int) {
+            ConstIterator iter = *this;
+            next();
+            return iter;
+        }
+
+    private:
+        friend class PersistentTrie;
+
+        // Iterates over node and the nodes below it, prefix is the key of node
+        ConstIterator(const Node *node, const T *prefix, std::size_t length, T const &endSymbol)
+                : mKey(prefix, prefix + length),
+                mKeyValuePair((const T *)0, (const V *)0) {
+            mKey.push_back(endSymbol);
+            Frame frame = { node, 0 };
+            mStack.push_back(frame);
+            if (node->mValue) {
+                produce(node);
+            } else {
+                next();
+            }
+        }
+
+        void produce(const Node *node) {
+            mKeyValuePair = KeyValuePair(&mKey[0], node->mValue);
+        }
+
+        // Preorder walk, the key holds the symbols of the path followed by the end symbol
+        void next() {
+            while (!mStack.empty()) {
+                Frame &frame = mStack.back();
+                if (frame.mChild < frame.mNode->mChildren.size()) {
+                    std::pair<T, Node *> const &child = frame.mNode->mChildren[frame.mChild++];
+                    T endSymbol = mKey.back();
+                    mKey.back() = child.first;
+                    mKey.push_back(endSymbol);
+                    Frame childFrame = { child.second, 0 };
+                    mStack.push_back(childFrame);
+                    if (child.second->mValue) {
+                        produce(child.second);
+                        return;
+                    }
+                } else {
+                    mStack.pop_back();
+                    if (!mStack.empty()) {
+                        T endSymbol = mKey.back();
+                        mKey.pop_back();
+                        mKey.back() = endSymbol;
+                    }
+                }
+            }
+            mKeyValuePair = KeyValuePair((const T *)0, (const V *)0);
+        }
+
+    private:
+        std::vector<Frame> mStack;
+        std::vector<T> mKey;
+        KeyValuePair mKeyValuePair;
+    };
+
+    /*!
+     * @brief Immutable version of a PersistentTrie.
+     *
+     * Copying a Snapshot is constant time, the copies share the version.
+     */
+    class Snapshot
+    {
+    public:
+        Snapshot(Snapshot const &oth)
+                : mRoot(oth.mRoot),
+                mSize(oth.mSize),
+                mEndSymbol(oth.mEndSymbol) {
+            acquire(mRoot);
+        }
+
+        Snapshot &operator=(Snapshot const &oth) {
+            acquire(oth.mRoot);
+            release(mRoot);
+            mRoot = oth.mRoot;
+            mSize = oth.mSize;
+            mEndSymbol = oth.mEndSymbol;
+            return *this;
+        }
+
+        ~Snapshot() {
+            release(mRoot);
+        }
+
+        /*!
+         * Retrieves the value of a key in the Snapshot
+         * @param key Key to be searched for, should be terminated by 'end' symbol
+         * @return Pointer to the value of the key, 0 if the key is not present
+         */
+        const V *get(const T *key) const {
+            return get(key, npos);
+        }
+
+        /*!
+         * Retrieves the value of a key in the Snapshot
+         * @param key Key to be searched for, need not be terminated
+         * @param length Number of symbols in the key
+         * @return Pointer to the value of the key, 0 if the key is not present
+         */
+        const V *get(const T *key, std::size_t length) const {
+            const Node *node = descend(mRoot, key, measure(mEndSymbol, key, length));
+            return node ? node->mValue : 0;
+        }
+
+        /*!
+         * Checks whether the given key is present in the Snapshot
+         * @param key Key to be searched for, should be terminated by 'end' symbol
+         * @return true if the key is present
+         */
+        bool hasKey(const T *key) const {
+            return get(key) != 0;
+        }
+
+        /*!
+         * Checks whether the given key is present in the Snapshot
+         * @param key Key to be searched for, need not be terminated
+         * @param length Number of symbols in the key
+         * @return true if the key is present
+         */
+        bool hasKey(const T *key, std::size_t length) const {
+            return get(key, length) != 0;
+        }
+
+        /*!
+         * Retrieves ConstIterator to the elements with common prefix
+         * @param prefix Part of the key which should be searched, should be terminated by 'end' symbol
+         * @return ConstIterator to the first element with the prefix, end() if there is none
+         */
+        ConstIterator startsWith(const T *prefix) const {
+            return startsWith(prefix, npos);
+        }
+
+        /*!
+         * Retrieves ConstIterator to the elements with common prefix
+         * @param prefix Part of the key which should be searched, need not be terminated
+         * @param length Number of symbols in the prefix
+         * @return ConstIterator to the first element with the prefix, end() if there is none
+         */
+        ConstIterator startsWith(const T *prefix, std::size_t length) const {
+            length = measure(mEndSymbol, prefix, length);
+            const Node *node = descend(mRoot, prefix, length);
+            if (!node) {
+                return end();
+            }
+            return ConstIterator(node, prefix, length, mEndSymbol);
+        }
+
+        /*!
+         * @return ConstIterator to the first element of the Snapshot
+         */
+        ConstIterator begin() const {
+            return ConstIterator(mRoot, (const T *)0, 0, mEndSymbol);
+        }
+
+        /*!
+         * @return ConstIterator past the last element of the Snapshot
+         */
+        ConstIterator end() const {
+            return ConstIterator();
+        }
+
+        /*!
+         * @return Number of elements in the Snapshot
+         */
+        std::size_t size() const {
+            return mSize;
+        }
+
+        /*!
+         * @return true if the Snapshot has no element
+         */
+        bool empty() const {
+            return mSize == 0;
+        }
+
+        T endSymbol() const {
+            return mEndSymbol;
+        }
+
+    private:
+        friend class PersistentTrie;
+
+        // Takes over a reference to root
+        Snapshot(Node *root, std::size_t size, T const &endSymbol)
+                : mRoot(root),
+                mSize(size),
+                mEndSymbol(endSymbol) {}
+
+    private:
+        Node *mRoot;
+        std::size_t mSize;
+        T mEndSymbol;
+    };
+
+public:
+    /*!
+     * @param endSymbol The symbol which marks the end of key input
+     */
+    explicit PersistentTrie(const T &endSymbol)
+            : mRoot(new Node()),
+            mSize(0),
+            mEndSymbol(endSymbol) {}
+
+    /*!
+     * The snapshots taken from the Trie stay valid
+     */
+    ~PersistentTrie() {
+        release(mRoot);
+    }
+
+    /*!
+     * Takes a snapshot of the current version in constant time
+     * @return The snapshot
+     */
+    Snapshot snapshot() const {
+        std::lock_guard<std::mutex> lock(mWriteLock);
+        acquire(mRoot);
+        return Snapshot(mRoot, mSize, mEndSymbol);
+    }
+
+    /*!
+     * Add a key with value in to the Trie, the value of a key already present is not changed
+     * @param key Key which should be inserted, should be terminated by 'end' symbol
+     * @param value The value that is to be set with the key
+     * @return true if the key is newly inserted, false otherwise
+     */
+    bool insert(const T *key, V const &value) {
+        return insert(key, npos, value, false);
+    }
+
+    /*!
+     * Add a key with value in to the Trie, the value of a key already present is not changed
+     * @param key Key which should be inserted, need not be terminated
+     * @param length Number of symbols in the key
+     * @param value The value that is to be set with the key
+     * @return true if the key is newly inserted, false otherwise
+     */
+    bool insert(const T *key, std::size_t length, V const &value) {
+        return insert(key, length, value, false);
+    }
+
+    /*!
+     * Add a key with value in to the Trie, the value of a key already present is replaced
+     * @param key Key which should be inserted, should be terminated by 'end' symbol
+     * @param value The value that is to be set with the key
+     * @return true if the key is newly inserted, false if the value was replaced
+     */
+    bool insertOrAssign(const T *key, V const &value) {
+        return insert(key, npos, value, true);
+    }
+
+    /*!
+     * Add a key with value in to the Trie, the value of a key already present is replaced
+     * @param key Key which should be inserted, need not be terminated
+     * @param length Number of symbols in the key
+     * @param value The value that is to be set with the key
+     * @return true if the key is newly inserted, false if the value was replaced
+     */
+    bool insertOrAssign(const T *key, std::size_t length, V const &value) {
+        return insert(key, length, value, true);
+    }
+
+    /*!
+     * Remove the entry with the given key from the Trie
+     * @param key Key which should be erased, should be terminated by 'end' symbol
+     * @return true if the given key is erased from the Trie, false otherwise
+     */
+    bool erase(const T *key) {
+        return erase(key, npos);
+    }
+
+    /*!
+     * Remove the entry with the given key from the Trie
+     * @param key Key which should be erased, need not be terminated
+     * @param length Number of symbols in the key
+     * @return true if the given key is erased from the Trie, false otherwise
+     */
+    bool erase(const T *key, std::size_t length) {
+        std::lock_guard<std::mutex> lock(mWriteLock);
+        length = measure(mEndSymbol, key, length);
+        const Node *found = descend(mRoot, key, length);
+        if (!found || !found->mValue) {
+            return false;
+        }
+
+        std::vector<Node *> path(1, own(mRoot));
+        for (std::size_t i = 0; i < length; ++i) {
+            Children &children = path.back()->mChildren;
+            path.push_back(own(children[position(children, key[i])].second));
+        }
+        delete path.back()->mValue;
+        path.back()->mValue = 0;
+        --mSize;
+
+        // nodes left without a value and children are removed from their parents
+        for (std::size_t i = length; i > 0 && !path[i]->mValue && path[i]->mChildren.empty(); --i) {
+            Children &children = path[i - 1]->mChildren;
+            typename Children::iterator iter = children.begin() + position(children, key[i - 1]);
+            release(iter->second);
+            children.erase(iter);
+        }
+        return true;
+    }
+
+    /*!
+     * Remove all the elements from the Trie, the snapshots keep their elements
+     */
+    void clear() {
+        std::lock_guard<std::mutex> lock(mWriteLock);
+        release(mRoot);
+        mRoot = new Node();
+        mSize = 0;
+    }
+
+    /*!
+     * @return Number of elements in the current version
+     */
+    std::size_t size() const {
+        std::lock_guard<std::mutex> lock(mWriteLock);
+        return mSize;
+    }
+
+    /*!
+     * @return true if the current version has no element
+     */
+    bool empty() const {
+        return size() == 0;
+    }
+
+    T endSymbol() const {
+        return mEndSymbol;
+    }
+
+private:
+    PersistentTrie(PersistentTrie const &);
+    PersistentTrie &operator=(PersistentTrie const &);
+
+    static void acquire(Node *node) {
+        node->mRefs.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static void release(Node *node) {
+        if (node->mRefs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            for (std::size_t i = 0; i < node->mChildren.size(); ++i) {
+                release(node->mChildren[i].second);
+            }
+            delete node;
+        }
+    }
+
+    // Returns the node in slot, which is replaced by a copy first if the node is shared with a snapshot.
+    // The parent of the slot should be owned by the current version
+    static Node *own(Node *&slot) {
+        Node *node = slot;
+        if (node->mRefs.load(std::memory_order_acquire) != 1) {
+            slot = new Node(*node);
+            release(node);
+        }
+        return slot;
+    }
+
+    static bool symbolLess(std::pair<T, Node *> const &child, T const &k) {
+        return Cmp()(child.first, k);
+    }
+
+    // Index of the first child not ordered before k
+    static std::size_t position(Children const &children, T const &k) {
+        return std::lower_bound(children.begin(), children.end(), k, &symbolLess) - children.begin();
+    }
+
+    static bool contains(Children const &children, std::size_t pos, T const &k) {
+        return pos < children.size() && !Cmp()(k, children[pos].first);
+    }
+
+    static std::size_t measure(T const &endSymbol, const T *key, std::size_t length) {
+        if (length == npos) {
+            for (length = 0; key[length] != endSymbol; ++length) {
+            }
+        }
+        return length;
+    }
+
+    static const Node *descend(const Node *node, const T *key, std::size_t length) {
+        for (std::size_t i = 0; i < length; ++i) {
+            std::size_t pos = position(node->mChildren, key[i]);
+            if (!contains(node->mChildren, pos, key[i])) {
+                return 0;
+            }
+            node = node->mChildren[pos].second;
+        }
+        return node;
+    }
+
+    bool insert(const T *key, std::size_t length, V const &value, bool assign) {
+        std::lock_guard<std::mutex> lock(mWriteLock);
+        length = measure(mEndSymbol, key, length);
+        const Node *found = descend(mRoot, key, length);
+        if (found && found->mValue && !assign) {
+            return false;
+        }
+
+        Node *node = own(mRoot);
+        for (std::size_t i = 0; i < length; ++i) {
+            Children &children = node->mChildren;
+            std::size_t pos = position(children, key[i]);
+            if (contains(children, pos, key[i])) {
+                node = own(children[pos].second);
+            } else {
+                Node *child = new Node();
+                children.insert(children.begin() + pos, std::make_pair(key[i], child));
+                node = child;
+            }
+        }
+
+        bool inserted = (node->mValue == 0);
+        if (inserted) {
+            node->mValue = new V(value);
+            ++mSize;
+        } else {
+            *node->mValue = value;
+        }
+        return inserted;
+    }
+
+private:
+    Node *mRoot;
+    std::size_t mSize;
+    T mEndSymbol;
+    mutable std::mutex mWriteLock;
+};
+
+template < typename T,
+typename V,
+typename Cmp > const std::size_t PersistentTrie<T, V, Cmp>::npos;
+
+}
+
+#endif
+
+#endif
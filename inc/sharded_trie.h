@@ -0,0 +1,444 @@
+/*
+ * Copyright (c) 2012, Ranjith TV
+ * All rights reserved.
+ *
+ * Licensed under the BSD 3-Clause ("BSD New" or "BSD Simplified") license.
+ * You may obtain a copy of the License at
+ *
+ * http://www.opensource.org/licenses/BSD-3-Clause
+ *
+ */
+
+#ifndef SHARDED_TRIE_H
+#define SHARDED_TRIE_H
+
+#include "trie.h"
+
+#ifdef RTV_HAS_CXX11
+
+#include <mutex>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cstddef>
+
+namespace rtv
+{
+
+/*!
+ * @brief Trie split in to independently locked shards, so that threads can modify it in parallel.
+ *
+ * A key belongs to the shard chosen by its first prefixLength symbols, each shard is an rtv::Trie
+ * guarded by a mutex of its own. Threads working on keys of different shards do not wait for each other.
+ * The iteration visits the elements of all the shards in the order of Cmp by merging the shards.
+ *
+ * The iterators do not lock the shards, no thread should modify the ShardedTrie while it is iterated.
+ * Requires C++11.
+ * @tparam T Type for each element in the key
+ * @tparam V Type of the value that the key will be representing
+ * @tparam Cmp Comparison functor
+ * @tparam Items The data structure that represents each node in the shards, see rtv::Trie
+ * @tparam M Functor which maps a symbol to an unsigned integer, the symbols equal as per Cmp
+ *           should be mapped to the same integer
+ */
+template < typename T,
+typename V,
+typename Cmp = std::less<T>,
+typename Items = SetItems<T, V, Cmp>,
+typename M = SymbolToIndexMapper<T> > class ShardedTrie
+{
+public:
+    typedef Trie<T, V, Cmp, Items> TrieType;
+
+private:
+    struct Shard {
+        explicit Shard(const T &endSymbol, bool pathCompression)
+                : mTrie(endSymbol, pathCompression) {}
+
+        TrieType mTrie;
+        std::mutex mLock;
+    };
+
+public:
+    static const std::size_t npos = static_cast<std::size_t>(-1);
+
+    /*!
+     * @brief Iterator which merges the iterators of the shards in the order of Cmp.
+     */
+    class ConstIterator
+    {
+    private:
+        typedef typename TrieType::ConstIterator ShardIterator;
+        typedef std::pair<const T *, const V *> KeyValuePair;
+
+        struct Head {
+            ShardIterator mIter;
+            ShardIterator mEnd;
+        };
+
+        // Orders the heads so that the one with the smallest key is at the front of the heap
+        class HeadGreater
+        {
+        public:
+            explicit HeadGreater(T const &endSymbol)
+                    : mEndSymbol(endSymbol) {}
+
+            bool operator()(Head const &h1, Head const &h2) const {
+                const T *k1 = h1.mIter->first;
+                const T *k2 = h2.mIter->first;
+                // A shard yields a key before its extensions, so a key which ended is the smaller one
+                // regardless of where Cmp places the end symbol
+                for (std::size_t i = 0;; ++i) {
+                    if (k1[i] == mEndSymbol || k2[i] == mEndSymbol) {
+                        return !(k1[i] == mEndSymbol);
+                    }
+                    if (Cmp()(k2[i], k1[i])) {
+                        return true;
+                    }
+                    if (Cmp()(k1[i], k2[i])) {
+                        return false;
+                    }
+                }
+            }
+
+        private:
+            T mEndSymbol;
+        };
+
+    public:
+        ConstIterator()
+                : mEndSymbol() {}
+
+        const KeyValuePair &operator*() const {
+            return *mHeads.front().mIter;
+        }
+
+        const KeyValuePair *operator->() const {
+            return &*mHeads.front().mIter;
+        }
+
+        bool operator==(ConstIterator const &oth) const {
+            if (mHeads.empty() || oth.mHeads.empty()) {
+                return mHeads.empty() && oth.mHeads.empty();
+            }
+            return mHeads.front().mIter == oth.mHeads.front().mIter;
+        }
+
+        bool operator!=(ConstIterator const &oth) const {
+            return !(*this == oth);
+        }
+
+        ConstIterator &operator++() {
+            next();
+            return *this;
+        }
+
+        ConstIterator operator++(int) {
+            ConstIterator iter = *this;
+            next();
+            return iter;
+        }
+
+    private:
+        friend class ShardedTrie;
+
+        explicit ConstIterator(T const &endSymbol)
+                : mEndSymbol(endSymbol) {}
+
+        void add(ShardIterator const &iter, ShardIterator const &end) {
+            if (iter != end) {
+                Head head = { iter, end };
+                mHeads.push_back(head);
+                std::push_heap(mHeads.begin(), mHeads.end(), HeadGreater(mEndSymbol));
+            }
+        }
+
+        void next() {
+            std::pop_heap(mHeads.begin(), mHeads.end(), HeadGreater(mEndSymbol));
+            if (++mHeads.back().mIter == mHeads.back().mEnd) {
+                mHeads.pop_back();
+            } else {
+                std::push_heap(mHeads.begin(), mHeads.end(), HeadGreater(mEndSymbol));
+            }
+        }
+
+    private:
+        std::vector<Head> mHeads;
+        T mEndSymbol;
+    };
+
+public:
+    /*!
+     * @param endSymbol The symbol which marks the end of key input
+     * @param shards Number of shards
+     * @param prefixLength Number of leading symbols which choose the shard of a key,
+     *                     shorter keys are kept in the shard chosen by all their symbols
+     * @param pathCompression Whether the shards use path compression, see rtv::Trie
+     */
+    explicit ShardedTrie(const T &endSymbol, std::size_t shards = 16, std::size_t prefixLength = 1,
+                         bool pathCompression = false)
+            : mEndSymbol(endSymbol),
+            mPrefixLength(prefixLength) {
+        for (std::size_t i = 0; i < std::max(shards, (std::size_t)1); ++i) {
+            mShards.push_back(new Shard(endSymbol, pathCompression));
+        }
+    }
+
+    ~ShardedTrie() {
+        for (std::size_t i = 0; i < mShards.size(); ++i) {
+            delete mShards[i];
+        }
+    }
+
+    /*!
+     * Add a key with value in to the Trie, the value of a key already present is not changed
+     * @param key Key which should be inserted, should be terminated by 'end' symbol
+     * @param value The value that is to be set with the key
+     * @return true if the key is newly inserted, false otherwise
+     */
+    bool insert(const T *key, V const &value) {
+        return insert(key, npos, value);
+    }
+
+    /*!
+     * Add a key with value in to the Trie, the value of a key already present is not changed
+     * @param key Key which should be inserted, need not be terminated
+     * @param length Number of symbols in the key
+     * @param value The value that is to be set with the key
+     * @return true if the key is newly inserted, false otherwise
+     */
+    bool insert(const T *key, std::size_t length, V const &value) {
+        length = measure(key, length);
+        Shard &shard = shardOf(key, length);
+        std::lock_guard<std::mutex> lock(shard.mLock);
+        return shard.mTrie.insertFast(key, length, value).second;
+    }
+
+    /*!
+     * Add a key with value in to the Trie, the value of a key already present is replaced
+     * @param key Key which should be inserted, should be terminated by 'end' symbol
+     * @param value The value that is to be set with the key
+     * @return true if the key is newly inserted, false if the value was replaced
+     */
+    bool insertOrAssign(const T *key, V const &value) {
+        return insertOrAssign(key, npos, value);
+    }
+
+    /*!
+     * Add a key with value in to the Trie, the value of a key already present is replaced
+     * @param key Key which should be inserted, need not be terminated
+     * @param length Number of symbols in the key
+     * @param value The value that is to be set with the key
+     * @return true if the key is newly inserted, false if the value was replaced
+     */
+    bool insertOrAssign(const T *key, std::size_t length, V const &value) {
+        length = measure(key, length);
+        Shard &shard = shardOf(key, length);
+        std::lock_guard<std::mutex> lock(shard.mLock);
+        std::pair<V *, bool> res = shard.mTrie.insertFast(key, length, value);
+        if (!res.second) {
+            *res.first = value;
+        }
+        return res.second;
+    }
+
+    /*!
+     * Remove the entry with the given key from the Trie
+     * @param key Key which should be erased, should be terminated by 'end' symbol
+     * @return true if the given key is erased from the Trie, false otherwise
+     */
+    bool erase(const T *key) {
+        return erase(key, npos);
+    }
+
+    /*!
+     * Remove the entry with the given key from the Trie
+     * @param key Key which should be erased, need not be terminated
+     * @param length Number of symbols in the key
+     * @return true if the given key is erased from the Trie, false otherwise
+     */
+    bool erase(const T *key, std::size_t length) {
+        length = measure(key, length);
+        Shard &shard = shardOf(key, length);
+        std::lock_guard<std::mutex> lock(shard.mLock);
+        return shard.mTrie.erase(key, length);
+    }
+
+    /*!
+     * Copies the value of a key
+     * @param key Key to be searched for, should be terminated by 'end' symbol
+     * @param value Set to the value of the key when it is found
+     * @return true if the key is found, false otherwise
+     */
+    bool get(const T *key, V &value) const {
+        return get(key, npos, value);
+    }
+
+    /*!
+     * Copies the value of a key
+     * @param key Key to be searched for, need not be terminated
+     * @param length Number of symbols in the key
+     * @param value Set to the value of the key when it is found
+     * @return true if the key is found, false otherwise
+     */
+    bool get(const T *key, std::size_t length, V &value) const {
+        length = measure(key, length);
+        Shard &shard = shardOf(key, length);
+        std::lock_guard<std::mutex> lock(shard.mLock);
+        const V *found = ((TrieType const &)shard.mTrie).get(key, length);
+        if (found) {
+            value = *found;
+        }
+        return found != 0;
+    }
+
+    /*!
+     * Checks whether the given key is present in the Trie
+     * @param key Key to be searched for, should be terminated by 'end' symbol
+     * @return true if the key is present
+     */
+    bool hasKey(const T *key) const {
+        return hasKey(key, npos);
+    }
+
+    /*!
+     * Checks whether the given key is present in the Trie
+     * @param key Key to be searched for, need not be terminated
+     * @param length Number of symbols in the key
+     * @return true if the key is present
+     */
+    bool hasKey(const T *key, std::size_t length) const {
+        length = measure(key, length);
+        Shard &shard = shardOf(key, length);
+        std::lock_guard<std::mutex> lock(shard.mLock);
+        return shard.mTrie.hasKey(key, length);
+    }
+
+    /*!
+     * Retrieves ConstIterator to the elements with common prefix. A prefix of at least prefixLength
+     * symbols belongs to a single shard and only that shard is searched
+     * @param prefix Part of the key which should be searched, should be terminated by 'end' symbol
+     * @return ConstIterator to the first element with the prefix, end() if there is none
+     */
+    ConstIterator startsWith(const T *prefix) const {
+        return startsWith(prefix, npos);
+    }
+
+    /*!
+     * Retrieves ConstIterator to the elements with common prefix
+     * @param prefix Part of the key which should be searched, need not be terminated
+     * @param length Number of symbols in the prefix
+     * @return ConstIterator to the first element with the prefix, end() if there is none
+     */
+    ConstIterator startsWith(const T *prefix, std::size_t length) const {
+        length = measure(prefix, length);
+        ConstIterator iter(mEndSymbol);
+        if (length >= mPrefixLength) {
+            TrieType const &trie = shardOf(prefix, length).mTrie;
+            iter.add(trie.startsWith(prefix, length), trie.end());
+        } else {
+            for (std::size_t i = 0; i < mShards.size(); ++i) {
+                TrieType const &trie = mShards[i]->mTrie;
+                iter.add(trie.startsWith(prefix, length), trie.end());
+            }
+        }
+        return iter;
+    }
+
+    /*!
+     * @return ConstIterator to the first element in the order of Cmp
+     */
+    ConstIterator begin() const {
+        ConstIterator iter(mEndSymbol);
+        for (std::size_t i = 0; i < mShards.size(); ++i) {
+            TrieType const &trie = mShards[i]->mTrie;
+            iter.add(trie.begin(), trie.end());
+        }
+        return iter;
+    }
+
+    /*!
+     * @return ConstIterator past the last element
+     */
+    ConstIterator end() const {
+        return ConstIterator(mEndSymbol);
+    }
+
+    /*!
+     * @return Number of elements in the Trie
+     */
+    std::size_t size() const {
+        std::size_t count = 0;
+        for (std::size_t i = 0; i < mShards.size(); ++i) {
+            std::lock_guard<std::mutex> lock(mShards[i]->mLock);
+            count += mShards[i]->mTrie.size();
+        }
+        return count;
+    }
+
+    /*!
+     * @return true if the Trie has no element
+     */
+    bool empty() const {
+        return size() == 0;
+    }
+
+    /*!
+     * All the elements in the Trie are dropped
+     */
+    void clear() {
+        for (std::size_t i = 0; i < mShards.size(); ++i) {
+            std::lock_guard<std::mutex> lock(mShards[i]->mLock);
+            mShards[i]->mTrie.clear();
+        }
+    }
+
+    /*!
+     * @return Number of shards
+     */
+    std::size_t shardCount() const {
+        return mShards.size();
+    }
+
+    T endSymbol() const {
+        return mEndSymbol;
+    }
+
+private:
+    ShardedTrie(ShardedTrie const &);
+    ShardedTrie &operator=(ShardedTrie const &);
+
+    std::size_t measure(const T *key, std::size_t length) const {
+        if (length == npos) {
+            for (length = 0; key[length] != mEndSymbol; ++length) {
+            }
+        }
+        return length;
+    }
+
+    Shard &shardOf(const T *key, std::size_t length) const {
+        std::size_t hash = 0;
+        for (std::size_t i = 0; i < std::min(length, mPrefixLength); ++i) {
+            hash = hash * 31 + mSymbolToIndex(key[i]);
+        }
+        return *mShards[hash % mShards.size()];
+    }
+
+private:
+    T mEndSymbol;
+    std::size_t mPrefixLength;
+    std::vector<Shard *> mShards;
+    M mSymbolToIndex;
+};
+
+template < typename T,
+typename V,
+typename Cmp,
+typename Items,
+typename M > const std::size_t ShardedTrie<T, V, Cmp, Items, M>::npos;
+
+}
+
+#endif
+
+#endif
@@ -1,1441 +1,6329 @@
-/*
- * Copyright (c) 2012, Ranjith TV
- * All rights reserved.
- *
- * Licensed under the BSD 3-Clause ("BSD New" or "BSD Simplified") license.
- * You may obtain a copy of the License at
- *
- * http://www.opensource.org/licenses/BSD-3-Clause
- *
- */
-
-#ifndef TRIE_H
-#define TRIE_H
-
-#include <vector>
-#include <set>
-#include <algorithm>
-
-namespace rtv
-{
-
-template < typename T,
-typename V,
-typename Cmp,
-typename Items > class Node;
-
-template < typename T,
-typename V,
-typename Cmp,
-typename Items > class NodeItem
-{
-private:
-    typedef Node<T, V, Cmp, Items> NodeClass;
-    typedef NodeItem<T, V, Cmp, Items> NodeItemClass;
-
-public:
-    NodeItem(const T &endSymbol, T const &key)
-            : mEndSymbol(endSymbol),
-            mKey(key),
-            mChilds(0) {}
-
-    virtual ~NodeItem() {
-        delete mChilds;
-    }
-
-    bool operator<(NodeItemClass const &oth) const {
-        return Cmp()(this->mKey, oth.mKey);
-    }
-
-    bool operator<(T const &key) const {
-        return Cmp()(this->mKey, key);
-    }
-
-    bool operator==(T const &key) const {
-        return !Cmp()(this->mKey, key) && !Cmp()(key, this->mKey);
-    }
-
-    bool operator==(NodeItemClass const &oth) const {
-        return !Cmp()(this->mKey, oth.mKey) && !Cmp()(oth.mKey, this->mKey);
-    }
-
-    bool operator!=(T const &key) const {
-        return !((*this) == key);
-    }
-
-    bool operator!=(NodeItemClass const &oth) const {
-        return !((*this) == oth);
-    }
-
-    void set(T const &key) {
-        mKey = key;
-    }
-
-    const T &get() const {
-        return mKey;
-    }
-
-    const NodeClass *getChilds() const {
-        return mChilds;
-    }
-
-    NodeClass *getChilds() {
-        return mChilds;
-    }
-
-    NodeClass *getOrCreateChilds(NodeClass * parent) {
-        createChilds(parent);
-        return mChilds;
-    }
-
-private:
-    void createChilds(NodeClass * parent) {
-        if (!mChilds) {
-            mChilds = new NodeClass(mEndSymbol, parent);
-        }
-    }
-
-    NodeItem(NodeItem const &);
-    NodeItem &operator=(NodeItem const &);
-
-private:
-    const T mEndSymbol;
-    T mKey;
-    NodeClass *mChilds;
-};
-
-template < typename T,
-typename V,
-typename Cmp,
-typename Items > class EndNodeItem: public NodeItem<T, V, Cmp, Items>
-{
-private:
-    typedef NodeItem<T, V, Cmp, Items> ParentClass;
-
-public:
-    EndNodeItem(const T &endSymbol, T const &key)
-            : ParentClass(endSymbol, key) {}
-
-    EndNodeItem(const T &endSymbol, T const &key, V const &value)
-            : ParentClass(endSymbol, key),
-            mValue(value) {}
-
-    void set(T const &key, V const &value) {
-        ParentClass::set(key);
-        mValue = value;
-    }
-
-    const V &getValue() const {
-        return mValue;
-    }
-
-    V &getValue() {
-        return mValue;
-    }
-
-private:
-    EndNodeItem(EndNodeItem const &);
-    EndNodeItem &operator=(EndNodeItem const &);
-
-private:
-    V mValue;
-};
-
-template < typename T,
-typename V,
-typename Cmp,
-typename Items > class NodeItemPtrCompare
-{
-private:
-    typedef NodeItem<T, V, Cmp, Items> NodeItemClass;
-
-public:
-    bool operator()(const NodeItemClass *v1, const NodeItemClass *v2) {
-        return *v1 < *v2;
-    }
-};
-
-template < typename T,
-typename V,
-typename Cmp,
-typename Items > class Node
-{
-public:
-    typedef NodeItem<T, V, Cmp, Items> NodeItemClass;
-    typedef EndNodeItem<T, V, Cmp, Items> EndNodeItemClass;
-    typedef Node<T, V, Cmp, Items> NodeClass;
-
-private:
-    typedef typename Items::iterator ItemsContainerIter;
-    typedef typename Items::const_iterator ItemsContainerConstIter;
-
-public:
-
-    class ConstIterator
-    {
-    protected:
-        typedef std::pair<const T *, const V *> KeyValuePair;
-        typedef typename NodeClass::ItemsContainerConstIter ItemsContainerConstIter2;
-
-    public:
-        ConstIterator(const NodeClass *node, const NodeClass * root, const T * key = 0, bool mooveToEnd = false)
-                : mRootNode(root),
-                  mCurrentNode(node),
-                  mCheckKeyLeft(false),
-                  mCheckKeyRight(true),
-                  mEndReached(false) {
-            if (!root) {
-                mRootNode = node;
-            }
-            pushNode(node, key, mooveToEnd);
-            if (!mooveToEnd) {
-                next();
-            }
-        }
-
-        ConstIterator(const ConstIterator & oth)
-                : mRootNode(oth.mRootNode),
-                mCurrentNode(oth.mCurrentNode),
-                mCurrentPos(oth.mCurrentPos),
-                mKeyStack(oth.mKeyStack),
-                mCheckKeyLeft(oth.mCheckKeyLeft),
-                mCheckKeyRight(oth.mCheckKeyRight),
-                mEndReached(oth.mEndReached) {
-            if (!mKeyStack.empty()) {
-                mKeyValuePair = std::make_pair(&mKeyStack[0], oth.mKeyValuePair.second);
-            }
-        }
-
-        ConstIterator & operator=(const ConstIterator & oth) {
-            if (this != &oth) {
-                mRootNode = oth.mRootNode;
-                mCurrentNode = oth.mCurrentNode;
-                mCurrentPos = oth.mCurrentPos;
-                mKeyStack = oth.mKeyStack;
-                if (!mKeyStack.empty()) {
-                    mKeyValuePair = std::make_pair(&mKeyStack[0], oth.mKeyValuePair.second);
-                }
-                mCheckKeyLeft = oth.mCheckKeyLeft;
-                mCheckKeyRight = oth.mCheckKeyRight;
-                mEndReached = oth.mEndReached;
-            }
-            return *this;
-        }
-
-        const KeyValuePair &operator*() const {
-            return this->mKeyValuePair;
-        }
-
-        const KeyValuePair *operator->() const {
-            return &this->mKeyValuePair;
-        }
-
-        bool operator==(ConstIterator const &oth) const {
-            return this->equals(oth);
-        }
-
-        bool operator!=(ConstIterator const &oth) const {
-            return !(*this == oth);
-        }
-
-        ConstIterator operator++(int) {
-            ConstIterator iter = *this;
-            ++(*this);
-            return iter;
-        }
-
-        ConstIterator &operator++() {
-            this->next();
-            return *this;
-        }
-
-        ConstIterator operator--(int) {
-            ConstIterator iter = *this;
-            --(*this);
-            return iter;
-        }
-
-        ConstIterator &operator--() {
-            this->previous();
-            return *this;
-        }
-
-    protected:
-        friend class Node<T, V, Cmp, Items>;
-
-        const NodeClass * mRootNode;
-        const NodeClass * mCurrentNode;
-        ItemsContainerConstIter mCurrentPos;
-        std::vector<T> mKeyStack;
-        KeyValuePair mKeyValuePair;
-        bool mCheckKeyLeft;
-        bool mCheckKeyRight;
-        bool mEndReached;
-
-    protected:
-        void previous() {
-            if (!mCurrentNode->mItems.empty() && mCurrentPos == mCurrentNode->mItems.end()) {
-                --mCurrentPos;
-            }
-
-            bool newNode = false;
-            bool oldNode = false;
-
-            while (mEndReached || !isLeftEnd()) {
-                mEndReached = false;
-                ItemsContainerConstIter iterBegin = mCurrentNode->mItems.begin();
-                if (!mKeyStack.empty()) {
-                    if (mKeyStack.back() == mCurrentNode->endSymbol()) {
-                        mKeyStack.pop_back();
-                        mCurrentPos = mCurrentNode->mItems.begin();
-                        if (isLeftEnd()) {
-                            break;
-                        }
-                    }
-                }
-
-                if (!newNode && !mKeyStack.empty()) {
-                    if (mCheckKeyLeft) {
-                        mCurrentNode = mCurrentNode->parent();
-                        mCurrentPos = mCurrentNode->mItems.find(mKeyStack.back());
-                        iterBegin = mCurrentNode->mItems.begin();
-                        mKeyStack.pop_back();
-                        mCheckKeyLeft = false;
-                        if (mCurrentPos != iterBegin) {
-                            --mCurrentPos;
-                            oldNode = false;
-                        } else {
-                            oldNode = true;
-                        }
-                    } else {
-                        ItemsContainerConstIter iter = mCurrentNode->mItems.find(mCurrentNode->endSymbol());
-                        if (iter != mCurrentNode->mItems.end()) {
-                            mCurrentPos = iter;
-                            const NodeItemClass & item = *(const NodeItemClass *) * mCurrentPos;
-                            mKeyStack.push_back(item.get());
-                            mKeyValuePair.first = &(mKeyStack[0]);
-                            mKeyValuePair.second = &(((const EndNodeItemClass &)item).getValue());
-                            mCheckKeyLeft = true;
-                            return;
-                        } else {
-                            mCurrentNode = mCurrentNode->parent();
-                            mCurrentPos = mCurrentNode->mItems.find(mKeyStack.back());
-                            iterBegin = mCurrentNode->mItems.begin();
-                            mKeyStack.pop_back();
-                            mCheckKeyLeft = false;
-                            if (mCurrentPos != iterBegin) {
-                                --mCurrentPos;
-                                oldNode = false;
-                            } else {
-                                oldNode = true;
-                            }
-                        }
-                    }
-                }
-
-                newNode = false;
-                for (; mCurrentPos != iterBegin; --mCurrentPos) {
-                    if (*mCurrentPos) {
-                        const NodeItemClass &item = *(const NodeItemClass *) * mCurrentPos;
-                        if (item != mCurrentNode->endSymbol()) {
-                            mKeyStack.push_back(item.get());
-                            pushNode(item.getChilds(), 0, true);
-                            --mCurrentPos;
-                            newNode = true;
-                            break;
-                        }
-                    }
-                    oldNode = false;
-                }
-                if (!newNode && !oldNode) {
-					if (mCurrentPos != mCurrentNode->mItems.end()) {
-						if (*mCurrentPos) {
-					        const NodeItemClass &item = *(const NodeItemClass *) * mCurrentPos;
-				            if (item != mCurrentNode->endSymbol()) {
-			                    mKeyStack.push_back(item.get());
-		                        pushNode(item.getChilds(), 0, true);
-	                            --mCurrentPos;
-								newNode = true;
-							}
-						}
-					}
-				}
-
-            }
-            mCurrentPos = mCurrentNode->mItems.end();
-            mEndReached = true;
-        }
-
-        void next() {
-            while (!isEnd()) {
-                ItemsContainerConstIter iterEnd = mCurrentNode->mItems.end();
-
-                if (!mKeyStack.empty()) {
-                    if (mKeyStack.back() == mCurrentNode->endSymbol()) {
-                        mKeyStack.pop_back();
-                        mCurrentPos = mCurrentNode->mItems.begin();
-                    }
-                }
-
-                if (mCurrentPos == iterEnd && !mKeyStack.empty()) {
-                    mCurrentNode = mCurrentNode->parent();
-                    mCurrentPos = mCurrentNode->mItems.find(mKeyStack.back());
-                    ++mCurrentPos;
-                    iterEnd = mCurrentNode->mItems.end();
-                    mKeyStack.pop_back();
-                }
-
-                for (; mCurrentPos != iterEnd; ++mCurrentPos) {
-                    if (mCheckKeyRight) {
-                        mCheckKeyRight = false;
-                        ItemsContainerConstIter iter = mCurrentNode->mItems.find(mCurrentNode->endSymbol());
-                        if (iter != iterEnd) {
-                            mCurrentPos = iter;
-                            const NodeItemClass & item = *(const NodeItemClass *) * mCurrentPos;
-                            mKeyStack.push_back(item.get());
-                            mKeyValuePair.first = &(mKeyStack[0]);
-                            mKeyValuePair.second = &(((const EndNodeItemClass &)item).getValue());
-                            mCheckKeyLeft = true;
-                            return;
-                        }
-                    }
-
-                    if (*mCurrentPos) {
-                        const NodeItemClass &item = *(const NodeItemClass *) * mCurrentPos;
-                        if (item != mCurrentNode->endSymbol()) {
-                            mKeyStack.push_back(item.get());
-                            pushNode(item.getChilds());
-                            break;
-                        }
-                    }
-                }
-            }
-            mEndReached = true;
-        }
-
-        bool isEnd() const {
-            if (this->mRootNode == this->mCurrentNode &&
-                this->mCurrentPos == this->mCurrentNode->mItems.end()) {
-                return true;
-            }
-            return false;
-        }
-
-        bool isLeftEnd() const {
-            if (this->mRootNode == this->mCurrentNode &&
-                this->mCurrentPos == this->mCurrentNode->mItems.begin()) {
-                return true;
-            }
-            return false;
-        }
-
-        bool equals(const ConstIterator & oth) const {
-            if (this->isEnd() && oth.isEnd()) {
-                return true;
-            }
-
-            if (this->mCurrentNode == oth.mCurrentNode &&
-                    this->mCurrentPos  == oth.mCurrentPos) {
-                return true;
-            }
-
-            return false;
-        }
-
-        void pushNode(const NodeClass *node, const T * key = 0, bool mooveToEnd = false) {
-            mCurrentNode = node;
-            mCheckKeyLeft = false;
-            if (mooveToEnd) {
-                mCurrentPos = mCurrentNode->mItems.end();
-                mEndReached = true;
-                mCheckKeyRight = false;
-            } else {
-                if (key) {
-                    for (int i = 0; key[i] != node->endSymbol(); ++i) {
-                        mKeyStack.push_back(key[i]);
-                    }
-                }
-                mCurrentPos = node->mItems.begin();
-                mCheckKeyRight = true;
-            }
-        }
-    };
-
-    class Iterator : public ConstIterator
-    {
-    private:
-        typedef std::pair<const T *, V *> MutableKeyValuePair;
-        MutableKeyValuePair mMutableKeyValuePair;
-
-    private:
-        MutableKeyValuePair & getPair() {
-            mMutableKeyValuePair.first = this->mKeyValuePair.first;
-            mMutableKeyValuePair.second = const_cast<V *>(this->mKeyValuePair.second);
-            return this->mMutableKeyValuePair;
-        }
-
-    public:
-        Iterator(NodeClass *node, NodeClass *root, const T * key = 0, bool mooveToEnd = false)
-                : ConstIterator(node, root, key, mooveToEnd) {}
-
-        MutableKeyValuePair &operator*() {
-            return getPair();
-        }
-
-        MutableKeyValuePair *operator->() {
-            return &(getPair());
-        }
-
-        Iterator operator++(int) {
-            Iterator iter = *this;
-            ++(*this);
-            return iter;
-        }
-
-        Iterator &operator++() {
-            this->next();
-            return *this;
-        }
-
-        Iterator operator--(int) {
-            Iterator iter = *this;
-            --(*this);
-            return iter;
-        }
-
-        Iterator &operator--() {
-            this->previous();
-            return *this;
-        }
-    };
-
-private:
-    Node(Node const &);
-    Node &operator=(Node const &);
-
-    static void deleteItem(NodeItemClass *item) {
-        delete item;
-    }
-
-        
-    NodeClass * nodeWithKey(const T *key) {
-        return const_cast<NodeClass *>(const_cast<const NodeClass *>(this)->nodeWithKey(key));
-    }
-
-    const NodeClass * nodeWithKey(const T *key) const {
-        const NodeClass * node = nodeWithPrefix(key);
-        if (node) {
-            if (node->mItems.getItem(mEndSymbol)) {
-                return node;
-            }
-        }
-        return 0;
-    }
-
-    const NodeClass * nodeWithPrefix(const T *prefix) const {
-        int i=0;
-        const NodeClass * node = this;
-
-        while (node) {
-            if (prefix[i] == mEndSymbol) {
-                return node;
-            }
-            const NodeItemClass *item = node->mItems.getItem(prefix[i]);
-            if (!item) {
-                break;
-            }
-
-            node = item->getChilds();
-            ++i;
-        }
-        return 0;
-    }
-
-    bool erase(NodeClass * node, const T * key) {
-        bool erased = false;
-
-        if (node && key) {
-            bool finished = false;
-            int keyIndex = 0;
-            erased = true;
-
-            if (!keyIndex) {
-                while (key[keyIndex] != node->endSymbol()) {
-                    ++ keyIndex;
-                }
-            }
-
-            while (node && !finished && erased) {
-                ItemsContainerIter iterEnd = node->mItems.end();
-                int count = 0;
-
-                count = 0;
-                for (ItemsContainerIter iter = node->mItems.begin(); iter != iterEnd; ++iter) {
-                    if (*iter != 0) {
-                        ++count;
-                    }
-                }
-
-                if (count > 1) {
-                    erased = node->mItems.eraseItem(key[keyIndex]);
-                    finished = true;
-                } else if (count == 1) {
-                    erased = node->mItems.eraseItem(key[keyIndex]);
-                }
-
-                --keyIndex;
-                node = node->parent();
-            }
-
-        }
-        if (erased) {
-            --mSize;
-        }
-        return erased;
-    }
-
-public:
-    Node(const T &eSymbol, NodeClass * parent = 0)
-            : mItems(eSymbol),
-            mEndSymbol(eSymbol),
-            mSize(0),
-            mParent(parent) {}
-
-    ~Node() {
-        clear();
-    }
-
-    T endSymbol() const {
-        return mEndSymbol;
-    }
-
-    void clear() {
-        std::for_each(mItems.begin(), mItems.end(), deleteItem);
-        mItems.clear();
-        mSize = 0;
-    }
-
-    bool empty() const {
-        return size() == 0;
-    }
-
-    unsigned int size() const {
-        return mSize;
-    }
-
-    std::pair<Iterator, bool> insert(const T *key, V const &value) {
-        std::pair<Iterator, bool> result(end(), false);
-        int i = 0;
-        NodeClass * node = this;
-
-        while (true) {
-            std::pair<typename Items::Item *, bool> itemPair = node->mItems.insertItem(key[i]);
-            NodeItemClass *item = itemPair.first;
-            if (itemPair.second) {
-                result.first = Iterator(node, this, key);
-                break;
-            }
-            if (!item) {
-                break;
-            } else if (key[i] == mEndSymbol) {
-                ((EndNodeItemClass *)item)->set(key[i], value);
-                result.first = Iterator(node, this, key);
-                result.second = true;
-                ++mSize;
-                break;
-            } else {
-                node = item->getOrCreateChilds(node);
-            }
-            ++i;
-        }
-
-        return result;
-    }
-
-    bool erase(Iterator pos) {
-        if (pos.mCurrentNode && pos.mCurrentPos != pos.mCurrentNode->mItems.end()) {
-            return erase(const_cast<NodeClass *>(pos.mCurrentNode), pos->first);
-        }
-        return false;
-    }
-
-    bool erase(const T *key) {
-        NodeClass * node = nodeWithKey(key);
-        if (node) {
-            return erase(node, key);
-        }
-        return false;
-    }
-
-    const V *get(const T *key) const {
-        return const_cast<NodeClass *>(this)->get(key);
-    }
-
-    V *get(const T *key) {
-        NodeClass * node = nodeWithKey(key);
-        if (node) {
-            NodeItemClass *item = node->mItems.getItem(mEndSymbol);
-            return &(((EndNodeItemClass *)item)->getValue());
-        }
-        return 0;
-    }
-
-
-    bool hasKey(const T *key) const {
-        return get(key) != (V *)0;
-    }
-
-    const NodeClass * parent() const {
-        return mParent;
-    }
-
-    NodeClass * parent() {
-        return mParent;
-    }
-
-    ConstIterator begin() const {
-        return ConstIterator(this, this);
-    }
-
-    ConstIterator end() const {
-        return ConstIterator(this, this, 0, true);
-    }
-
-    Iterator begin() {
-        return Iterator(this, this);
-    }
-
-    Iterator end() {
-        return Iterator(this, this, 0, true);
-    }
-
-    ConstIterator find(const T *key) const {
-        NodeClass * node = const_cast<NodeClass *>(this)->nodeWithKey(key);
-        if (!node) {
-            return ConstIterator(this, this, 0, true);
-        } else {
-            return ConstIterator(node, this, key);
-        }
-    }
-
-    Iterator find(const T *key) {
-        NodeClass * node = this->nodeWithKey(key);
-        if (!node) {
-            return Iterator(this, this, 0, true);
-        } else {
-            return Iterator(node, this, key);
-        }
-    }
-
-    Iterator startsWith(const T *prefix) {
-        const NodeClass * node = const_cast<const NodeClass *>(this)->nodeWithPrefix(prefix);
-        if (!node) {
-            return Iterator(this, this, 0, true);
-        } else {
-            return Iterator(const_cast<NodeClass *>(node), const_cast<NodeClass *>(node), prefix);
-        }
-    }
-
-    ConstIterator startsWith(const T *prefix) const {
-        const NodeClass * node = nodeWithPrefix(prefix);
-        if (!node) {
-            return ConstIterator(this, this, 0, true);
-        } else {
-            return ConstIterator(node, node, prefix);
-        }
-    }
-
-private:
-    Items mItems;
-    const T mEndSymbol;
-    unsigned int mSize;
-    NodeClass * mParent;
-};
-
-/*!
- *
- */
-template <typename T> class SymbolToIndexMapper
-{
-public:
-    unsigned int operator()(const T & c) const {
-        return static_cast<unsigned int>(c);
-    }
-};
-
-/*!
- * @brief Container representing each node in the Trie.
- *
- *
- * With this class the container used for storing node item is STL vector.
- * Here each node will use a space propotional to Max.
- * For searching only constant time taken at each node.
- * @tparam T Type for each element in the key
- * @tparam V Type of the value that the key will be representing
- * @tparam Cmp Comparison functor
- * @tparam Max Maximum element that a Trie node can have
- */
-template < typename T,
-typename V,
-typename Cmp,
-int Max = 256,
-typename M = SymbolToIndexMapper<T> > class VectorItems
-{
-public:
-    typedef NodeItem<T, V, Cmp, VectorItems<T, V, Cmp, Max, M> > Item;
-    typedef std::vector<Item *> Items;
-    typedef typename Items::iterator iterator;
-    typedef typename Items::const_iterator const_iterator;
-    typedef Node<T, V, Cmp, VectorItems<T, V, Cmp, Max, M> > NodeClass;
-    typedef typename NodeClass::NodeItemClass NodeItemClass;
-    typedef typename NodeClass::EndNodeItemClass EndNodeItemClass;
-
-public:
-    VectorItems(T const &endSymbol)
-            : mEndSymbol(endSymbol),
-            mItems(Max, (Item *)0) {}
-
-    const_iterator find(const T & k) const {
-        const Item * item = getItem(k);
-        if (item) {
-            return mItems.begin() + mSymolToIndex(k);
-        }
-        return mItems.end();
-    }
-
-    iterator find(const T & k) {
-        const Item * item = getItem(k);
-        if (item) {
-            return mItems.begin() + mSymolToIndex(k);
-        }
-        return mItems.end();
-    }
-
-    iterator begin() {
-        return mItems.begin();
-    }
-
-    const_iterator begin() const {
-        return mItems.begin();
-    }
-
-    iterator end() {
-        return mItems.end();
-    }
-
-    const_iterator end() const {
-        return mItems.end();
-    }
-
-    void clear() {
-        std::fill(mItems.begin(), mItems.end(), (Item *)0);
-    }
-
-    bool empty() const {
-        return mItems.empty();
-    }
-
-    std::pair<Item *, bool> insertItem(T const &k) {
-        std::pair<Item *, bool> ret((Item *)0, false);
-        if (!getItem(k)) {
-            assignItem(k, createNodeItem(k));
-            ret.first = getItem(k);
-        } else {
-            ret.first = getItem(k);
-            if (k == mEndSymbol) {
-                ret.second = true;
-            }
-        }
-        return ret;
-    }
-
-    bool eraseItem(T const &k) {
-        Item * item = getItem(k);
-        if (item) {
-            delete item;
-            assignItem(k, (Item *)0);
-            return true;
-        } else {
-            return false;
-        }
-    }
-
-    Item *getItem(T const &k) {
-        return mItems[mSymolToIndex(k)];
-    }
-
-    const Item *getItem(T const &k) const {
-        return mItems[mSymolToIndex(k)];
-    }
-
-    void assignItem(T k, Item *i) {
-        mItems[mSymolToIndex(k)] = i;
-    }
-
-    NodeItemClass *createNodeItem(T const &k) {
-        if (k == mEndSymbol) {
-            return new EndNodeItemClass(mEndSymbol, k);
-        } else {
-            return new NodeItemClass(mEndSymbol, k);
-        }
-    }
-
-protected:
-    const T mEndSymbol;
-    Items mItems;
-    M mSymolToIndex;
-};
-
-/*!
- * @brief Container representing each node in the Trie.
- *
- *
- * With this class the container used for storing node item is STL set.
- * Here no extra space will used for storing node item.
- * For searching in each node the time taken is propotional to number of item in the node.
- * @tparam T Type for each element in the key
- * @tparam V Type of the value that the key will be representing
- * @tparam Cmp Comparison functor
- */
-template < typename T,
-typename V,
-typename Cmp > class SetItems
-{
-public:
-    typedef NodeItem<T, V, Cmp, SetItems<T, V, Cmp> > Item;
-    typedef std::set<Item *, NodeItemPtrCompare<T, V, Cmp, SetItems<T, V, Cmp> > > Items;
-    typedef typename Items::iterator iterator;
-    typedef typename Items::const_iterator const_iterator;
-    typedef Node<T, V, Cmp, SetItems<T, V, Cmp> > NodeClass;
-    typedef typename NodeClass::NodeItemClass NodeItemClass;
-    typedef typename NodeClass::EndNodeItemClass EndNodeItemClass;
-
-public:
-    SetItems(T const &endSymbol)
-            : mEndSymbol(endSymbol) {}
-
-    const_iterator find(const T & k) const {
-        return const_cast<SetItems<T, V, Cmp> *>(this)->find(k);
-    }
-
-    iterator find(const T & k) {
-        Item tmp(mEndSymbol, k);
-        return mItems.find(&tmp);
-    }
-
-    iterator begin() {
-        return mItems.begin();
-    }
-
-    const_iterator begin() const {
-        return mItems.begin();
-    }
-
-    iterator end() {
-        return mItems.end();
-    }
-
-    const_iterator end() const {
-        return mItems.end();
-    }
-
-    bool empty() const {
-        return mItems.empty();
-    }
-
-    void clear() {
-        mItems.clear();
-    }
-
-    std::pair<Item *, bool> insertItem(T const &k) {
-        std::pair<Item *, bool> ret((Item*)0, false);
-        Item tmp(mEndSymbol, k);
-        iterator iter = mItems.find(&tmp);
-        if (iter == mItems.end()) {
-            Item *v = createNodeItem(k);
-            mItems.insert(v);
-            ret.first = v;
-        } else {
-            ret.first = (Item *) * iter;
-            if (k == mEndSymbol) {
-                ret.second = true;
-            }
-        }
-        return ret;
-    }
-
-    bool eraseItem(T const &k) {
-        Item tmp(mEndSymbol, k);
-        iterator iter = mItems.find(&tmp);
-        if (iter != mItems.end()) {
-            delete *iter;
-            mItems.erase(iter);
-            return true;
-        } else {
-            return false;
-        }
-    }
-
-    const Item *getItem(T const &k) const {
-        return const_cast<SetItems *>(this)->getItem(k);
-    }
-
-    Item *getItem(T const &k) {
-        Item tmp(mEndSymbol, k);
-
-        iterator iter = mItems.find(&tmp);
-        if (iter == mItems.end()) {
-            return 0;
-        }
-        return (Item *)(*iter);
-    }
-
-    NodeItemClass *createNodeItem(T const &k) {
-        if (k == mEndSymbol) {
-            return new EndNodeItemClass(mEndSymbol, k);
-        } else {
-            return new NodeItemClass(mEndSymbol, k);
-        }
-    }
-
-protected:
-    const T mEndSymbol;
-    Items mItems;
-};
-
-/*!
- * @mainpage Simple Trie
- * @section intro_sec Introduction
- * This is an implementation of prefix Trie data structure. This implementation is in C++ and using template.
- * @section features Features
- * Following are the main operations provided by the Trie.
- * <ul>
- * <li>Adding key, value pair
- * <li>Removing an element by key
- * <li>Checking the existence of a key
- * <li>Retrieving value by key
- * <li>Find elements with common prefix
- * <li>Iterator
- * </ul>
- */
-
-
-/*!
- * @brief Trie main class
- * @tparam T Type for each element in the key
- * @tparam V Type of the value that the key will be representing
- * @tparam Cmp Comparison functor
- * @tparam Items The data structure that represents each node in the Trie.
- *               Items can be rtv::SetItems<T, V, Cmp> or rtv::VectorItems<T, V, Cmp, Max>,
- *               Max is the integer representing number of elements in each Trie node.
- *
- * @section usage_sec Usage of the Trie
- * @subsection usage_declaration Declarating the Trie
- * A Trie with key as chars and value as std::string can be declared as given below
- * @code
- * #include <string>
- * #include <trie.h>
- *
- * int main(int argc, char ** argv) {
- *
- *     rtv::Trie<char, std::string> dictionary('$');
- *
- *     return 0;
- * }
- * @endcode
- *
- * @subsection usage_population Populatiion and deletion from the Trie
- * Trie can be populated by using the Trie::insert method and element can be removed using Trie::erase.
- * @code
- * #include <trie.h>
- * #include <string>
- * #include <iostream>
- *
- * int main(int argc, char ** argv) {
- *
- *     rtv::Trie<char, std::string> dictionary('$');
- *
- *     // adding key value pair to the Trie
- *     if (dictionary.insert("karma$", "Destiny or fate, following as effect from cause").second) {
- *         std::cout << "added karma" << std::endl;
- *     }
- *
- *     // removing key from the Trie
- *     if (dictionary.erase("karma$")) {
- *         std::cout << "removed karma" << std::endl;
- *     }
- *
- *     return 0;
- * }
- *
- * @endcode
- * @subsection usage_retrieval Retrieval of Value
- * Value for a key can be retrieved using Trie::get method and
- * the existence of the key can be tested using Trie::hasKey method.
- * @code
- * #include <trie.h>
- * #include <string>
- * #include <iostream>
- *
- * int main(int argc, char ** argv) {
- *
- *     rtv::Trie<char, std::string> dictionary('$');
- *
- *     dictionary.insert("karma$", "Destiny or fate, following as effect from cause");
- *
- *     if (dictionary.hasKey("karma$")) {
- *         std::cout << "key karma found" << std::endl;
- *     }
- *     std::string * result = dictionary.get("karma$");
- *     if (result) {
- *         std::cout << result->c_str() << std::endl;
- *     }
- *
- *     return 0;
- * }
- * @endcode
- *
- * @subsection usage_searching Searching keys which have common prefix
- * Keys which begins with a specific charactars can be retrieved using Trie::startsWith method
- * @code
- * #include <trie.h>
- * #include <string>
- * #include <iostream>
- * #include <vector>
- *
- * int main(int argc, char ** argv) {
- *
- *     rtv::Trie<char, std::string> dictionary('\0');
- *
- *     dictionary.insert("karma", "Destiny or fate, following as effect from cause");
- *     rtv::Trie<char, std::string>::Iterator iter = dictionary.startsWith("kar");
- *
- *     for (; iter != dictionary.end(); ++iter) {
- *         std::cout << iter->first << " : " << iter->second->c_str() << std::endl;
- *     }
- *
- *     return 0;
- * }
- * @endcode
- *
- * @subsection usage_array_of_node Trie with each Node as an array
- * Here each node of the Trie is an array. The advantage is that the searching of a symbol in the array takes O(1) time (is constant time).
- * The disadvantage is that the array will have empty elements so the space used will more than actually required.
- *
- * @code
- *
- * #include <trie.h>
- * #include <string>
- * #include <iostream>
- * #include <vector>
- *
- * int main(int argc, char ** argv) {
- *
- *     // Here 256 is the size of array in each node
- *     rtv::Trie<char, std::string, std::less<char>,
- *               rtv::VectorItems<char, std::string, std::less<char>, 256> > dictionary('$');
- *
- *     return 0;
- * }
- * @endcode
- *
- * @subsection usage_vector_item Efficient use of Trie for alphabets
- * Below example shows how to use Trie to operate on alphabets efficiently.
- * Here VectorItems is used to store alphabets with size of 28 (26 alphabets + space + end symbol).
- *
- * @code
- * #include <trie.h>
- * #include <string>
- * #include <iostream>
- * #include <vector>
- * #include <cctype>
- *
- * class TrieCaseInsensitiveCompare
- * {
- * public:
- *     bool operator()(char v1, char v2) {
- *         int i1 = std::tolower(v1);
- *         int i2 = std::tolower(v2);
- *         return i1 < i2;
- *     }
- * };
- *
- * // key to vector index converter
- * // case insensitive and includes alphabets, space and end symbol
- * class AlphaToIndex
- * {
- * public:
- *     unsigned int operator()(const char & c) const {
- *         unsigned int index = 0;
- *         if (c == ' ') {
- *             index = 27;
- *         } else if (c >= 'A' && c <= 'Z') {
- *             index = c - 'A' + 1;
- *         } else if (c >= 'a' && c <= 'z') {
- *             index = c - 'a' + 1;
- *         }
- *         return index;
- *     }
- * };
- *
- * int main(int argc, char ** argv) {
- *
- *     rtv::Trie<char, std::string,
- *               TrieCaseInsensitiveCompare,
- *               rtv::VectorItems<char, std::string, TrieCaseInsensitiveCompare, 28, AlphaToIndex>
- *               > dictionary('\0');
- *
- *     // adding key value pair to the Trie
- *     if (dictionary.insert("karma", "Destiny or fate, following as effect from cause").second) {
- *         std::cout << "added karma" << std::endl;
- *     }
- *
- *     // removing key from the Trie
- *     if (dictionary.erase("karma")) {
- *         std::cout << "removed karma" << std::endl;
- *     }
- *
- *     return 0;
- * }
- *
- * @endcode
- *
- * @subsection usage_set_of_node Trie with each Node as a set
- * Here each node will be an ordered set.
- * Here there will be no extra usage of space but search for a symbol in the node takes logarithmic time.
- * Trie with this feature can also be used for caseinsensitive symbol handling.
- * @code
- *
- * #include <trie.h>
- * #include <string>
- * #include <iostream>
- * #include <set>
- *
- * int main(int argc, char ** argv) {
- *
- *     rtv::Trie<char, std::string, std::less<char>,
- *               rtv::SetItems<char, std::string, std::less<char> > > dictionary('$');
- *
- *     return 0;
- * }
- * @endcode
- * @subsection usage_iterator Using Trie::Iterator
- * Trie iterator can be used the same way as STL iterator.
- * Key and value can be accessed from iterator using first and secod member.
- * first is vector of key characters and second is a pointer to the value.
- * @code
- * #include <trie.h>
- * #include <string>
- * #include <iostream>
- * #include <vector>
- *
- * int main(int argc, char ** argv) {
- *
- *     rtv::Trie<char, std::string> dictionary('\0');
- *
- *     dictionary.insert("karma$", "Destiny or fate, following as effect from cause");
- *
- *     rtv::Trie<char, std::string>::Iterator iter = dictionary.begin();
- *     rtv::Trie<char, std::string>::Iterator iend = dictionary.end();
- *
- *     for (; iter != iend; ++iter) {
- *
- *         std::cout << iter->first  << " " << iter->second->c_str() << std::endl;
- *     }
- *
- *     return 0;
- * }
- * @endcode
- */
-template < typename T,
-typename V,
-typename Cmp = std::less<T>,
-typename Items = SetItems<T, V, Cmp> > class Trie
-{
-public:
-    typedef typename Node<T, V, Cmp, Items>::Iterator Iterator;
-    typedef typename Node<T, V, Cmp, Items>::ConstIterator ConstIterator;
-
-public:
-    /*!
-     * @param endSymbol The symbol which marks the end of key input
-     */
-    Trie(const T &endSymbol)
-            : mRoot(endSymbol) {}
-
-    /*!
-     * Add a key with value in to the Trie
-     * @param key Key which should be inserted, should be terminated by 'end' symbol
-     * @param value The value that is to be set with the key
-     * @return An std::pair with pair::first set to the Iterator points to the element and pair::second to true is key is newly inserted, false otherwise
-     */
-    std::pair<Iterator, bool> insert(const T *key, V const &value) {
-        return mRoot.insert(key, value);
-    }
-
-    /*!
-     * Remove the entry with the given key from the Trie
-     * @param key Key which should be erased, should be terminated by 'end' symbol
-     * @return true if the given key is erased from the Trie, false otherwise
-     */
-    bool erase(const T *key) {
-        return mRoot.erase(key);
-    }
-
-    /*!
-     * Remove the entry with the given key from the Trie
-     * @param pos Iterator pointing to a single element to be removed from the Trie
-     * @return true if the given key is erased form the Trie, false otherwise
-     */
-    bool erase(Iterator pos) {
-        return mRoot.erase(pos);
-    }
-
-    /*!
-     * Retrieves the value for the given key
-     * @param key Key to be searched for, should be terminated by 'end' symbol
-     * @return Constant pointer to value for the given key, 0 on failure
-     */
-    const V *get(const T *key) const {
-        return mRoot.get(key);
-    }
-
-    /*!
-     * Retrieves the value for the given key
-     * @param key Key to be searched for, should be terminated by 'end' symbol
-     * @return Pointer to value for the given key, 0 on failure
-     */
-    V *get(const T *key) {
-        return mRoot.get(key);
-    }
-
-    /*!
-     * Retrieves the value for the given key,
-     * If key does not match the key of any element in the Trie,
-     * the function inserts a new element with that key and returns a reference to its mapped value
-     * @param key Key to be searched for, should be terminated by 'end' symbol
-     * @return Reference to value for the given key
-     */
-    V &operator[](const T *key) {
-        return *(insert(key, V()).first->second);
-    }
-
-    /*!
-     * Checks whether the given key is present in the Trie
-     * @param key Key to be searched for, should be terminated by 'end' symol
-     * @return true if the key is present
-     */
-    bool hasKey(const T *key) const {
-        return mRoot.hasKey(key);
-    }
-
-    /*!
-     * Test whether Trie is empty
-     * @return true if the Trie size is 0, false otherwise
-     */
-    bool empty() const {
-        return mRoot.empty();
-    }
-
-    /*!
-     * Returns the number of elements in the Trie
-     * @return Number of key value pair in the Trie
-     */
-    unsigned int size() const {
-        return mRoot.size();
-    }
-
-    /*!
-     * All the elements in the Trie are dropped, leaving the Trie with a size of 0.
-     */
-    void clear() {
-        mRoot.clear();
-    }
-
-    /*!
-     * Retrieves Iterator to the elements with common prefix
-     * @param prefix Part of the key which should be searched, should be terminated by 'end' symbol
-     * @return Iterator to the elements with prefix specified in 'prefix'
-     */
-    Iterator startsWith(const T *prefix) {
-        return mRoot.startsWith(prefix);
-    }
-
-    /*!
-     * Retrieves ConstIterator to the elements with common prefix
-     * @param prefix Part of the key which should be searched, should be terminated by 'end' symbol
-     * @return ConstIterator to the elements with prefix specified in 'prefix'
-     */
-    ConstIterator startsWith(const T *prefix) const {
-        return mRoot.startsWith(prefix);
-    }
-
-    /*!
-     * Retrieves the end symbol
-     * @return end symbol
-     */
-    T endSymbol() const {
-        return mRoot.endSymbol();
-    }
-
-    /*!
-     * Returns an iterator referring to the first element in the Trie
-     * @return An iterator to the first element in the Trie
-     */
-    Iterator begin() {
-        return mRoot.begin();
-    }
-
-    /*!
-     * Returns an iterator referring to the past-the-end element in the Trie
-     * @return An iterator to the element past the end of the Trie
-     */
-    Iterator end() {
-        return mRoot.end();
-    }
-
-    /*!
-     * Searches the Trie for an element with 'key' as key
-     * @param key Key to be searched for, should be terminated by 'end' symbol
-     * @return Iterator to the element with key 'key' if found, otherwise an Iterator to Trie::end
-     */
-    Iterator find(const T *key) {
-        return mRoot.find(key);
-    }
-
-    /*!
-     * Searches the Trie for an element with 'key' as key
-     * @param key Key to be searched for, should be terminated by 'end' symbol
-     * @return ConstIterator to the element with key 'key' if found, otherwise an ConstIterator to Trie::end
-     */
-    ConstIterator find(const T *key) const {
-        return mRoot.find(key);
-    }
-
-    /*!
-     * Returns an constant iterator referring to the first element in the Trie
-     * @return An constant iterator to the first element in the Trie
-     */
-    ConstIterator begin() const {
-        return mRoot.begin();
-    }
-
-    /*!
-     * Returns an constant iterator referring to the past-the-end element in the Trie
-     * @return An constant iterator to the element past the end of the Trie
-     */
-    ConstIterator end() const {
-        return mRoot.end();
-    }
-
-private:
-    Trie(Trie const &);
-    Trie &operator=(Trie const &);
-
-private:
-    Node<T, V, Cmp, Items> mRoot;
-};
-
-}
-
-#endif
+/*
+ * Copyright (c) 2012, Ranjith TV
+ * All rights reserved.
+ *
+ * Licensed under the BSD 3-Clause ("BSD New" or "BSD Simplified") license.
+ * You may obtain a copy of the License at
+ *
+ * http://www.opensource.org/licenses/BSD-3-Clause
+ *
+ */
+
+#ifndef TRIE_H
+#define TRIE_H
+
+#include <vector>
+#include <set>
+#include <string>
+#include <algorithm>
+#include <new>
+#include <memory>
+#include <cstddef>
+#include <cstdio>
+
+#if __cplusplus >= 201103L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201103L)
+#define RTV_HAS_CXX11
+#include <utility>
+#include <type_traits>
+#include <map>
+#include <iterator>
+#include <thread>
+#include <atomic>
+#include <exception>
+#endif
+
+#if __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+#define RTV_HAS_STRING_VIEW
+#include <string_view>
+#endif
+
+#if defined(__GNUC__)
+#define RTV_PREFETCH(address) __builtin_prefetch(address)
+#elif defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#include <xmmintrin.h>
+#define RTV_PREFETCH(address) _mm_prefetch((const char *)(address), _MM_HINT_T0)
+#else
+#define RTV_PREFETCH(address)
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RTV_HAS_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(RTV_HAS_SSE2) && defined(__AVX2__)
+#define RTV_HAS_AVX2
+#include <immintrin.h>
+#endif
+
+namespace rtv
+{
+
+template < typename T,
+typename V,
+typename Cmp,
+typename Items > class Node;
+
+template < typename T,
+typename V,
+typename Cmp,
+typename Items > class NodeItem
+{
+private:
+    typedef Node<T, V, Cmp, Items> NodeClass;
+    typedef NodeItem<T, V, Cmp, Items> NodeItemClass;
+
+public:
+    explicit NodeItem(T const &key)
+            : mKey(key),
+            mChilds(0) {}
+
+    bool operator<(NodeItemClass const &oth) const {
+        return Cmp()(this->mKey, oth.mKey);
+    }
+
+    bool operator<(T const &key) const {
+        return Cmp()(this->mKey, key);
+    }
+
+    bool operator==(T const &key) const {
+        return !Cmp()(this->mKey, key) && !Cmp()(key, this->mKey);
+    }
+
+    bool operator==(NodeItemClass const &oth) const {
+        return !Cmp()(this->mKey, oth.mKey) && !Cmp()(oth.mKey, this->mKey);
+    }
+
+    bool operator!=(T const &key) const {
+        return !((*this) == key);
+    }
+
+    bool operator!=(NodeItemClass const &oth) const {
+        return !((*this) == oth);
+    }
+
+    void set(T const &key) {
+        mKey = key;
+    }
+
+    const T &get() const {
+        return mKey;
+    }
+
+    const NodeClass *getChilds() const {
+        return mChilds;
+    }
+
+    NodeClass *getChilds() {
+        return mChilds;
+    }
+
+    NodeClass *getOrCreateChilds(NodeClass * parent) {
+        createChilds(parent);
+        return mChilds;
+    }
+
+    void setChilds(NodeClass *childs) {
+        mChilds = childs;
+    }
+
+private:
+    void createChilds(NodeClass * parent) {
+        if (!mChilds) {
+            mChilds = NodeClass::createNode(parent->endSymbol(), parent);
+        }
+    }
+
+    NodeItem(NodeItem const &);
+    NodeItem &operator=(NodeItem const &);
+
+private:
+    T mKey;
+    NodeClass *mChilds;
+};
+
+template < typename T,
+typename V,
+typename Cmp,
+typename Items > class NodeItemPtrCompare
+{
+private:
+    typedef NodeItem<T, V, Cmp, Items> NodeItemClass;
+
+public:
+    bool operator()(const NodeItemClass *v1, const NodeItemClass *v2) const {
+        return *v1 < *v2;
+    }
+};
+
+/*!
+ * @brief Number of nodes, items and values at each depth of a Trie, made by Trie::stats.
+ *
+ * The depth of a node is the number of key symbols above it, as for rtv::HybridItems.
+ * The numbers do not depend on the Items of the Trie, so they tell how many bytes rtv::HybridItems
+ * would take with each cutoff depth, above which its nodes are dense arrays and below which they are sparse.
+ * report prints the levels and the bytes for every cutoff, and bestCutoff gives the cutoff taking the least.
+ * The bytes are those asked from the allocator, without the overhead of the heap.
+ */
+class TrieStats
+{
+public:
+    struct Level {
+        Level()
+                : mNodes(0),
+                mItems(0),
+                mValues(0),
+                mLabels(0),
+                mLabelSymbols(0) {}
+
+        std::size_t mNodes;
+        std::size_t mItems;
+        std::size_t mValues;
+        // number of nodes having a label and the symbols of their labels, only in a compressed Trie
+        std::size_t mLabels;
+        std::size_t mLabelSymbols;
+        // number of nodes at the depth having each number of items
+        std::vector<std::size_t> mFanouts;
+    };
+
+    TrieStats()
+            : mKeys(0) {}
+
+    // Counts a node at depth having items items and a label of labelSize symbols
+    void add(unsigned int depth, unsigned int items, bool hasValue, std::size_t labelSize) {
+        if (depth >= mLevels.size()) {
+            mLevels.resize(depth + 1);
+        }
+        Level &level = mLevels[depth];
+        ++level.mNodes;
+        level.mItems += items;
+        if (hasValue) {
+            ++level.mValues;
+            ++mKeys;
+        }
+        if (labelSize) {
+            ++level.mLabels;
+            level.mLabelSymbols += labelSize;
+        }
+        if (items >= level.mFanouts.size()) {
+            level.mFanouts.resize(items + 1, 0);
+        }
+        ++level.mFanouts[items];
+    }
+
+    const std::vector<Level> &levels() const {
+        return mLevels;
+    }
+
+    std::size_t keys() const {
+        return mKeys;
+    }
+
+    // Bytes taken by the nodes at depth with the dense or the sparse layout of Hybrid
+    template <typename Hybrid>
+    std::size_t levelBytes(unsigned int depth, bool dense) const {
+        std::size_t bytes = 0;
+        const Level &level = mLevels[depth];
+        const std::vector<std::size_t> &fanouts = level.mFanouts;
+        for (std::size_t items = 0; items < fanouts.size(); ++items) {
+            if (fanouts[items]) {
+                bytes += fanouts[items] * Hybrid::nodeBytes(dense, (unsigned int)items);
+            }
+        }
+        return bytes + level.mValues * Hybrid::valueBytes() + Hybrid::labelBytes(level.mLabels, level.mLabelSymbols);
+    }
+
+    // Bytes taken by all the nodes with Hybrid having dense nodes above the cutoff depth
+    template <typename Hybrid>
+    std::size_t hybridBytes(unsigned int cutoff) const {
+        std::size_t bytes = 0;
+        for (unsigned int depth = 0; depth < mLevels.size(); ++depth) {
+            bytes += levelBytes<Hybrid>(depth, depth < cutoff);
+        }
+        return bytes;
+    }
+
+    // The cutoff depth for which Hybrid takes the least bytes, the smallest one of those taking the same
+    template <typename Hybrid>
+    unsigned int bestCutoff() const {
+        unsigned int best = 0;
+        std::size_t bestBytes = hybridBytes<Hybrid>(0);
+        for (unsigned int cutoff = 1; cutoff <= mLevels.size(); ++cutoff) {
+            std::size_t bytes = hybridBytes<Hybrid>(cutoff);
+            if (bytes < bestBytes) {
+                best = cutoff;
+                bestBytes = bytes;
+            }
+        }
+        return best;
+    }
+
+    // Prints the levels, then the bytes per key of Hybrid for each cutoff depth and the best cutoff
+    template <typename Hybrid>
+    void report(std::FILE *out) const {
+        std::fprintf(out, "%6s %12s %12s %12s %14s %14s\n", "depth", "nodes", "items", "keys", "dense bytes",
+                     "sparse bytes");
+        for (unsigned int depth = 0; depth < mLevels.size(); ++depth) {
+            const Level &level = mLevels[depth];
+            std::fprintf(out, "%6u %12lu %12lu %12lu %14lu %14lu\n", depth, (unsigned long)level.mNodes,
+                         (unsigned long)level.mItems, (unsigned long)level.mValues,
+                         (unsigned long)levelBytes<Hybrid>(depth, true),
+                         (unsigned long)levelBytes<Hybrid>(depth, false));
+        }
+        std::fprintf(out, "%6s %14s %12s\n", "cutoff", "bytes", "bytes/key");
+        for (unsigned int cutoff = 0; cutoff <= mLevels.size(); ++cutoff) {
+            std::size_t bytes = hybridBytes<Hybrid>(cutoff);
+            std::fprintf(out, "%6u %14lu %12.1f\n", cutoff, (unsigned long)bytes,
+                         mKeys ? (double)bytes / mKeys : 0.0);
+        }
+        std::fprintf(out, "best cutoff %u\n", bestCutoff<Hybrid>());
+    }
+
+private:
+    std::vector<Level> mLevels;
+    std::size_t mKeys;
+};
+
+/*!
+ * @brief Visitor of the keys which are prefixes of a key, keeps the last and so the longest one.
+ *
+ * Used by longestPrefixOf of the Tries.
+ */
+template <typename V> class LongestPrefix
+{
+public:
+    LongestPrefix()
+            : mResult(0, (const V *)0) {}
+
+    void operator()(std::size_t length, const V &value) {
+        mResult.first = length;
+        mResult.second = &value;
+    }
+
+    std::pair<std::size_t, const V *> mResult;
+};
+
+/*!
+ * @brief Symbols on the edge leading to a node of a compressed Trie, following the symbol of the item.
+ *
+ * Only a pointer is kept in the node, to a single block from the allocator of the Trie holding the number
+ * of symbols followed by the symbols. The nodes of a Trie without path compression do not pay for the labels.
+ * The block is given back by release, the node calls it as it knows the allocator.
+ * @tparam T Type of the symbols
+ * @tparam A Allocator of the nodes
+ */
+template < typename T,
+typename A > class NodeLabel
+{
+public:
+    typedef const T *const_iterator;
+
+    NodeLabel()
+            : mBlock(0) {}
+
+    // Bytes asked from the allocator for labels holding symbols symbols in all
+    static std::size_t allocatedBytes(std::size_t labels, std::size_t symbols) {
+        return labels * sizeof(std::size_t) + symbols * sizeof(T);
+    }
+
+    std::size_t size() const {
+        return mBlock ? *mBlock : 0;
+    }
+
+    bool empty() const {
+        return !mBlock;
+    }
+
+    const T &operator[](std::size_t i) const {
+        return symbols()[i];
+    }
+
+    const_iterator begin() const {
+        return mBlock ? symbols() : 0;
+    }
+
+    const_iterator end() const {
+        return begin() + size();
+    }
+
+    // Replaces the symbols, first and last may point in to the label
+    void assign(A *allocator, const_iterator first, const_iterator last) {
+        std::size_t *block = 0;
+        std::size_t size = last - first;
+        if (size) {
+            block = static_cast<std::size_t *>(allocator->allocate(allocatedBytes(1, size)));
+            *block = size;
+            std::uninitialized_copy(first, last, reinterpret_cast<T *>(block + 1));
+        }
+        release(allocator);
+        mBlock = block;
+    }
+
+    // Removes the first count symbols
+    void eraseFront(A *allocator, std::size_t count) {
+        assign(allocator, begin() + count, end());
+    }
+
+    // Destroys the symbols and gives their block back to allocator
+    void release(A *allocator) {
+        if (mBlock) {
+            std::size_t size = *mBlock;
+            for (std::size_t i = 0; i < size; ++i) {
+                symbols()[i].~T();
+            }
+            allocator->deallocate(mBlock, allocatedBytes(1, size));
+            mBlock = 0;
+        }
+    }
+
+    void swap(NodeLabel &oth) {
+        std::swap(mBlock, oth.mBlock);
+    }
+
+private:
+    NodeLabel(NodeLabel const &);
+    NodeLabel &operator=(NodeLabel const &);
+
+    T *symbols() const {
+        return reinterpret_cast<T *>(mBlock + 1);
+    }
+
+private:
+    std::size_t *mBlock;
+};
+
+/*!
+ * @brief Storage for the value of the key ending at a node.
+ *
+ * A value no larger than a pointer is kept in the node itself. A larger value is allocated from
+ * the allocator of the Trie and the node keeps only a pointer, so that the nodes without a value
+ * do not pay for its size. The value is constructed and destroyed by the node, which knows whether it has one.
+ * @tparam V Type of the value
+ * @tparam A Allocator of the nodes
+ * @tparam Inline Whether the value is kept in the node
+ */
+template < typename V,
+typename A,
+bool Inline = (sizeof(V) <= sizeof(void *)) > class NodeValue
+{
+private:
+#ifdef RTV_HAS_CXX11
+    typedef typename std::aligned_storage<sizeof(V), std::alignment_of<V>::value>::type Storage;
+#else
+    // aligned as the most aligned of the common types
+    union Storage {
+        char mBytes[sizeof(V)];
+        double mDouble;
+        long mLong;
+        void *mPointer;
+    };
+#endif
+
+public:
+    // Bytes asked from the allocator for a value
+    static std::size_t allocatedBytes() {
+        return 0;
+    }
+
+    // Memory for the value to be constructed in
+    void *allocate(A *) {
+        return &mStorage;
+    }
+
+    // Gives back the memory of a value which is destroyed
+    void deallocate(A *) {}
+
+    V *get() {
+        return reinterpret_cast<V *>(&mStorage);
+    }
+
+    const V *get() const {
+        return reinterpret_cast<const V *>(&mStorage);
+    }
+
+    // Exchanges the values, has and othHas tell which of them are constructed
+    void swap(NodeValue &oth, bool has, bool othHas) {
+        if (has && othHas) {
+            std::swap(*get(), *oth.get());
+        } else if (has) {
+#ifdef RTV_HAS_CXX11
+            new (&oth.mStorage) V(std::move(*get()));
+#else
+            new (&oth.mStorage) V(*get());
+#endif
+            get()->~V();
+        } else if (othHas) {
+            oth.swap(*this, othHas, has);
+        }
+    }
+
+private:
+    Storage mStorage;
+};
+
+template < typename V,
+typename A > class NodeValue<V, A, false>
+{
+public:
+    NodeValue()
+            : mValue(0) {}
+
+    static std::size_t allocatedBytes() {
+        return sizeof(V);
+    }
+
+    void *allocate(A *allocator) {
+        mValue = static_cast<V *>(allocator->allocate(sizeof(V)));
+        return mValue;
+    }
+
+    void deallocate(A *allocator) {
+        allocator->deallocate(mValue, sizeof(V));
+        mValue = 0;
+    }
+
+    V *get() {
+        return mValue;
+    }
+
+    const V *get() const {
+        return mValue;
+    }
+
+    // The values are exchanged by their pointers
+    void swap(NodeValue &oth, bool, bool) {
+        std::swap(mValue, oth.mValue);
+    }
+
+private:
+    V *mValue;
+};
+
+template < typename T,
+typename V,
+typename Cmp,
+typename Items > class Node
+{
+public:
+    typedef NodeItem<T, V, Cmp, Items> NodeItemClass;
+    typedef Node<T, V, Cmp, Items> NodeClass;
+    typedef typename Items::Allocator Allocator;
+
+    // Length of a key which is terminated by the end symbol
+    static const std::size_t npos = static_cast<std::size_t>(-1);
+
+private:
+    typedef typename Items::iterator ItemsContainerIter;
+    typedef typename Items::const_iterator ItemsContainerConstIter;
+
+public:
+
+    /*!
+     * @brief Iterates the elements under the root node, the value of a node before the nodes below it.
+     *
+     * The iterator stands at the value of a node or, past the last element, at the end of the items of the root.
+     */
+    class ConstIterator
+    {
+    protected:
+        typedef std::pair<const T *, const V *> KeyValuePair;
+
+    public:
+        ConstIterator(const NodeClass *node, const NodeClass * root, const T * key = 0, bool mooveToEnd = false,
+                      std::size_t length = NodeClass::npos)
+                : mRootNode(root ? root : node),
+                  mCurrentNode(node),
+                  mCurrentPos(node->mItems.begin()),
+                  mKeyValuePair((const T *)0, (const V *)0),
+                  mAtValue(false) {
+            if (mooveToEnd) {
+                mCurrentPos = node->mItems.end();
+                return;
+            }
+            if (key) {
+                for (std::size_t i = 0; i < length && key[i] != node->endSymbol(); ++i) {
+                    mKeyStack.push_back(key[i]);
+                }
+            }
+            if (!settle()) {
+                next();
+            }
+        }
+
+        ConstIterator(const ConstIterator & oth)
+                : mRootNode(oth.mRootNode),
+                mCurrentNode(oth.mCurrentNode),
+                mCurrentPos(oth.mCurrentPos),
+                mKeyStack(oth.mKeyStack),
+                mKeyValuePair(oth.mKeyValuePair),
+                mAtValue(oth.mAtValue) {
+            relink();
+        }
+
+        ConstIterator & operator=(const ConstIterator & oth) {
+            if (this != &oth) {
+                mRootNode = oth.mRootNode;
+                mCurrentNode = oth.mCurrentNode;
+                mCurrentPos = oth.mCurrentPos;
+                mKeyStack = oth.mKeyStack;
+                mKeyValuePair = oth.mKeyValuePair;
+                mAtValue = oth.mAtValue;
+                relink();
+            }
+            return *this;
+        }
+
+        const KeyValuePair &operator*() const {
+            return this->mKeyValuePair;
+        }
+
+        const KeyValuePair *operator->() const {
+            return &this->mKeyValuePair;
+        }
+
+        bool operator==(ConstIterator const &oth) const {
+            return this->equals(oth);
+        }
+
+        bool operator!=(ConstIterator const &oth) const {
+            return !(*this == oth);
+        }
+
+        ConstIterator operator++(int) {
+            ConstIterator iter = *this;
+            ++(*this);
+            return iter;
+        }
+
+        ConstIterator &operator++() {
+            this->next();
+            return *this;
+        }
+
+        ConstIterator operator--(int) {
+            ConstIterator iter = *this;
+            --(*this);
+            return iter;
+        }
+
+        ConstIterator &operator--() {
+            this->previous();
+            return *this;
+        }
+
+    protected:
+        friend class Node<T, V, Cmp, Items>;
+
+        const NodeClass * mRootNode;
+        const NodeClass * mCurrentNode;
+        // Next item to visit in the current node, unused while the iterator stands at a value
+        ItemsContainerConstIter mCurrentPos;
+        // Symbols from the root of the Trie to the current node, followed by the end symbol at a value
+        std::vector<T> mKeyStack;
+        KeyValuePair mKeyValuePair;
+        bool mAtValue;
+
+    protected:
+        void previous() {
+            if (mAtValue) {
+                leaveValue();
+                if (mCurrentNode == mRootNode) {
+                    // the value of the root is the first element, before it is the end
+                    mCurrentPos = mCurrentNode->mItems.end();
+                    return;
+                }
+                climb();
+            }
+
+            while (true) {
+                ItemsContainerConstIter iterBegin = mCurrentNode->mItems.begin();
+                bool found = false;
+                while (!found && mCurrentPos != iterBegin) {
+                    --mCurrentPos;
+                    found = *mCurrentPos && (*mCurrentPos)->getChilds();
+                }
+                if (found) {
+                    descend(*mCurrentPos, true);
+                } else if (settle()) {
+                    return;
+                } else if (mCurrentNode == mRootNode) {
+                    mCurrentPos = mCurrentNode->mItems.end();
+                    return;
+                } else {
+                    climb();
+                }
+            }
+        }
+
+        void next() {
+            if (mAtValue) {
+                leaveValue();
+                mCurrentPos = mCurrentNode->mItems.begin();
+            }
+
+            while (true) {
+                ItemsContainerConstIter iterEnd = mCurrentNode->mItems.end();
+                while (mCurrentPos != iterEnd && !(*mCurrentPos && (*mCurrentPos)->getChilds())) {
+                    ++mCurrentPos;
+                }
+                if (mCurrentPos != iterEnd) {
+                    descend(*mCurrentPos, false);
+                    if (settle()) {
+                        return;
+                    }
+                } else if (mCurrentNode == mRootNode) {
+                    return;
+                } else {
+                    climb();
+                    ++mCurrentPos;
+                }
+            }
+        }
+
+        bool equals(const ConstIterator & oth) const {
+            if (!mAtValue || !oth.mAtValue) {
+                return !mAtValue && !oth.mAtValue;
+            }
+            return mCurrentNode == oth.mCurrentNode;
+        }
+
+        void relink() {
+            if (!mKeyStack.empty()) {
+                mKeyValuePair.first = &mKeyStack[0];
+            }
+        }
+
+        // Stops at the value of the current node, false if it has none
+        bool settle() {
+            if (!mCurrentNode->hasValue()) {
+                return false;
+            }
+            mKeyStack.push_back(mCurrentNode->endSymbol());
+            mKeyValuePair.first = &mKeyStack[0];
+            mKeyValuePair.second = &mCurrentNode->value();
+            mAtValue = true;
+            return true;
+        }
+
+        void leaveValue() {
+            mKeyStack.pop_back();
+            mAtValue = false;
+        }
+
+        // Moves to the node below the item, before its first item or after its last
+        void descend(const NodeItemClass *item, bool atEnd) {
+            mKeyStack.push_back(item->get());
+            mCurrentNode = item->getChilds();
+            mKeyStack.insert(mKeyStack.end(), mCurrentNode->mLabel.begin(), mCurrentNode->mLabel.end());
+            mCurrentPos = atEnd ? mCurrentNode->mItems.end() : mCurrentNode->mItems.begin();
+        }
+
+        // Moves up to the parent node, at the item leading to the current node
+        void climb() {
+            mKeyStack.resize(mKeyStack.size() - mCurrentNode->mLabel.size());
+            mCurrentNode = mCurrentNode->parent();
+            mCurrentPos = mCurrentNode->mItems.find(mKeyStack.back());
+            mKeyStack.pop_back();
+        }
+    };
+
+    class Iterator : public ConstIterator
+    {
+    private:
+        typedef std::pair<const T *, V *> MutableKeyValuePair;
+        MutableKeyValuePair mMutableKeyValuePair;
+
+    private:
+        MutableKeyValuePair & getPair() {
+            mMutableKeyValuePair.first = this->mKeyValuePair.first;
+            mMutableKeyValuePair.second = const_cast<V *>(this->mKeyValuePair.second);
+            return this->mMutableKeyValuePair;
+        }
+
+    public:
+        Iterator(NodeClass *node, NodeClass *root, const T * key = 0, bool mooveToEnd = false,
+                 std::size_t length = NodeClass::npos)
+                : ConstIterator(node, root, key, mooveToEnd, length) {}
+
+        MutableKeyValuePair &operator*() {
+            return getPair();
+        }
+
+        MutableKeyValuePair *operator->() {
+            return &(getPair());
+        }
+
+        Iterator operator++(int) {
+            Iterator iter = *this;
+            ++(*this);
+            return iter;
+        }
+
+        Iterator &operator++() {
+            this->next();
+            return *this;
+        }
+
+        Iterator operator--(int) {
+            Iterator iter = *this;
+            --(*this);
+            return iter;
+        }
+
+        Iterator &operator--() {
+            this->previous();
+            return *this;
+        }
+    };
+
+private:
+    Node(Node const &);
+    Node &operator=(Node const &);
+
+    NodeClass * nodeWithKey(const T *key, std::size_t length) {
+        return const_cast<NodeClass *>(const_cast<const NodeClass *>(this)->nodeWithKey(key, length));
+    }
+
+    const NodeClass * nodeWithKey(const T *key, std::size_t length) const {
+        const NodeClass * node = nodeWithPrefix(key, length);
+        if (node && node->mHasValue) {
+            return node;
+        }
+        return 0;
+    }
+
+    // When labelPos is given the prefix may end inside the label of a node,
+    // labelPos is then set to the number of label symbols matched by the prefix.
+    const NodeClass * nodeWithPrefix(const T *prefix, std::size_t length, std::size_t *labelPos = 0) const {
+        std::size_t i=0;
+        const NodeClass * node = this;
+
+        while (node) {
+            if (symbol(prefix, length, i) == mEndSymbol) {
+                if (labelPos) {
+                    *labelPos = node->mLabel.size();
+                }
+                return node;
+            }
+            const NodeItemClass *item = node->mItems.getItem(prefix[i]);
+            if (!item) {
+                break;
+            }
+
+            node = item->getChilds();
+            ++i;
+
+            for (std::size_t j = 0; j < node->mLabel.size(); ++j, ++i) {
+                if (symbol(prefix, length, i) == mEndSymbol) {
+                    if (labelPos) {
+                        *labelPos = j;
+                        return node;
+                    }
+                    return 0;
+                }
+                if (!equals(prefix[i], node->mLabel[j])) {
+                    return 0;
+                }
+            }
+        }
+        return 0;
+    }
+
+    static bool equals(const T &v1, const T &v2) {
+        return !Cmp()(v1, v2) && !Cmp()(v2, v1);
+    }
+
+    // Symbol at position i of the key, the end symbol past the length of the key
+    T symbol(const T *key, std::size_t length, std::size_t i) const {
+        return i < length ? key[i] : mEndSymbol;
+    }
+
+    // Splits the label of the child node of item after pos symbols,
+    // the first pos symbols move to a new node inserted between parent and the child node.
+    // Everything is made before the child node is moved, so an exception leaves the Trie unchanged.
+    NodeClass * splitLabel(NodeItemClass *item, NodeClass *parent, std::size_t pos) {
+        NodeClass *childs = item->getChilds();
+        NodeClass *middle = createNode(mEndSymbol, parent);
+        NodeLabel<T, Allocator> rest;
+        NodeItemClass *middleItem = 0;
+        try {
+            middle->mLabel.assign(allocator(), childs->mLabel.begin(), childs->mLabel.begin() + pos);
+            middle->mItems.setDepth(parent->mItems.depth() + 1 + (unsigned int)pos);
+            rest.assign(allocator(), childs->mLabel.begin() + pos + 1, childs->mLabel.end());
+            middleItem = createItem(allocator(), childs->mLabel[pos]);
+            middle->mItems.attachItem(middleItem);
+        } catch (...) {
+            // the item is not held by the middle node when attaching it failed
+            destroyItem(allocator(), middleItem);
+            rest.release(allocator());
+            middle->~NodeClass();
+            allocator()->deallocate(middle, sizeof(NodeClass));
+            throw;
+        }
+
+        middleItem->setChilds(childs);
+        childs->mParent = middle;
+        childs->mLabel.swap(rest);
+        rest.release(allocator());
+
+        item->setChilds(middle);
+        return middle;
+    }
+
+    // Merges a node having a single item and no value with the child node of that item,
+    // item is the item pointing to the node in its parent.
+    void mergeLabel(NodeItemClass *item) {
+        NodeClass *node = item->getChilds();
+        ItemsContainerIter iter = node->mItems.begin();
+        while (!*iter) {
+            ++iter;
+        }
+        NodeItemClass *onlyItem = *iter;
+        NodeClass *childs = onlyItem->getChilds();
+
+        std::vector<T> label(node->mLabel.begin(), node->mLabel.end());
+        label.push_back(onlyItem->get());
+        label.insert(label.end(), childs->mLabel.begin(), childs->mLabel.end());
+        childs->mLabel.assign(allocator(), &label[0], &label[0] + label.size());
+        childs->mParent = node->mParent;
+
+        onlyItem->setChilds(0);
+        item->setChilds(childs);
+        node->~NodeClass();
+        allocator()->deallocate(node, sizeof(NodeClass));
+    }
+
+    bool erase(NodeClass * node, const T * key, std::size_t length) {
+        if (!node || !key || !node->mHasValue) {
+            return false;
+        }
+        node->destroyValue();
+        --mSize;
+
+        // the nodes left without a value and without items are removed from the bottom up,
+        // keyIndex is the number of key symbols down to node
+        std::size_t keyIndex = measure(key, length);
+        while (node->mParent && !node->mHasValue && node->mItems.childCount() == 0) {
+            keyIndex -= node->mLabel.size() + 1;
+            NodeClass *parent = node->parent();
+            parent->mItems.eraseItem(key[keyIndex]);
+            node = parent;
+        }
+        if (mCompressed && node->mParent && !node->mHasValue && node->mItems.childCount() == 1) {
+            mergeLabel(node->mParent->mItems.getItem(key[keyIndex - node->mLabel.size() - 1]));
+        }
+        return true;
+    }
+
+public:
+    Node(const T &eSymbol, NodeClass * parent, Allocator * allocator, bool compressed = false)
+            : mItems(eSymbol, allocator),
+            mEndSymbol(eSymbol),
+            mCompressed(compressed),
+            mHasValue(false),
+            mSize(0),
+            mParent(parent) {
+        mItems.setDepth(parent ? parent->mItems.depth() + 1 : 0);
+    }
+
+    ~Node() {
+        clear();
+        mLabel.release(allocator());
+    }
+
+    // Adds the nodes from this one down to stats, depth is the number of key symbols above this node
+    void collectStats(TrieStats &stats, unsigned int depth) const {
+        stats.add(depth, mItems.childCount(), mHasValue, mLabel.size());
+        for (ItemsContainerConstIter iter = mItems.begin(); iter != mItems.end(); ++iter) {
+            if (*iter && (*iter)->getChilds()) {
+                const NodeClass *childs = (*iter)->getChilds();
+                childs->collectStats(stats, depth + 1 + (unsigned int)childs->mLabel.size());
+            }
+        }
+    }
+
+    static NodeClass *createNode(const T &endSymbol, NodeClass *parent) {
+        Allocator *allocator = parent->allocator();
+        return new (allocator->allocate(sizeof(NodeClass))) NodeClass(endSymbol, parent, allocator);
+    }
+
+    static NodeItemClass *createItem(Allocator *allocator, const T &key) {
+        return new (allocator->allocate(sizeof(NodeItemClass))) NodeItemClass(key);
+    }
+
+    static void destroyItem(Allocator *allocator, NodeItemClass *item) {
+        if (item) {
+            NodeClass *childs = item->getChilds();
+            if (childs) {
+                childs->~NodeClass();
+                allocator->deallocate(childs, sizeof(NodeClass));
+            }
+            item->~NodeItemClass();
+            allocator->deallocate(item, sizeof(NodeItemClass));
+        }
+    }
+
+    T endSymbol() const {
+        return mEndSymbol;
+    }
+
+    Allocator *allocator() const {
+        return mItems.allocator();
+    }
+
+    bool compressed() const {
+        return mCompressed;
+    }
+
+    // true if a key ends at this node
+    bool hasValue() const {
+        return mHasValue;
+    }
+
+    const V &value() const {
+        return *mValue.get();
+    }
+
+    V &value() {
+        return *mValue.get();
+    }
+
+    void clear() {
+        destroyValue();
+        // nodes emptied by erase are destroyed without visiting every slot of the items
+        if (mItems.childCount() > 0) {
+            Allocator *alloc = allocator();
+            for (ItemsContainerIter iter = mItems.begin(); iter != mItems.end(); ++iter) {
+                destroyItem(alloc, *iter);
+            }
+            mItems.clear();
+        }
+        mSize = 0;
+    }
+
+    // Exchanges the contents of the nodes, only the direct children are updated to point
+    // to their new parent so it takes time propotional to the number of items in the node
+    void swap(NodeClass &oth) {
+        mItems.swap(oth.mItems);
+        std::swap(mEndSymbol, oth.mEndSymbol);
+        std::swap(mSize, oth.mSize);
+        mLabel.swap(oth.mLabel);
+        std::swap(mCompressed, oth.mCompressed);
+        swapValue(oth);
+        adoptChilds();
+        oth.adoptChilds();
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+    unsigned int size() const {
+        return mSize;
+    }
+
+    std::pair<Iterator, bool> insert(const T *key, V const &value) {
+        return insert(key, npos, value);
+    }
+
+    std::pair<Iterator, bool> insert(const T *key, std::size_t length, V const &value) {
+        NodeClass *node = 0;
+        return iteratorPair(key, length, node, insertNode(key, length, &node, value));
+    }
+
+    std::pair<V *, bool> insertFast(const T *key, std::size_t length, V const &value) {
+        return insertNode(key, length, 0, value);
+    }
+
+    // An empty node is built by rtv::Node::BulkLoader while the keys come in the order of Cmp,
+    // the keys from the first one out of order and the keys of a node which is not empty are inserted
+    template <typename InputIterator>
+    std::size_t bulkLoad(InputIterator first, InputIterator last) {
+        if (!empty() || mItems.childCount() > 0) {
+            return insertRange(first, last);
+        }
+
+        std::size_t inserted = 0;
+        BulkLoader loader(this);
+        for (; first != last; ++first) {
+            const T *key = keyData(first->first);
+            NodeClass *node = loader.open(key, measure(key, keyLength(first->first)));
+            if (!node) {
+                break;
+            }
+            if (!node->mHasValue) {
+                node->createValue(first->second);
+                ++mSize;
+                ++inserted;
+            }
+        }
+        loader.finish();
+        return inserted + insertRange(first, last);
+    }
+
+    // Inserts the keys one at a time, each descending from this node
+    template <typename InputIterator>
+    std::size_t insertRange(InputIterator first, InputIterator last) {
+        std::size_t inserted = 0;
+        for (; first != last; ++first) {
+            const T *key = keyData(first->first);
+            NodeClass *node = descend(key, measure(key, keyLength(first->first)), this, 0);
+            if (node && !node->mHasValue) {
+                node->createValue(first->second);
+                ++mSize;
+                ++inserted;
+            }
+        }
+        return inserted;
+    }
+
+#ifdef RTV_HAS_CXX11
+    template <typename ForwardIterator>
+    std::size_t parallelLoad(ForwardIterator first, ForwardIterator last, unsigned int threads,
+                             std::size_t prefixLength) {
+        if (prefixLength == 0) {
+            prefixLength = 1;
+        }
+
+        // the keys sharing the first prefixLength symbols end up in the same subtree
+        typedef std::vector<ForwardIterator> Group;
+        typedef std::map<std::vector<T>, Group, PrefixCompare> Groups;
+        Groups groups;
+        Group shortKeys;
+        std::vector<T> prefix;
+        for (; first != last; ++first) {
+            const T *key = keyData(first->first);
+            std::size_t length = measure(key, keyLength(first->first));
+            if (length < prefixLength) {
+                shortKeys.push_back(first);
+            } else {
+                prefix.assign(key, key + prefixLength);
+                groups[prefix].push_back(first);
+            }
+        }
+
+        if (threads == 0) {
+            threads = std::max(std::thread::hardware_concurrency(), 1u);
+        }
+        if (threads > groups.size()) {
+            threads = (unsigned int)groups.size();
+        }
+
+        // largest groups first, each to the worker with the fewest keys so far
+        std::vector<Group *> bySize;
+        for (typename Groups::iterator iter = groups.begin(); iter != groups.end(); ++iter) {
+            bySize.push_back(&iter->second);
+        }
+        std::stable_sort(bySize.begin(), bySize.end(), GroupLarger<Group>());
+        std::vector<Group> work(threads);
+        for (std::size_t i = 0; i < bySize.size(); ++i) {
+            std::size_t target = 0;
+            for (std::size_t w = 1; w < work.size(); ++w) {
+                if (work[w].size() < work[target].size()) {
+                    target = w;
+                }
+            }
+            work[target].insert(work[target].end(), bySize[i]->begin(), bySize[i]->end());
+        }
+
+        // each worker builds its keys under a root and an allocator of its own,
+        // the keys of the workers are added only if none of them failed
+        LoadWorkers workers(this, work.size());
+        for (std::size_t w = 0; w < work.size(); ++w) {
+            workers.start(&work[w]);
+        }
+        workers.join();
+        std::size_t inserted = workers.graft();
+
+        inserted += bulkLoad(Indirect<ForwardIterator>(shortKeys.begin()), Indirect<ForwardIterator>(shortKeys.end()));
+        return inserted;
+    }
+#endif
+
+    std::pair<Iterator, bool> insertOrAssign(const T *key, std::size_t length, V const &value) {
+        NodeClass *node = 0;
+        std::pair<V *, bool> result = insertNode(key, length, &node, value);
+        if (result.first && !result.second) {
+            *result.first = value;
+        }
+        return iteratorPair(key, length, node, result);
+    }
+
+#ifdef RTV_HAS_CXX11
+    std::pair<Iterator, bool> insert(const T *key, std::size_t length, V &&value) {
+        return emplace(key, length, std::move(value));
+    }
+
+    // value is always moved from, in to the new element or in to the value of the key already present
+    std::pair<Iterator, bool> insertOrAssign(const T *key, std::size_t length, V &&value) {
+        NodeClass *node = 0;
+        std::pair<V *, bool> result = insertNode(key, length, &node, std::move(value));
+        if (result.first && !result.second) {
+            *result.first = std::move(value);
+        }
+        return iteratorPair(key, length, node, result);
+    }
+
+    template <typename... Args>
+    std::pair<Iterator, bool> emplace(const T *key, std::size_t length, Args&&... args) {
+        NodeClass *node = 0;
+        return iteratorPair(key, length, node, insertNode(key, length, &node, std::forward<Args>(args)...));
+    }
+
+    template <typename... Args>
+    std::pair<V *, bool> emplaceFast(const T *key, std::size_t length, Args&&... args) {
+        return insertNode(key, length, 0, std::forward<Args>(args)...);
+    }
+#endif
+
+    bool erase(Iterator pos) {
+        if (pos.mAtValue) {
+            return erase(const_cast<NodeClass *>(pos.mCurrentNode), pos->first, npos);
+        }
+        return false;
+    }
+
+    bool erase(const T *key, std::size_t length = npos) {
+        NodeClass * node = nodeWithKey(key, length);
+        if (node) {
+            return erase(node, key, length);
+        }
+        return false;
+    }
+
+    const V *get(const T *key, std::size_t length = npos) const {
+        return const_cast<NodeClass *>(this)->get(key, length);
+    }
+
+    V *get(const T *key, std::size_t length = npos) {
+        NodeClass * node = nodeWithKey(key, length);
+        if (node) {
+            return &node->value();
+        }
+        return 0;
+    }
+
+
+    bool hasKey(const T *key, std::size_t length = npos) const {
+        return get(key, length) != (V *)0;
+    }
+
+    const NodeClass * parent() const {
+        return mParent;
+    }
+
+    NodeClass * parent() {
+        return mParent;
+    }
+
+    ConstIterator begin() const {
+        return ConstIterator(this, this);
+    }
+
+    ConstIterator end() const {
+        return ConstIterator(this, this, 0, true);
+    }
+
+    Iterator begin() {
+        return Iterator(this, this);
+    }
+
+    Iterator end() {
+        return Iterator(this, this, 0, true);
+    }
+
+    ConstIterator find(const T *key, std::size_t length = npos) const {
+        NodeClass * node = const_cast<NodeClass *>(this)->nodeWithKey(key, length);
+        if (!node) {
+            return ConstIterator(this, this, 0, true);
+        } else {
+            return ConstIterator(node, this, key, false, length);
+        }
+    }
+
+    Iterator find(const T *key, std::size_t length = npos) {
+        NodeClass * node = this->nodeWithKey(key, length);
+        if (!node) {
+            return Iterator(this, this, 0, true);
+        } else {
+            return Iterator(node, this, key, false, length);
+        }
+    }
+
+    Iterator startsWith(const T *prefix, std::size_t length = npos) {
+        std::size_t labelPos = 0;
+        const NodeClass * node = const_cast<const NodeClass *>(this)->nodeWithPrefix(prefix, length, &labelPos);
+        if (!node) {
+            return Iterator(this, this, 0, true);
+        } else if (labelPos < node->mLabel.size()) {
+            std::vector<T> key = completeLabel(node, prefix, length, labelPos);
+            return Iterator(const_cast<NodeClass *>(node), const_cast<NodeClass *>(node), &key[0]);
+        } else {
+            return Iterator(const_cast<NodeClass *>(node), const_cast<NodeClass *>(node), prefix, false, length);
+        }
+    }
+
+    ConstIterator startsWith(const T *prefix, std::size_t length = npos) const {
+        std::size_t labelPos = 0;
+        const NodeClass * node = nodeWithPrefix(prefix, length, &labelPos);
+        if (!node) {
+            return ConstIterator(this, this, 0, true);
+        } else if (labelPos < node->mLabel.size()) {
+            std::vector<T> key = completeLabel(node, prefix, length, labelPos);
+            return ConstIterator(node, node, &key[0]);
+        } else {
+            return ConstIterator(node, node, prefix, false, length);
+        }
+    }
+
+    std::pair<std::size_t, V *> longestPrefixOf(const T *key, std::size_t length = npos) {
+        std::pair<std::size_t, const V *> result = const_cast<const NodeClass *>(this)->longestPrefixOf(key, length);
+        return std::pair<std::size_t, V *>(result.first, const_cast<V *>(result.second));
+    }
+
+    std::pair<std::size_t, const V *> longestPrefixOf(const T *key, std::size_t length = npos) const {
+        LongestPrefix<V> longest;
+        visitPrefixes(key, length, longest);
+        return longest.mResult;
+    }
+
+    template <typename Callback>
+    Callback prefixesOf(const T *key, std::size_t length, Callback callback) {
+        PrefixCallback<Callback, V> adapter(callback);
+        visitPrefixes(key, length, adapter);
+        return callback;
+    }
+
+    template <typename Callback>
+    Callback prefixesOf(const T *key, std::size_t length, Callback callback) const {
+        PrefixCallback<Callback, const V> adapter(callback);
+        visitPrefixes(key, length, adapter);
+        return callback;
+    }
+
+    void getMany(const T * const *keys, std::size_t count, V **values, const std::size_t *lengths = 0) {
+        ValueCollector<V *> collector(values);
+        visitKeys(keys, count, lengths, collector);
+    }
+
+    void getMany(const T * const *keys, std::size_t count, const V **values, const std::size_t *lengths = 0) const {
+        ValueCollector<const V *> collector(values);
+        visitKeys(keys, count, lengths, collector);
+    }
+
+    void findMany(const T * const *keys, std::size_t count, Iterator *results, const std::size_t *lengths = 0) {
+        IteratorCollector<Iterator, NodeClass> collector(results, this, keys, lengths);
+        visitKeys(keys, count, lengths, collector);
+    }
+
+    void findMany(const T * const *keys, std::size_t count, ConstIterator *results,
+                  const std::size_t *lengths = 0) const {
+        IteratorCollector<ConstIterator, const NodeClass> collector(results, this, keys, lengths);
+        visitKeys(keys, count, lengths, collector);
+    }
+
+private:
+    template <typename Callback, typename R>
+    class PrefixCallback
+    {
+    public:
+        PrefixCallback(Callback &callback)
+                : mCallback(callback) {}
+
+        void operator()(std::size_t length, const V &value) {
+            mCallback(length, const_cast<R &>(value));
+        }
+
+    private:
+        Callback &mCallback;
+    };
+
+    // Walks the key once, visitor(length, value) is called for every key in the Trie
+    // which is a prefix of the given key, shortest first.
+    template <typename Visitor>
+    void visitPrefixes(const T *key, std::size_t length, Visitor &visitor) const {
+        std::size_t i = 0;
+        const NodeClass *node = this;
+
+        while (true) {
+            if (node->mHasValue) {
+                visitor(i, node->value());
+            }
+            T k = symbol(key, length, i);
+            if (k == mEndSymbol) {
+                return;
+            }
+            const NodeItemClass *item = node->mItems.getItem(k);
+            if (!item || !item->getChilds()) {
+                return;
+            }
+
+            node = item->getChilds();
+            ++i;
+
+            for (std::size_t j = 0; j < node->mLabel.size(); ++j, ++i) {
+                if (symbol(key, length, i) == mEndSymbol || !equals(key[i], node->mLabel[j])) {
+                    return;
+                }
+            }
+        }
+    }
+
+    void adoptChilds() {
+        for (ItemsContainerIter iter = mItems.begin(); iter != mItems.end(); ++iter) {
+            if (*iter && (*iter)->getChilds()) {
+                (*iter)->getChilds()->mParent = this;
+            }
+        }
+    }
+
+    // Number of keys looked up in lockstep by visitKeys
+    static const std::size_t BatchWidth = 16;
+
+    // Step of a key in visitKeys, each step reads memory prefetched by the previous one
+    enum LaneStage {
+        LaneNode,
+        LaneLabel,
+        LaneItem,
+        LaneChild
+    };
+
+    struct Lane {
+        void start(const NodeClass *root, std::size_t key) {
+            node = root;
+            item = 0;
+            index = key;
+            pos = 0;
+            stage = LaneNode;
+        }
+
+        const NodeClass *node;
+        const NodeItemClass *item;
+        std::size_t index;
+        std::size_t pos;
+        T symbol;
+        LaneStage stage;
+    };
+
+    template <typename P>
+    class ValueCollector
+    {
+    public:
+        ValueCollector(P *values)
+                : mValues(values) {}
+
+        void operator()(std::size_t index, const NodeClass *node) {
+            mValues[index] = node ? const_cast<P>(&node->value()) : 0;
+        }
+
+    private:
+        P *mValues;
+    };
+
+    template <typename I, typename N>
+    class IteratorCollector
+    {
+    public:
+        IteratorCollector(I *results, N *root, const T * const *keys, const std::size_t *lengths)
+                : mResults(results),
+                  mRoot(root),
+                  mKeys(keys),
+                  mLengths(lengths) {}
+
+        void operator()(std::size_t index, const NodeClass *node) {
+            if (node) {
+                mResults[index] = I(const_cast<N *>(node), mRoot, mKeys[index], false,
+                                    mLengths ? mLengths[index] : npos);
+            } else {
+                mResults[index] = I(mRoot, mRoot, 0, true);
+            }
+        }
+
+    private:
+        I *mResults;
+        N *mRoot;
+        const T * const *mKeys;
+        const std::size_t *mLengths;
+    };
+
+    // Looks up the keys BatchWidth at a time. Each key in flight moves one dependent
+    // memory access forward per round and prefetches the next one, so the cache misses
+    // of the keys overlap instead of being paid one after another.
+    // visitor(index, node) is called once per key with the node of the key, 0 if it is not found.
+    template <typename Visitor>
+    void visitKeys(const T * const *keys, std::size_t count, const std::size_t *lengths, Visitor &visitor) const {
+        Lane lanes[BatchWidth];
+        std::size_t active = 0;
+        std::size_t next = 0;
+
+        for (; active < BatchWidth && next < count; ++active, ++next) {
+            lanes[active].start(this, next);
+        }
+
+        while (active > 0) {
+            for (std::size_t l = 0; l < active;) {
+                Lane &lane = lanes[l];
+                const T *key = keys[lane.index];
+                std::size_t length = lengths ? lengths[lane.index] : npos;
+                bool finished = false;
+                bool found = false;
+
+                switch (lane.stage) {
+                case LaneNode:
+                    if (!lane.node->mLabel.empty()) {
+                        RTV_PREFETCH(lane.node->mLabel.begin());
+                        lane.stage = LaneLabel;
+                        break;
+                    }
+                    finished = nextSymbol(lane, key, length);
+                    found = finished && lane.node->mHasValue;
+                    break;
+                case LaneLabel:
+                    for (std::size_t j = 0; j < lane.node->mLabel.size() && !finished; ++j, ++lane.pos) {
+                        finished = symbol(key, length, lane.pos) == mEndSymbol ||
+                                   !equals(key[lane.pos], lane.node->mLabel[j]);
+                    }
+                    if (!finished) {
+                        finished = nextSymbol(lane, key, length);
+                        found = finished && lane.node->mHasValue;
+                    }
+                    break;
+                case LaneItem:
+                    lane.item = lane.node->mItems.getItem(lane.symbol);
+                    if (!lane.item) {
+                        finished = true;
+                    } else {
+                        RTV_PREFETCH(lane.item);
+                        lane.stage = LaneChild;
+                    }
+                    break;
+                case LaneChild:
+                    lane.node = lane.item->getChilds();
+                    if (!lane.node) {
+                        finished = true;
+                    } else {
+                        RTV_PREFETCH(lane.node);
+                        ++lane.pos;
+                        lane.stage = LaneNode;
+                    }
+                    break;
+                }
+
+                if (!finished) {
+                    ++l;
+                    continue;
+                }
+
+                visitor(lane.index, found ? lane.node : (const NodeClass *)0);
+                if (next < count) {
+                    lane.start(this, next++);
+                    ++l;
+                } else {
+                    lane = lanes[--active];
+                }
+            }
+        }
+    }
+
+    // Reads the symbol at the position of the lane and prefetches its item,
+    // true if the key ends there so that the node of the lane is the node of the key
+    bool nextSymbol(Lane &lane, const T *key, std::size_t length) const {
+        lane.symbol = symbol(key, length, lane.pos);
+        if (lane.symbol == mEndSymbol) {
+            return true;
+        }
+        lane.node->mItems.prefetchItem(lane.symbol);
+        lane.stage = LaneItem;
+        return false;
+    }
+
+    // Descends to the node which should hold the value of the key, creating the missing nodes
+    // and splitting the labels on the way, returns 0 on failure.
+    // The descent starts at node current, with i symbols of the key already matched.
+    NodeClass *descend(const T *key, std::size_t length, NodeClass *current, std::size_t i) {
+        for (T k = symbol(key, length, i); k != mEndSymbol; k = symbol(key, length, ++i)) {
+            NodeItemClass *item = current->mItems.insertItem(k).first;
+            if (!item) {
+                return 0;
+            }
+            NodeClass *childs = item->getChilds();
+            if (!childs) {
+                childs = item->getOrCreateChilds(current);
+                if (mCompressed) {
+                    std::size_t end = i + 1;
+                    while (symbol(key, length, end) != mEndSymbol) {
+                        ++end;
+                    }
+                    childs->mLabel.assign(allocator(), key + i + 1, key + end);
+                    i = end - 1;
+                    childs->mItems.setDepth(current->mItems.depth() + 1 + (unsigned int)childs->mLabel.size());
+                }
+            } else if (!childs->mLabel.empty()) {
+                std::size_t j = 0;
+                while (j < childs->mLabel.size() && symbol(key, length, i + 1 + j) != mEndSymbol &&
+                       equals(key[i + 1 + j], childs->mLabel[j])) {
+                    ++j;
+                }
+                if (j < childs->mLabel.size()) {
+                    childs = splitLabel(item, current, j);
+                }
+                i += j;
+            }
+            current = childs;
+        }
+        return current;
+    }
+
+    static const T *keyData(const T *key) {
+        return key;
+    }
+
+    static std::size_t keyLength(const T *) {
+        return npos;
+    }
+
+    template <typename Traits, typename A>
+    static const T *keyData(std::basic_string<T, Traits, A> const &key) {
+        return key.data();
+    }
+
+    template <typename Traits, typename A>
+    static std::size_t keyLength(std::basic_string<T, Traits, A> const &key) {
+        return key.size();
+    }
+
+    template <typename A>
+    static const T *keyData(std::vector<T, A> const &key) {
+        return key.empty() ? (const T *)0 : &key[0];
+    }
+
+    template <typename A>
+    static std::size_t keyLength(std::vector<T, A> const &key) {
+        return key.size();
+    }
+
+#ifdef RTV_HAS_STRING_VIEW
+    template <typename Traits>
+    static const T *keyData(std::basic_string_view<T, Traits> key) {
+        return key.data();
+    }
+
+    template <typename Traits>
+    static std::size_t keyLength(std::basic_string_view<T, Traits> key) {
+        return key.size();
+    }
+#endif
+
+    // Number of symbols of the key before the end symbol or its length, whichever comes first
+    std::size_t measure(const T *key, std::size_t length) const {
+        std::size_t i = 0;
+        while (i < length && key[i] != mEndSymbol) {
+            ++i;
+        }
+        return i;
+    }
+
+    // Builds the nodes of keys coming in the order of Cmp below an empty root.
+    // The nodes on the path of the previous key are open, each with the position in the key of the symbols
+    // of its items. The symbols of a key past those it shares with the previous key come after every symbol
+    // of their open nodes, so their items are appended to the nodes without searching them. Until finish is
+    // called the root is left empty by the destructor, so an exception thrown while loading drops the keys
+    // loaded so far.
+    class BulkLoader
+    {
+    public:
+        explicit BulkLoader(NodeClass *root)
+                : mRoot(root),
+                mFinished(false) {
+            mOpen.push_back(Open(root, 0, 0));
+        }
+
+        ~BulkLoader() {
+            if (!mFinished) {
+                mRoot->clear();
+            }
+        }
+
+        // Returns the node of the key, making the nodes missing on its path,
+        // or 0 if the key comes before the previous key in the order of Cmp
+        NodeClass *open(const T *key, std::size_t length) {
+            std::size_t common = 0;
+            while (common < mPrevious.size() && common < length && equals(key[common], mPrevious[common])) {
+                ++common;
+            }
+            if (common == length) {
+                // the previous key again, or a prefix of it which should have come first
+                return common == mPrevious.size() ? mOpen.back().node : 0;
+            }
+            if (common < mPrevious.size() && Cmp()(key[common], mPrevious[common])) {
+                return 0;
+            }
+
+            close(common);
+            Allocator *allocator = mRoot->allocator();
+            for (std::size_t i = common; i < length; ++i) {
+                NodeClass *parent = mOpen.back().node;
+                NodeItemClass *item = createItem(allocator, key[i]);
+                NodeClass *childs = attach(parent, item);
+                if (mRoot->mCompressed) {
+                    childs->mLabel.assign(allocator, key + i + 1, key + length);
+                    childs->mItems.setDepth(parent->mItems.depth() + (unsigned int)(length - i));
+                    i = length - 1;
+                }
+                mOpen.push_back(Open(childs, i + 1, item));
+            }
+            mPrevious.assign(key, key + length);
+            return mOpen.back().node;
+        }
+
+        // The keys loaded are kept by the root from now on
+        void finish() {
+            mFinished = true;
+        }
+
+    private:
+        BulkLoader(BulkLoader const &);
+        BulkLoader &operator=(BulkLoader const &);
+
+        struct Open {
+            Open(NodeClass *n, std::size_t o, NodeItemClass *i)
+                    : node(n),
+                    offset(o),
+                    item(i) {}
+
+            NodeClass *node;
+            // position in the key of the symbols of the items of the node
+            std::size_t offset;
+            // item of the node in its parent, 0 for the root
+            NodeItemClass *item;
+        };
+
+        // Makes the child node of item and appends item after the items of parent,
+        // destroying both if they can not be
+        static NodeClass *attach(NodeClass *parent, NodeItemClass *item) {
+            try {
+                item->getOrCreateChilds(parent);
+                parent->mItems.attachItem(item);
+            } catch (...) {
+                destroyItem(parent->allocator(), item);
+                throw;
+            }
+            return item->getChilds();
+        }
+
+        // Closes the nodes which do not hold the first common symbols of the previous key. With path
+        // compression the last node closed is split when those symbols end inside its label
+        void close(std::size_t common) {
+            std::size_t open = mOpen.size();
+            while (mOpen[open - 1].offset > common) {
+                --open;
+            }
+            if (open == mOpen.size()) {
+                return;
+            }
+            NodeItemClass *item = mOpen[open].item;
+            mOpen.erase(mOpen.begin() + open, mOpen.end());
+            std::size_t offset = mOpen.back().offset;
+            if (offset < common) {
+                NodeClass *middle = mRoot->splitLabel(item, mOpen.back().node, common - offset - 1);
+                mOpen.push_back(Open(middle, common, item));
+            }
+        }
+
+    private:
+        NodeClass *mRoot;
+        bool mFinished;
+        std::vector<Open> mOpen;
+        std::vector<T> mPrevious;
+    };
+
+#ifdef RTV_HAS_CXX11
+    // Orders the key prefixes used by parallelLoad symbol by symbol using Cmp
+    class PrefixCompare
+    {
+    public:
+        bool operator()(std::vector<T> const &v1, std::vector<T> const &v2) const {
+            return std::lexicographical_compare(v1.begin(), v1.end(), v2.begin(), v2.end(), Cmp());
+        }
+    };
+
+    template <typename Group>
+    class GroupLarger
+    {
+    public:
+        bool operator()(const Group *g1, const Group *g2) const {
+            return g1->size() > g2->size();
+        }
+    };
+
+    // Iterator over a vector of iterators, which dereferences the iterator in the vector
+    template <typename I>
+    class Indirect
+    {
+    public:
+        explicit Indirect(typename std::vector<I>::const_iterator iter)
+                : mIter(iter) {}
+
+        typename std::iterator_traits<I>::pointer operator->() const {
+            return &**mIter;
+        }
+
+        Indirect &operator++() {
+            ++mIter;
+            return *this;
+        }
+
+        bool operator!=(Indirect const &oth) const {
+            return mIter != oth.mIter;
+        }
+
+    private:
+        typename std::vector<I>::const_iterator mIter;
+    };
+
+    // Worker threads of parallelLoad with the roots and the allocators they build on.
+    // The destructor joins the threads started so far, frees the roots left and joins the allocators back,
+    // so nothing leaks and no thread is left running whichever way parallelLoad exits
+    class LoadWorkers
+    {
+    public:
+        LoadWorkers(NodeClass *trie, std::size_t count)
+                : mTrie(trie),
+                mErrors(count) {
+            // start only adds to the reserved vectors, so what it made is held before anything can throw
+            mAllocators.reserve(count);
+            mRoots.reserve(count);
+            mWorkers.reserve(count);
+        }
+
+        ~LoadWorkers() {
+            wait();
+            for (std::size_t w = 0; w < mRoots.size(); ++w) {
+                delete mRoots[w];
+            }
+            for (std::size_t w = 0; w < mAllocators.size(); ++w) {
+                mTrie->allocator()->join(mAllocators[w]);
+            }
+        }
+
+        // Starts a worker building keys under a root and an allocator of its own
+        template <typename I>
+        void start(const std::vector<I> *keys) {
+            std::size_t w = mWorkers.size();
+            mAllocators.push_back(mTrie->allocator()->fork());
+            mRoots.push_back(new NodeClass(mTrie->mEndSymbol, 0, mAllocators[w], mTrie->mCompressed));
+            mWorkers.push_back(std::thread(&LoadWorkers::template run<I>, mRoots[w], keys, &mErrors[w]));
+        }
+
+        // Waits for all the workers, then rethrows the first exception thrown by one of them
+        void join() {
+            wait();
+            for (std::size_t w = 0; w < mErrors.size(); ++w) {
+                if (mErrors[w]) {
+                    std::rethrow_exception(mErrors[w]);
+                }
+            }
+        }
+
+        // Moves the keys of the workers in to the trie, returns the number of those which were not present
+        std::size_t graft() {
+            std::size_t inserted = 0;
+            for (std::size_t w = 0; w < mRoots.size(); ++w) {
+                std::size_t added = mRoots[w]->mSize - mTrie->graft(mRoots[w]);
+                inserted += added;
+                mTrie->mSize += (unsigned int)added;
+                delete mRoots[w];
+                mRoots[w] = 0;
+            }
+            return inserted;
+        }
+
+    private:
+        LoadWorkers(LoadWorkers const &);
+        LoadWorkers &operator=(LoadWorkers const &);
+
+        void wait() {
+            for (std::size_t w = 0; w < mWorkers.size(); ++w) {
+                if (mWorkers[w].joinable()) {
+                    mWorkers[w].join();
+                }
+            }
+        }
+
+        // Runs on a worker thread, an exception is kept for the calling thread as it would end the process
+        template <typename I>
+        static void run(NodeClass *root, const std::vector<I> *keys, std::exception_ptr *error) {
+            try {
+                root->bulkLoad(Indirect<I>(keys->begin()), Indirect<I>(keys->end()));
+            } catch (...) {
+                *error = std::current_exception();
+            }
+        }
+
+    private:
+        NodeClass *mTrie;
+        std::vector<Allocator *> mAllocators;
+        std::vector<NodeClass *> mRoots;
+        std::vector<std::exception_ptr> mErrors;
+        std::vector<std::thread> mWorkers;
+    };
+#endif
+
+    // Moves the keys of from, a node at the same place in another Trie, in to this node. The subtrees of from
+    // which this node does not have are moved as they are. A key present in both keeps its value in this node,
+    // the value in from is dropped with from. Returns the number of keys of from which are dropped
+    std::size_t graft(NodeClass *from) {
+        std::size_t dropped = 0;
+        if (from->mHasValue) {
+            if (mHasValue) {
+                ++dropped;
+            } else {
+                swapValue(*from);
+            }
+        }
+        for (ItemsContainerIter iter = from->mItems.begin(); iter != from->mItems.end(); ++iter) {
+            if (*iter && (*iter)->getChilds()) {
+                dropped += graftChilds((*iter)->get(), *iter);
+            }
+        }
+        return dropped;
+    }
+
+    // Moves the child node of owner, an item of another Trie, below the item of symbol of this node.
+    // The label of the child node follows symbol, with path compression the labels are split where
+    // they differ. owner keeps the child node until it is moved or destroyed
+    std::size_t graftChilds(const T &symbol, NodeItemClass *owner) {
+        NodeClass *childs = owner->getChilds();
+        NodeItemClass *target = mItems.insertItem(symbol).first;
+        NodeClass *existing = target->getChilds();
+        if (!existing) {
+            owner->setChilds(0);
+            childs->mParent = this;
+            target->setChilds(childs);
+            return 0;
+        }
+
+        std::size_t common = 0;
+        while (common < existing->mLabel.size() && common < childs->mLabel.size() &&
+               equals(existing->mLabel[common], childs->mLabel[common])) {
+            ++common;
+        }
+        if (common < existing->mLabel.size()) {
+            existing = splitLabel(target, this, common);
+        }
+        if (common < childs->mLabel.size()) {
+            // the node of existing ends inside the label of childs
+            T next = childs->mLabel[common];
+            childs->mLabel.eraseFront(childs->allocator(), common + 1);
+            return existing->graftChilds(next, owner);
+        }
+
+        std::size_t dropped = existing->graft(childs);
+        owner->setChilds(0);
+        Allocator *allocator = childs->allocator();
+        childs->~NodeClass();
+        allocator->deallocate(childs, sizeof(NodeClass));
+        return dropped;
+    }
+
+    // Only descends and allocates the nodes for the key, returns the value of the key (0 on failure)
+    // and true if the key is newly inserted. node is set to the node holding the value.
+    // The value is constructed in place, and only when the key is not present.
+#ifdef RTV_HAS_CXX11
+    template <typename... Args>
+    std::pair<V *, bool> insertNode(const T *key, std::size_t length, NodeClass **node, Args&&... args) {
+#else
+    std::pair<V *, bool> insertNode(const T *key, std::size_t length, NodeClass **node, V const &value) {
+#endif
+        NodeClass *current = descend(key, length, this, 0);
+        if (node) {
+            *node = current;
+        }
+        if (!current) {
+            return std::pair<V *, bool>((V *)0, false);
+        }
+        if (current->mHasValue) {
+            return std::pair<V *, bool>(&current->value(), false);
+        }
+
+#ifdef RTV_HAS_CXX11
+        V *created = current->createValue(std::forward<Args>(args)...);
+#else
+        V *created = current->createValue(value);
+#endif
+        ++mSize;
+        return std::pair<V *, bool>(created, true);
+    }
+
+    std::pair<Iterator, bool> iteratorPair(const T *key, std::size_t length, NodeClass *node,
+                                           std::pair<V *, bool> result) {
+        if (!result.first) {
+            return std::pair<Iterator, bool>(end(), false);
+        }
+        return std::pair<Iterator, bool>(Iterator(node, this, key, false, length), result.second);
+    }
+
+#ifdef RTV_HAS_CXX11
+    template <typename... Args>
+    V *createValue(Args&&... args) {
+        V *created = new (mValue.allocate(allocator())) V(std::forward<Args>(args)...);
+        mHasValue = true;
+        return created;
+    }
+#else
+    V *createValue(V const &value) {
+        V *created = new (mValue.allocate(allocator())) V(value);
+        mHasValue = true;
+        return created;
+    }
+#endif
+
+    void destroyValue() {
+        if (mHasValue) {
+            value().~V();
+            mValue.deallocate(allocator());
+            mHasValue = false;
+        }
+    }
+
+    void swapValue(NodeClass &oth) {
+        mValue.swap(oth.mValue, mHasValue, oth.mHasValue);
+        std::swap(mHasValue, oth.mHasValue);
+    }
+
+    // Prefix ending inside the label of node followed by rest of the label
+    std::vector<T> completeLabel(const NodeClass *node, const T *prefix, std::size_t length,
+                                 std::size_t labelPos) const {
+        std::vector<T> key;
+        for (std::size_t i = 0; symbol(prefix, length, i) != mEndSymbol; ++i) {
+            key.push_back(prefix[i]);
+        }
+        key.insert(key.end(), node->mLabel.begin() + labelPos, node->mLabel.end());
+        key.push_back(mEndSymbol);
+        return key;
+    }
+
+private:
+    Items mItems;
+    T mEndSymbol;
+    bool mCompressed;
+    // Whether a key ends at this node, its value is constructed in mValue only while this is set
+    bool mHasValue;
+    unsigned int mSize;
+    NodeClass * mParent;
+    // Symbols following the item symbol on the edge leading to this node, empty unless compressed
+    NodeLabel<T, Allocator> mLabel;
+    NodeValue<V, Allocator> mValue;
+};
+
+template < typename T,
+typename V,
+typename Cmp,
+typename Items > const std::size_t Node<T, V, Cmp, Items>::npos;
+
+/*!
+ * @brief Allocator which uses the global new and delete operators.
+ *
+ * This is the default allocator used for the nodes and node items of the Trie.
+ */
+class HeapAllocator
+{
+public:
+    void *allocate(std::size_t size) {
+        return ::operator new(size);
+    }
+
+    void deallocate(void *p, std::size_t) {
+        ::operator delete(p);
+    }
+
+    void release() {}
+
+    // The heap can be used by several threads at once, so the allocator is shared
+    HeapAllocator *fork() {
+        return this;
+    }
+
+    void join(HeapAllocator *) {}
+};
+
+/*!
+ * @brief Allocator which carves the nodes and node items out of large slabs.
+ *
+ * Released objects are kept in a free list per size and reused by later allocations.
+ * Memory is given back to the system only when the Trie is cleared or destroyed,
+ * in which case all the slabs are freed at once.
+ * @tparam SlabSize Size in bytes of each slab
+ */
+template <std::size_t SlabSize = 65536> class SlabAllocator
+{
+private:
+    enum {
+        Alignment = 16
+    };
+
+    struct FreeBlock {
+        FreeBlock *mNext;
+    };
+
+public:
+    SlabAllocator()
+            : mCurrent(0),
+            mRemaining(0),
+            mTarget(0) {}
+
+    ~SlabAllocator() {
+        release();
+    }
+
+    void *allocate(std::size_t size) {
+        if (mTarget) {
+            return mTarget->allocate(size);
+        }
+        size = roundUp(size);
+        std::size_t index = size / Alignment;
+        if (index >= mFreeLists.size()) {
+            // made here so that deallocate, called by destructors, never grows the lists and cannot throw
+            mFreeLists.resize(index + 1, (FreeBlock *)0);
+        } else if (mFreeLists[index]) {
+            FreeBlock *block = mFreeLists[index];
+            mFreeLists[index] = block->mNext;
+            return block;
+        }
+
+        if (size > SlabSize / 4) {
+            char *slab = static_cast<char *>(::operator new(size));
+            mSlabs.push_back(slab);
+            return slab;
+        }
+
+        if (size > mRemaining) {
+            mCurrent = static_cast<char *>(::operator new(SlabSize));
+            mSlabs.push_back(mCurrent);
+            mRemaining = SlabSize;
+        }
+        void *p = mCurrent;
+        mCurrent += size;
+        mRemaining -= size;
+        return p;
+    }
+
+    void deallocate(void *p, std::size_t size) {
+        if (mTarget) {
+            mTarget->deallocate(p, size);
+            return;
+        }
+        // the list of the size was made when the block was allocated
+        std::size_t index = roundUp(size) / Alignment;
+        FreeBlock *block = static_cast<FreeBlock *>(p);
+        block->mNext = mFreeLists[index];
+        mFreeLists[index] = block;
+    }
+
+    /*!
+     * Creates an allocator which can be used by another thread while this one is in use
+     * @return The new allocator, which should be given back using join
+     */
+    SlabAllocator *fork() {
+        return new SlabAllocator();
+    }
+
+    /*!
+     * Takes over the slabs and the free blocks of an allocator created by fork.
+     * The forked allocator passes its later allocations and deallocations to this one,
+     * so the objects it allocated can still refer to it. It is destroyed by release
+     * @param forked The allocator returned by fork
+     */
+    void join(SlabAllocator *forked) {
+        mSlabs.insert(mSlabs.end(), forked->mSlabs.begin(), forked->mSlabs.end());
+        if (mFreeLists.size() < forked->mFreeLists.size()) {
+            mFreeLists.resize(forked->mFreeLists.size(), (FreeBlock *)0);
+        }
+        for (std::size_t i = 0; i < forked->mFreeLists.size(); ++i) {
+            for (FreeBlock *block = forked->mFreeLists[i]; block;) {
+                FreeBlock *next = block->mNext;
+                block->mNext = mFreeLists[i];
+                mFreeLists[i] = block;
+                block = next;
+            }
+        }
+        forked->mSlabs.clear();
+        forked->mFreeLists.clear();
+        forked->mCurrent = 0;
+        forked->mRemaining = 0;
+        forked->mTarget = this;
+        mForks.push_back(forked);
+    }
+
+    void release() {
+        for (std::size_t i = 0; i < mForks.size(); ++i) {
+            delete mForks[i];
+        }
+        mForks.clear();
+        for (std::size_t i = 0; i < mSlabs.size(); ++i) {
+            ::operator delete(mSlabs[i]);
+        }
+        mSlabs.clear();
+        mFreeLists.clear();
+        mCurrent = 0;
+        mRemaining = 0;
+    }
+
+private:
+    SlabAllocator(SlabAllocator const &);
+    SlabAllocator &operator=(SlabAllocator const &);
+
+    static std::size_t roundUp(std::size_t size) {
+        if (size < sizeof(FreeBlock)) {
+            size = sizeof(FreeBlock);
+        }
+        return (size + Alignment - 1) & ~(std::size_t)(Alignment - 1);
+    }
+
+private:
+    std::vector<char *> mSlabs;
+    std::vector<FreeBlock *> mFreeLists;
+    char *mCurrent;
+    std::size_t mRemaining;
+    // Allocators joined in to this one and the allocator this one was joined in to
+    std::vector<SlabAllocator *> mForks;
+    SlabAllocator *mTarget;
+};
+
+/*!
+ * @brief Owner of the allocator of a Trie.
+ *
+ * The Trie declares it before its root node, so the allocator is destroyed after the nodes are given back to it.
+ * A Trie moved from owns no allocator, it makes one with create the next time it adds a key.
+ * @tparam A Allocator of the nodes
+ */
+template <typename A> class AllocatorOwner
+{
+public:
+    AllocatorOwner()
+            : mAllocator(new A()) {}
+
+    // Owns allocator, which may be null
+    explicit AllocatorOwner(A *allocator)
+            : mAllocator(allocator) {}
+
+    ~AllocatorOwner() {
+        delete mAllocator;
+    }
+
+    A *get() const {
+        return mAllocator;
+    }
+
+    // Makes the allocator if there is none yet
+    A *create() {
+        if (!mAllocator) {
+            mAllocator = new A();
+        }
+        return mAllocator;
+    }
+
+    void swap(AllocatorOwner &oth) {
+        std::swap(mAllocator, oth.mAllocator);
+    }
+
+private:
+    AllocatorOwner(AllocatorOwner const &);
+    AllocatorOwner &operator=(AllocatorOwner const &);
+
+private:
+    A *mAllocator;
+};
+
+/*!
+ * @brief Standard allocator taking its memory from the allocator of a Trie, for the containers kept in the nodes.
+ *
+ * Copies share the allocator of the Trie and it moves with the memory when the containers are swapped.
+ * Without an allocator of the Trie the memory comes from the global new and delete operators.
+ * @tparam U Type of the objects allocated
+ * @tparam A Allocator of the nodes
+ */
+template < typename U,
+typename A > class NodeAllocator
+{
+public:
+    typedef U value_type;
+    typedef U *pointer;
+    typedef const U *const_pointer;
+    typedef U &reference;
+    typedef const U &const_reference;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+#ifdef RTV_HAS_CXX11
+    typedef std::true_type propagate_on_container_copy_assignment;
+    typedef std::true_type propagate_on_container_move_assignment;
+    typedef std::true_type propagate_on_container_swap;
+#endif
+
+    template <typename O> struct rebind {
+        typedef NodeAllocator<O, A> other;
+    };
+
+    explicit NodeAllocator(A *allocator)
+            : mAllocator(allocator) {}
+
+    template <typename O>
+    NodeAllocator(NodeAllocator<O, A> const &oth)
+            : mAllocator(oth.allocator()) {}
+
+    pointer allocate(size_type n, const void * = 0) {
+        if (!mAllocator) {
+            return static_cast<pointer>(::operator new(n * sizeof(U)));
+        }
+        return static_cast<pointer>(mAllocator->allocate(n * sizeof(U)));
+    }
+
+    void deallocate(pointer p, size_type n) {
+        if (!mAllocator) {
+            ::operator delete(p);
+        } else {
+            mAllocator->deallocate(p, n * sizeof(U));
+        }
+    }
+
+    size_type max_size() const {
+        return static_cast<size_type>(-1) / sizeof(U);
+    }
+
+    pointer address(reference r) const {
+        return &r;
+    }
+
+    const_pointer address(const_reference r) const {
+        return &r;
+    }
+
+#ifndef RTV_HAS_CXX11
+    void construct(pointer p, const U &value) {
+        new (p) U(value);
+    }
+
+    void destroy(pointer p) {
+        p->~U();
+    }
+#endif
+
+    A *allocator() const {
+        return mAllocator;
+    }
+
+    bool operator==(NodeAllocator const &oth) const {
+        return mAllocator == oth.mAllocator;
+    }
+
+    bool operator!=(NodeAllocator const &oth) const {
+        return mAllocator != oth.mAllocator;
+    }
+
+private:
+    A *mAllocator;
+};
+
+/*!
+ *
+ */
+template <typename T> class SymbolToIndexMapper
+{
+public:
+    unsigned int operator()(const T & c) const {
+        return static_cast<unsigned int>(c);
+    }
+};
+
+/*!
+ * @brief Container representing each node in the Trie.
+ *
+ *
+ * With this class the items of a node are kept in an array of size Max, allocated from A
+ * when the first item is added and given back when the last one is erased.
+ * Here each node having items will use a space propotional to Max.
+ * For searching only constant time taken at each node.
+ * @tparam T Type for each element in the key
+ * @tparam V Type of the value that the key will be representing
+ * @tparam Cmp Comparison functor
+ * @tparam Max Maximum element that a Trie node can have
+ * @tparam M Functor which maps a symbol to its index in the array
+ * @tparam A Allocator used for the nodes, node items and item arrays, rtv::HeapAllocator or rtv::SlabAllocator
+ */
+template < typename T,
+typename V,
+typename Cmp,
+int Max = 256,
+typename M = SymbolToIndexMapper<T>,
+typename A = HeapAllocator > class VectorItems
+{
+public:
+    typedef A Allocator;
+    typedef NodeItem<T, V, Cmp, VectorItems<T, V, Cmp, Max, M, A> > Item;
+    typedef Item **iterator;
+    typedef Item * const *const_iterator;
+    typedef Node<T, V, Cmp, VectorItems<T, V, Cmp, Max, M, A> > NodeClass;
+    typedef typename NodeClass::NodeItemClass NodeItemClass;
+
+public:
+    VectorItems(T const &endSymbol, Allocator *allocator)
+            : mEndSymbol(endSymbol),
+            mItems(0),
+            mCount(0),
+            mAllocator(allocator) {}
+
+    ~VectorItems() {
+        releaseArray();
+    }
+
+    Allocator *allocator() const {
+        return mAllocator;
+    }
+
+    const_iterator find(const T & k) const {
+        const Item * item = getItem(k);
+        if (item) {
+            return mItems + mSymolToIndex(k);
+        }
+        return end();
+    }
+
+    iterator find(const T & k) {
+        const Item * item = getItem(k);
+        if (item) {
+            return mItems + mSymolToIndex(k);
+        }
+        return end();
+    }
+
+    iterator begin() {
+        return mItems;
+    }
+
+    const_iterator begin() const {
+        return mItems;
+    }
+
+    iterator end() {
+        return mItems ? mItems + Max : mItems;
+    }
+
+    const_iterator end() const {
+        return mItems ? mItems + Max : mItems;
+    }
+
+    void clear() {
+        releaseArray();
+        mCount = 0;
+    }
+
+    void swap(VectorItems &oth) {
+        std::swap(mEndSymbol, oth.mEndSymbol);
+        std::swap(mItems, oth.mItems);
+        std::swap(mCount, oth.mCount);
+        std::swap(mSymolToIndex, oth.mSymolToIndex);
+        std::swap(mAllocator, oth.mAllocator);
+    }
+
+    bool empty() const {
+        return mCount == 0;
+    }
+
+    // Number of items in the node
+    unsigned int childCount() const {
+        return mCount;
+    }
+
+    // Called by the node before any item is added, depth is the number of key symbols above the node
+    void setDepth(unsigned int) {}
+
+    // The depth is only kept by rtv::HybridItems
+    unsigned int depth() const {
+        return 0;
+    }
+
+    // Returns the item of the symbol and true if it is created
+    std::pair<Item *, bool> insertItem(T const &k) {
+        std::pair<Item *, bool> ret(getItem(k), false);
+        if (!ret.first) {
+            ret.first = createNodeItem(k);
+            ret.second = true;
+            attachItem(ret.first);
+        }
+        return ret;
+    }
+
+    bool eraseItem(T const &k) {
+        Item * item = getItem(k);
+        if (item) {
+            NodeClass::destroyItem(mAllocator, item);
+            assignItem(k, (Item *)0);
+            if (!mCount) {
+                releaseArray();
+            }
+            return true;
+        } else {
+            return false;
+        }
+    }
+
+    Item *getItem(T const &k) {
+        return mItems ? mItems[mSymolToIndex(k)] : 0;
+    }
+
+    const Item *getItem(T const &k) const {
+        return mItems ? mItems[mSymolToIndex(k)] : 0;
+    }
+
+    void prefetchItem(T const &k) const {
+        if (mItems) {
+            RTV_PREFETCH(mItems + mSymolToIndex(k));
+        }
+    }
+
+    void assignItem(T k, Item *i) {
+        if (!mItems) {
+            if (!i) {
+                return;
+            }
+            mItems = static_cast<Item **>(mAllocator->allocate(Max * sizeof(Item *)));
+            std::fill(mItems, mItems + Max, (Item *)0);
+        }
+        Item *&slot = mItems[mSymolToIndex(k)];
+        if (!slot && i) {
+            ++mCount;
+        } else if (slot && !i) {
+            --mCount;
+        }
+        slot = i;
+    }
+
+    // Adds an item created by the caller, there should not be an item with the same key
+    void attachItem(Item *item) {
+        assignItem(item->get(), item);
+    }
+
+    NodeItemClass *createNodeItem(T const &k) {
+        return NodeClass::createItem(mAllocator, k);
+    }
+
+private:
+    VectorItems(VectorItems const &);
+    VectorItems &operator=(VectorItems const &);
+
+    void releaseArray() {
+        if (mItems) {
+            mAllocator->deallocate(mItems, Max * sizeof(Item *));
+            mItems = 0;
+        }
+    }
+
+protected:
+    T mEndSymbol;
+    // Max items indexed by M, 0 until the first item is added
+    Item **mItems;
+    unsigned int mCount;
+    M mSymolToIndex;
+    Allocator *mAllocator;
+};
+
+/*!
+ * @brief Container representing each node in the Trie.
+ *
+ *
+ * With this class the container used for storing node item is STL set,
+ * whose nodes are allocated from A through rtv::NodeAllocator.
+ * Here no extra space will used for storing node item.
+ * For searching in each node the time taken is propotional to number of item in the node.
+ * @tparam T Type for each element in the key
+ * @tparam V Type of the value that the key will be representing
+ * @tparam Cmp Comparison functor
+ * @tparam A Allocator used for the nodes, node items and set nodes, rtv::HeapAllocator or rtv::SlabAllocator
+ */
+template < typename T,
+typename V,
+typename Cmp,
+typename A = HeapAllocator > class SetItems
+{
+public:
+    typedef A Allocator;
+    typedef NodeItem<T, V, Cmp, SetItems<T, V, Cmp, A> > Item;
+    typedef std::set<Item *, NodeItemPtrCompare<T, V, Cmp, SetItems<T, V, Cmp, A> >, NodeAllocator<Item *, A> > Items;
+    typedef typename Items::iterator iterator;
+    typedef typename Items::const_iterator const_iterator;
+    typedef Node<T, V, Cmp, SetItems<T, V, Cmp, A> > NodeClass;
+    typedef typename NodeClass::NodeItemClass NodeItemClass;
+
+public:
+    SetItems(T const &endSymbol, Allocator *allocator)
+            : mEndSymbol(endSymbol),
+            mItems(typename Items::key_compare(), NodeAllocator<Item *, A>(allocator)),
+            mAllocator(allocator) {}
+
+    Allocator *allocator() const {
+        return mAllocator;
+    }
+
+    const_iterator find(const T & k) const {
+        return const_cast<SetItems<T, V, Cmp, A> *>(this)->find(k);
+    }
+
+    iterator find(const T & k) {
+        Item tmp(k);
+        return mItems.find(&tmp);
+    }
+
+    iterator begin() {
+        return mItems.begin();
+    }
+
+    const_iterator begin() const {
+        return mItems.begin();
+    }
+
+    iterator end() {
+        return mItems.end();
+    }
+
+    const_iterator end() const {
+        return mItems.end();
+    }
+
+    bool empty() const {
+        return mItems.empty();
+    }
+
+    // Number of items in the node
+    unsigned int childCount() const {
+        return mItems.size();
+    }
+
+    void clear() {
+        mItems.clear();
+    }
+
+    void swap(SetItems &oth) {
+        std::swap(mEndSymbol, oth.mEndSymbol);
+        mItems.swap(oth.mItems);
+        std::swap(mAllocator, oth.mAllocator);
+    }
+
+    // Called by the node before any item is added, depth is the number of key symbols above the node
+    void setDepth(unsigned int) {}
+
+    // The depth is only kept by rtv::HybridItems
+    unsigned int depth() const {
+        return 0;
+    }
+
+    // Returns the item of the symbol and true if it is created
+    std::pair<Item *, bool> insertItem(T const &k) {
+        std::pair<Item *, bool> ret((Item*)0, false);
+        Item tmp(k);
+        iterator iter = mItems.find(&tmp);
+        if (iter == mItems.end()) {
+            Item *v = createNodeItem(k);
+            attachItem(v);
+            ret.first = v;
+            ret.second = true;
+        } else {
+            ret.first = (Item *) * iter;
+        }
+        return ret;
+    }
+
+    // Adds an item created by the caller, there should not be an item with the same key
+    void attachItem(Item *item) {
+        // constant time when the items are added in order
+        mItems.insert(mItems.end(), item);
+    }
+
+    bool eraseItem(T const &k) {
+        Item tmp(k);
+        iterator iter = mItems.find(&tmp);
+        if (iter != mItems.end()) {
+            NodeClass::destroyItem(mAllocator, *iter);
+            mItems.erase(iter);
+            return true;
+        } else {
+            return false;
+        }
+    }
+
+    const Item *getItem(T const &k) const {
+        return const_cast<SetItems *>(this)->getItem(k);
+    }
+
+    Item *getItem(T const &k) {
+        Item tmp(k);
+
+        iterator iter = mItems.find(&tmp);
+        if (iter == mItems.end()) {
+            return 0;
+        }
+        return (Item *)(*iter);
+    }
+
+    void prefetchItem(T const &) const {
+        // the nodes of std::set are not reachable without searching
+    }
+
+    NodeItemClass *createNodeItem(T const &k) {
+        return NodeClass::createItem(mAllocator, k);
+    }
+
+protected:
+    T mEndSymbol;
+    Items mItems;
+    Allocator *mAllocator;
+};
+
+/*!
+ * @brief Iterator of the Items classes which keep their items at positions, the item at a position
+ * is given by itemAt and may be 0 for an empty slot.
+ */
+template <typename Items, typename Item> class ItemsIterator
+{
+public:
+    ItemsIterator()
+            : mItems(0),
+            mPos(0) {}
+
+    ItemsIterator(const Items *items, unsigned int pos)
+            : mItems(items),
+            mPos(pos) {}
+
+    Item *operator*() const {
+        return mItems->itemAt(mPos);
+    }
+
+    ItemsIterator &operator++() {
+        ++mPos;
+        return *this;
+    }
+
+    ItemsIterator operator++(int) {
+        ItemsIterator iter = *this;
+        ++mPos;
+        return iter;
+    }
+
+    ItemsIterator &operator--() {
+        --mPos;
+        return *this;
+    }
+
+    ItemsIterator operator--(int) {
+        ItemsIterator iter = *this;
+        --mPos;
+        return iter;
+    }
+
+    bool operator==(ItemsIterator const &oth) const {
+        return mItems == oth.mItems && mPos == oth.mPos;
+    }
+
+    bool operator!=(ItemsIterator const &oth) const {
+        return !(*this == oth);
+    }
+
+private:
+    const Items *mItems;
+    unsigned int mPos;
+};
+
+/*!
+ * @brief Container representing each node in the Trie.
+ *
+ *
+ * With this class each node adapts its layout to the number of items it holds.
+ * A node with up to 4 or 16 items keeps them in sorted arrays, a node with up to 48 items
+ * uses an index array of size Max pointing into 48 slots and a larger node uses an array of size Max.
+ * The layout grows and shrinks as items are inserted and erased, so the space used is propotional
+ * to the number of items in the node while searching takes constant or near constant time.
+ * @tparam T Type for each element in the key
+ * @tparam V Type of the value that the key will be representing
+ * @tparam Cmp Comparison functor
+ * @tparam Max Maximum element that a Trie node can have
+ * @tparam M Functor which maps a symbol to its index in the node
+ * @tparam A Allocator used for the nodes, node items and node layouts
+ */
+template < typename T,
+typename V,
+typename Cmp,
+int Max = 256,
+typename M = SymbolToIndexMapper<T>,
+typename A = HeapAllocator > class AdaptiveItems
+{
+public:
+    typedef A Allocator;
+    typedef NodeItem<T, V, Cmp, AdaptiveItems<T, V, Cmp, Max, M, A> > Item;
+    typedef Node<T, V, Cmp, AdaptiveItems<T, V, Cmp, Max, M, A> > NodeClass;
+    typedef typename NodeClass::NodeItemClass NodeItemClass;
+
+private:
+    enum Kind {
+        Kind4,
+        Kind16,
+        Kind48,
+        KindFull
+    };
+
+    friend class ItemsIterator<AdaptiveItems, Item>;
+
+public:
+    typedef ItemsIterator<AdaptiveItems, Item> Iterator;
+    typedef Iterator iterator;
+    typedef Iterator const_iterator;
+
+    AdaptiveItems(T const &endSymbol, Allocator *allocator)
+            : mEndSymbol(endSymbol),
+            mKind(smallestKind()),
+            mCount(0),
+            mChilds(0),
+            mIndexes(0),
+            mSlots(0),
+            mAllocator(allocator) {}
+
+    ~AdaptiveItems() {
+        releaseLayout();
+    }
+
+    Allocator *allocator() const {
+        return mAllocator;
+    }
+
+    const_iterator find(const T & k) const {
+        unsigned int index = mSymolToIndex(k);
+        int pos = position(index);
+        if (pos >= 0) {
+            return Iterator(this, pos);
+        }
+        return end();
+    }
+
+    iterator begin() const {
+        return Iterator(this, 0);
+    }
+
+    iterator end() const {
+        return Iterator(this, limit());
+    }
+
+    void clear() {
+        releaseLayout();
+        mKind = smallestKind();
+        mCount = 0;
+    }
+
+    void swap(AdaptiveItems &oth) {
+        std::swap(mEndSymbol, oth.mEndSymbol);
+        std::swap(mKind, oth.mKind);
+        std::swap(mCount, oth.mCount);
+        std::swap(mChilds, oth.mChilds);
+        std::swap(mIndexes, oth.mIndexes);
+        std::swap(mSlots, oth.mSlots);
+        std::swap(mSymolToIndex, oth.mSymolToIndex);
+        std::swap(mAllocator, oth.mAllocator);
+    }
+
+    bool empty() const {
+        return mCount == 0;
+    }
+
+    // Number of items in the node
+    unsigned int childCount() const {
+        return mCount;
+    }
+
+    // Called by the node before any item is added, depth is the number of key symbols above the node
+    void setDepth(unsigned int) {}
+
+    // The depth is only kept by rtv::HybridItems
+    unsigned int depth() const {
+        return 0;
+    }
+
+    // Returns the item of the symbol and true if it is created
+    std::pair<Item *, bool> insertItem(T const &k) {
+        std::pair<Item *, bool> ret(getItem(k), false);
+        if (!ret.first) {
+            ret.first = createNodeItem(k);
+            ret.second = true;
+            attachItem(ret.first);
+        }
+        return ret;
+    }
+
+    // Adds an item created by the caller, there should not be an item with the same key
+    void attachItem(Item *item) {
+        if (!mChilds || mCount == capacity(mKind)) {
+            resize(mChilds ? nextKind(mKind) : mKind);
+        }
+        place(mSymolToIndex(item->get()), item);
+        ++mCount;
+    }
+
+    bool eraseItem(T const &k) {
+        unsigned int index = mSymolToIndex(k);
+        int pos = position(index);
+        if (pos < 0) {
+            return false;
+        }
+        NodeClass::destroyItem(mAllocator, itemAt(pos));
+        remove(index, pos);
+        --mCount;
+
+        if (!mCount) {
+            clear();
+        } else {
+            Kind kind = shrinkKind();
+            if (kind != mKind) {
+                resize(kind);
+            }
+        }
+        return true;
+    }
+
+    Item *getItem(T const &k) const {
+        int pos = position(mSymolToIndex(k));
+        if (pos >= 0) {
+            return itemAt(pos);
+        }
+        return 0;
+    }
+
+    void prefetchItem(T const &k) const {
+        if (!mChilds) {
+            return;
+        }
+        switch (mKind) {
+        case Kind4:
+        case Kind16:
+            RTV_PREFETCH(mIndexes);
+            break;
+        case Kind48:
+            RTV_PREFETCH(mSlots + mSymolToIndex(k));
+            break;
+        default:
+            RTV_PREFETCH(mChilds + mSymolToIndex(k));
+            break;
+        }
+    }
+
+    NodeItemClass *createNodeItem(T const &k) {
+        return NodeClass::createItem(mAllocator, k);
+    }
+
+private:
+    AdaptiveItems(AdaptiveItems const &);
+    AdaptiveItems &operator=(AdaptiveItems const &);
+
+    static unsigned int capacity(Kind kind) {
+        switch (kind) {
+        case Kind4:
+            return 4;
+        case Kind16:
+            return 16;
+        case Kind48:
+            return 48;
+        default:
+            return Max;
+        }
+    }
+
+    static bool usable(Kind kind) {
+        return kind == KindFull || capacity(kind) < (unsigned int)Max;
+    }
+
+    static Kind smallestKind() {
+        return usable(Kind4) ? Kind4 : nextKind(Kind4);
+    }
+
+    static Kind nextKind(Kind kind) {
+        Kind next = static_cast<Kind>(kind + 1);
+        while (!usable(next)) {
+            next = static_cast<Kind>(next + 1);
+        }
+        return next;
+    }
+
+    // smallest layout which holds the items with some room left, so that
+    // alternating insert and erase does not resize the node every time
+    Kind shrinkKind() const {
+        for (Kind kind = Kind4; kind < mKind; kind = static_cast<Kind>(kind + 1)) {
+            if (usable(kind) && mCount <= capacity(kind) * 3 / 4) {
+                return kind;
+            }
+        }
+        return mKind;
+    }
+
+    static std::size_t layoutSize(Kind kind) {
+        switch (kind) {
+        case Kind4:
+        case Kind16:
+            return capacity(kind) * (sizeof(Item *) + sizeof(unsigned int));
+        case Kind48:
+            return 48 * sizeof(Item *) + Max * sizeof(unsigned char);
+        default:
+            return Max * sizeof(Item *);
+        }
+    }
+
+    unsigned int limit() const {
+        if (!mChilds) {
+            return 0;
+        }
+        return (mKind == Kind4 || mKind == Kind16) ? mCount : Max;
+    }
+
+    Item *itemAt(unsigned int pos) const {
+        switch (mKind) {
+        case Kind48:
+            return mSlots[pos] ? mChilds[mSlots[pos] - 1] : 0;
+        default:
+            return mChilds[pos];
+        }
+    }
+
+    int position(unsigned int index) const {
+        if (!mChilds) {
+            return -1;
+        }
+        switch (mKind) {
+        case Kind4:
+            for (unsigned int i = 0; i < mCount; ++i) {
+                if (mIndexes[i] == index) {
+                    return i;
+                }
+            }
+            return -1;
+        case Kind16: {
+            const unsigned int *pos = std::lower_bound(mIndexes, mIndexes + mCount, index);
+            if (pos != mIndexes + mCount && *pos == index) {
+                return pos - mIndexes;
+            }
+            return -1;
+        }
+        case Kind48:
+            return mSlots[index] ? (int)index : -1;
+        default:
+            return mChilds[index] ? (int)index : -1;
+        }
+    }
+
+    void place(unsigned int index, Item *item) {
+        switch (mKind) {
+        case Kind4:
+        case Kind16: {
+            unsigned int i = mCount;
+            for (; i > 0 && mIndexes[i - 1] > index; --i) {
+                mIndexes[i] = mIndexes[i - 1];
+                mChilds[i] = mChilds[i - 1];
+            }
+            mIndexes[i] = index;
+            mChilds[i] = item;
+            break;
+        }
+        case Kind48:
+            mChilds[mCount] = item;
+            mSlots[index] = static_cast<unsigned char>(mCount + 1);
+            break;
+        default:
+            mChilds[index] = item;
+            break;
+        }
+    }
+
+    void remove(unsigned int index, unsigned int pos) {
+        switch (mKind) {
+        case Kind4:
+        case Kind16:
+            for (unsigned int i = pos + 1; i < mCount; ++i) {
+                mIndexes[i - 1] = mIndexes[i];
+                mChilds[i - 1] = mChilds[i];
+            }
+            break;
+        case Kind48: {
+            // keep the slots dense by moving the last slot into the freed one
+            unsigned int slot = mSlots[index] - 1;
+            unsigned int last = mCount - 1;
+            if (slot != last) {
+                mChilds[slot] = mChilds[last];
+                mSlots[mSymolToIndex(mChilds[slot]->get())] = static_cast<unsigned char>(slot + 1);
+            }
+            mSlots[index] = 0;
+            break;
+        }
+        default:
+            mChilds[index] = 0;
+            break;
+        }
+    }
+
+    void resize(Kind kind) {
+        Item **oldChilds = mChilds;
+        unsigned int *oldIndexes = mIndexes;
+        unsigned char *oldSlots = mSlots;
+        Kind oldKind = mKind;
+        unsigned int count = mCount;
+
+        char *layout = static_cast<char *>(mAllocator->allocate(layoutSize(kind)));
+        mKind = kind;
+        mChilds = reinterpret_cast<Item **>(layout);
+        mIndexes = 0;
+        mSlots = 0;
+        switch (kind) {
+        case Kind4:
+        case Kind16:
+            mIndexes = reinterpret_cast<unsigned int *>(layout + capacity(kind) * sizeof(Item *));
+            break;
+        case Kind48:
+            mSlots = reinterpret_cast<unsigned char *>(layout + 48 * sizeof(Item *));
+            std::fill(mSlots, mSlots + Max, (unsigned char)0);
+            break;
+        default:
+            std::fill(mChilds, mChilds + Max, (Item *)0);
+            break;
+        }
+
+        if (oldChilds) {
+            mCount = 0;
+            for (unsigned int index = 0; mCount < count; ++index) {
+                Item *item = 0;
+                switch (oldKind) {
+                case Kind4:
+                case Kind16:
+                    item = oldChilds[index];
+                    break;
+                case Kind48:
+                    item = oldSlots[index] ? oldChilds[oldSlots[index] - 1] : 0;
+                    break;
+                default:
+                    item = oldChilds[index];
+                    break;
+                }
+                if (item) {
+                    place(oldIndexes ? oldIndexes[index] : index, item);
+                    ++mCount;
+                }
+            }
+            mAllocator->deallocate(oldChilds, layoutSize(oldKind));
+        }
+    }
+
+    void releaseLayout() {
+        if (mChilds) {
+            mAllocator->deallocate(mChilds, layoutSize(mKind));
+            mChilds = 0;
+            mIndexes = 0;
+            mSlots = 0;
+        }
+    }
+
+protected:
+    T mEndSymbol;
+    Kind mKind;
+    unsigned int mCount;
+    Item **mChilds;
+    unsigned int *mIndexes;
+    unsigned char *mSlots;
+    M mSymolToIndex;
+    Allocator *mAllocator;
+};
+
+/*!
+ * @brief Counting and finding the set bits of 32 bit words.
+ */
+class Bits
+{
+public:
+    static unsigned int popCount(unsigned int word) {
+#if defined(__GNUC__)
+        return (unsigned int)__builtin_popcount(word);
+#else
+        word = word - ((word >> 1) & 0x55555555u);
+        word = (word & 0x33333333u) + ((word >> 2) & 0x33333333u);
+        return (((word + (word >> 4)) & 0x0f0f0f0fu) * 0x01010101u) >> 24;
+#endif
+    }
+
+    // Position of the lowest set bit, the word is not 0
+    static unsigned int lowestBit(unsigned int word) {
+#if defined(__GNUC__)
+        return (unsigned int)__builtin_ctz(word);
+#else
+        unsigned int bit = 0;
+        for (; !(word & 1u); word >>= 1) {
+            ++bit;
+        }
+        return bit;
+#endif
+    }
+};
+
+/*!
+ * @brief Searches a symbol among symbols sorted by Cmp, used by rtv::SortedArrayItems.
+ *
+ * This is a binary search with Cmp. It is specialized below for the integer symbols
+ * compared by std::less, where the equal symbol can be found by comparing a block of symbols at once.
+ */
+template <typename T, typename Cmp> class SortedSymbolSearch
+{
+public:
+    enum {
+        // symbols are read in blocks of this many, the array of symbols is padded to a multiple of it
+        Lanes = 1
+    };
+
+    // Position of the symbol among the count symbols, -1 if it is not there
+    static int find(const T *symbols, unsigned int count, T const &symbol) {
+        Cmp cmp;
+        const T *pos = std::lower_bound(symbols, symbols + count, symbol, cmp);
+        if (pos != symbols + count && !cmp(symbol, *pos)) {
+            return pos - symbols;
+        }
+        return -1;
+    }
+};
+
+#ifdef RTV_HAS_SSE2
+/*!
+ * @brief Compares a block of symbols of Size bytes each with one symbol,
+ * giving a mask with the bits of the bytes of the equal symbols set.
+ */
+template <std::size_t Size> class SimdEquals;
+
+#ifdef RTV_HAS_AVX2
+template <> class SimdEquals<1>
+{
+public:
+    typedef char Lane;
+
+    static unsigned int mask(const void *block, Lane symbol) {
+        __m256i symbols = _mm256_loadu_si256(static_cast<const __m256i *>(block));
+        return (unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(symbols, _mm256_set1_epi8(symbol)));
+    }
+};
+
+template <> class SimdEquals<2>
+{
+public:
+    typedef short Lane;
+
+    static unsigned int mask(const void *block, Lane symbol) {
+        __m256i symbols = _mm256_loadu_si256(static_cast<const __m256i *>(block));
+        return (unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi16(symbols, _mm256_set1_epi16(symbol)));
+    }
+};
+
+template <> class SimdEquals<4>
+{
+public:
+    typedef int Lane;
+
+    static unsigned int mask(const void *block, Lane symbol) {
+        __m256i symbols = _mm256_loadu_si256(static_cast<const __m256i *>(block));
+        return (unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi32(symbols, _mm256_set1_epi32(symbol)));
+    }
+};
+#else
+template <> class SimdEquals<1>
+{
+public:
+    typedef char Lane;
+
+    static unsigned int mask(const void *block, Lane symbol) {
+        __m128i symbols = _mm_loadu_si128(static_cast<const __m128i *>(block));
+        return (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(symbols, _mm_set1_epi8(symbol)));
+    }
+};
+
+template <> class SimdEquals<2>
+{
+public:
+    typedef short Lane;
+
+    static unsigned int mask(const void *block, Lane symbol) {
+        __m128i symbols = _mm_loadu_si128(static_cast<const __m128i *>(block));
+        return (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi16(symbols, _mm_set1_epi16(symbol)));
+    }
+};
+
+template <> class SimdEquals<4>
+{
+public:
+    typedef int Lane;
+
+    static unsigned int mask(const void *block, Lane symbol) {
+        __m128i symbols = _mm_loadu_si128(static_cast<const __m128i *>(block));
+        return (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi32(symbols, _mm_set1_epi32(symbol)));
+    }
+};
+#endif
+
+/*!
+ * @brief Search of integer symbols ordered by std::less.
+ *
+ * The range holding the symbol is halved until it spans at most Lanes symbols,
+ * then the one or two blocks covering it are compared with the symbol by SSE2 or AVX2.
+ */
+template <typename T> class SimdSymbolSearch
+{
+public:
+    enum {
+#ifdef RTV_HAS_AVX2
+        BlockBytes = 32,
+#else
+        BlockBytes = 16,
+#endif
+        Lanes = BlockBytes / sizeof(T)
+    };
+
+    static int find(const T *symbols, unsigned int count, T const &symbol) {
+        typedef SimdEquals<sizeof(T)> Equals;
+
+        // the symbol is at [first, last) if it is there, the symbols are unique
+        unsigned int first = 0;
+        unsigned int last = count;
+        while (last - first > (unsigned int)Lanes) {
+            unsigned int middle = first + (last - first) / 2;
+            if (symbols[middle] < symbol) {
+                first = middle + 1;
+            } else {
+                last = middle + 1;
+            }
+        }
+        for (unsigned int block = first / Lanes * Lanes; block < last; block += Lanes) {
+            unsigned int mask = Equals::mask(symbols + block, static_cast<typename Equals::Lane>(symbol));
+            // the padding after the last symbol holds anything
+            if (count - block < (unsigned int)Lanes) {
+                mask &= (1u << ((count - block) * sizeof(T))) - 1;
+            }
+            if (mask) {
+                return block + Bits::lowestBit(mask) / sizeof(T);
+            }
+        }
+        return -1;
+    }
+};
+
+template <> class SortedSymbolSearch<char, std::less<char> > : public SimdSymbolSearch<char> {};
+template <> class SortedSymbolSearch<signed char, std::less<signed char> > : public SimdSymbolSearch<signed char> {};
+template <> class SortedSymbolSearch<unsigned char, std::less<unsigned char> > : public SimdSymbolSearch<unsigned char> {};
+template <> class SortedSymbolSearch<short, std::less<short> > : public SimdSymbolSearch<short> {};
+template <> class SortedSymbolSearch<unsigned short, std::less<unsigned short> > : public SimdSymbolSearch<unsigned short> {};
+template <> class SortedSymbolSearch<int, std::less<int> > : public SimdSymbolSearch<int> {};
+template <> class SortedSymbolSearch<unsigned int, std::less<unsigned int> > : public SimdSymbolSearch<unsigned int> {};
+template <> class SortedSymbolSearch<wchar_t, std::less<wchar_t> > : public SimdSymbolSearch<wchar_t> {};
+#endif
+
+/*!
+ * @brief Container representing each node in the Trie.
+ *
+ *
+ * With this class the symbols of the items of a node are kept in a sorted array next to an array
+ * of the items, both in a single block which grows and shrinks by halves.
+ * Here the space used is propotional to the number of items in the node, and searching
+ * reads only the contiguous symbols. When T is an integer type such as char, unsigned char
+ * or unsigned short and Cmp is std::less the symbols are compared by SSE2 or AVX2 if available,
+ * otherwise a symbol is searched by binary search with Cmp.
+ * @tparam T Type for each element in the key
+ * @tparam V Type of the value that the key will be representing
+ * @tparam Cmp Comparison functor
+ * @tparam A Allocator used for the nodes, node items and node arrays, rtv::HeapAllocator or rtv::SlabAllocator
+ */
+template < typename T,
+typename V,
+typename Cmp,
+typename A = HeapAllocator > class SortedArrayItems
+{
+public:
+    typedef A Allocator;
+    typedef NodeItem<T, V, Cmp, SortedArrayItems<T, V, Cmp, A> > Item;
+    typedef Node<T, V, Cmp, SortedArrayItems<T, V, Cmp, A> > NodeClass;
+    typedef typename NodeClass::NodeItemClass NodeItemClass;
+
+private:
+    typedef SortedSymbolSearch<T, Cmp> Search;
+
+    friend class ItemsIterator<SortedArrayItems, Item>;
+
+public:
+    typedef ItemsIterator<SortedArrayItems, Item> Iterator;
+    typedef Iterator iterator;
+    typedef Iterator const_iterator;
+
+    SortedArrayItems(T const &endSymbol, Allocator *allocator)
+            : mEndSymbol(endSymbol),
+            mCount(0),
+            mCapacity(0),
+            mChilds(0),
+            mAllocator(allocator) {}
+
+    ~SortedArrayItems() {
+        releaseArray();
+    }
+
+    Allocator *allocator() const {
+        return mAllocator;
+    }
+
+    const_iterator find(const T & k) const {
+        int pos = position(k);
+        if (pos >= 0) {
+            return Iterator(this, pos);
+        }
+        return end();
+    }
+
+    iterator begin() const {
+        return Iterator(this, 0);
+    }
+
+    iterator end() const {
+        return Iterator(this, mCount);
+    }
+
+    void clear() {
+        releaseArray();
+        mCount = 0;
+    }
+
+    void swap(SortedArrayItems &oth) {
+        std::swap(mEndSymbol, oth.mEndSymbol);
+        std::swap(mCount, oth.mCount);
+        std::swap(mCapacity, oth.mCapacity);
+        std::swap(mChilds, oth.mChilds);
+        std::swap(mAllocator, oth.mAllocator);
+    }
+
+    bool empty() const {
+        return mCount == 0;
+    }
+
+    // Number of items in the node
+    unsigned int childCount() const {
+        return mCount;
+    }
+
+    // Called by the node before any item is added, depth is the number of key symbols above the node
+    void setDepth(unsigned int) {}
+
+    // The depth is only kept by rtv::HybridItems
+    unsigned int depth() const {
+        return 0;
+    }
+
+    // Returns the item of the symbol and true if it is created
+    std::pair<Item *, bool> insertItem(T const &k) {
+        unsigned int pos = lowerBound(k);
+        if (pos < mCount && !Cmp()(k, symbols()[pos])) {
+            return std::pair<Item *, bool>(mChilds[pos], false);
+        }
+        Item *item = createNodeItem(k);
+        place(pos, item);
+        return std::pair<Item *, bool>(item, true);
+    }
+
+    // Adds an item created by the caller, there should not be an item with the same key
+    void attachItem(Item *item) {
+        // constant time when the items are added in order
+        if (mCount == 0 || Cmp()(symbols()[mCount - 1], item->get())) {
+            place(mCount, item);
+        } else {
+            place(lowerBound(item->get()), item);
+        }
+    }
+
+    bool eraseItem(T const &k) {
+        int pos = position(k);
+        if (pos < 0) {
+            return false;
+        }
+        NodeClass::destroyItem(mAllocator, mChilds[pos]);
+        T *syms = symbols();
+        for (unsigned int i = pos + 1; i < mCount; ++i) {
+            syms[i - 1] = syms[i];
+            mChilds[i - 1] = mChilds[i];
+        }
+        --mCount;
+
+        if (!mCount) {
+            clear();
+        } else if (mCount <= mCapacity / 4) {
+            // shrinks to half, leaving room so that alternating insert and erase does not resize every time
+            resize(mCapacity / 2);
+        }
+        return true;
+    }
+
+    Item *getItem(T const &k) const {
+        int pos = position(k);
+        if (pos >= 0) {
+            return mChilds[pos];
+        }
+        return 0;
+    }
+
+    void prefetchItem(T const &) const {
+        if (mChilds) {
+            RTV_PREFETCH(symbols());
+        }
+    }
+
+    NodeItemClass *createNodeItem(T const &k) {
+        return NodeClass::createItem(mAllocator, k);
+    }
+
+private:
+    SortedArrayItems(SortedArrayItems const &);
+    SortedArrayItems &operator=(SortedArrayItems const &);
+
+    // symbols allocated for a capacity, the search may read up to a whole block past the last symbol
+    static unsigned int symbolCapacity(unsigned int capacity) {
+        return (capacity + Search::Lanes - 1) / Search::Lanes * Search::Lanes;
+    }
+
+    static std::size_t arraySize(unsigned int capacity) {
+        return capacity * sizeof(Item *) + symbolCapacity(capacity) * sizeof(T);
+    }
+
+    // the symbols follow the items in the block
+    T *symbols() const {
+        return reinterpret_cast<T *>(mChilds + mCapacity);
+    }
+
+    Item *itemAt(unsigned int pos) const {
+        return mChilds[pos];
+    }
+
+    int position(T const &k) const {
+        if (!mChilds) {
+            return -1;
+        }
+        return Search::find(symbols(), mCount, k);
+    }
+
+    unsigned int lowerBound(T const &k) const {
+        if (!mChilds) {
+            return 0;
+        }
+        const T *syms = symbols();
+        return std::lower_bound(syms, syms + mCount, k, Cmp()) - syms;
+    }
+
+    void place(unsigned int pos, Item *item) {
+        if (mCount == mCapacity) {
+            resize(mCapacity ? mCapacity * 2 : 1);
+        }
+        T *syms = symbols();
+        for (unsigned int i = mCount; i > pos; --i) {
+            syms[i] = syms[i - 1];
+            mChilds[i] = mChilds[i - 1];
+        }
+        syms[pos] = item->get();
+        mChilds[pos] = item;
+        ++mCount;
+    }
+
+    void resize(unsigned int capacity) {
+        Item **childs = static_cast<Item **>(mAllocator->allocate(arraySize(capacity)));
+        T *syms = reinterpret_cast<T *>(childs + capacity);
+        std::uninitialized_fill(syms, syms + symbolCapacity(capacity), T());
+        if (mChilds) {
+            std::copy(mChilds, mChilds + mCount, childs);
+            std::copy(symbols(), symbols() + mCount, syms);
+            releaseArray();
+        }
+        mChilds = childs;
+        mCapacity = capacity;
+    }
+
+    void releaseArray() {
+        if (mChilds) {
+            T *syms = symbols();
+            for (unsigned int i = 0; i < symbolCapacity(mCapacity); ++i) {
+                syms[i].~T();
+            }
+            mAllocator->deallocate(mChilds, arraySize(mCapacity));
+            mChilds = 0;
+            mCapacity = 0;
+        }
+    }
+
+protected:
+    T mEndSymbol;
+    unsigned int mCount;
+    unsigned int mCapacity;
+    // mCapacity items followed by the symbols of the items in the order of Cmp
+    Item **mChilds;
+    Allocator *mAllocator;
+};
+
+/*!
+ * @brief Container representing each node in the Trie.
+ *
+ *
+ * With this class each node keeps a bitmap of Max bits telling which symbols have an item,
+ * and a dense array holding only the items of those symbols in the order of their index.
+ * The position of an item in the array is the number of bits set before the bit of its symbol,
+ * found by one population count and a count of the bits in the words before it kept in the node,
+ * so searching takes constant time as with rtv::VectorItems while the space used is Max bits
+ * and a few counts plus a pointer for each item.
+ * @tparam T Type for each element in the key
+ * @tparam V Type of the value that the key will be representing
+ * @tparam Cmp Comparison functor
+ * @tparam Max Maximum element that a Trie node can have, up to 65536
+ * @tparam M Functor which maps a symbol to its index in the bitmap
+ * @tparam A Allocator used for the nodes, node items and item arrays, rtv::HeapAllocator or rtv::SlabAllocator
+ */
+template < typename T,
+typename V,
+typename Cmp,
+int Max = 256,
+typename M = SymbolToIndexMapper<T>,
+typename A = HeapAllocator > class BitmapItems
+{
+public:
+    typedef A Allocator;
+    typedef NodeItem<T, V, Cmp, BitmapItems<T, V, Cmp, Max, M, A> > Item;
+    typedef Node<T, V, Cmp, BitmapItems<T, V, Cmp, Max, M, A> > NodeClass;
+    typedef typename NodeClass::NodeItemClass NodeItemClass;
+
+private:
+    enum {
+        WordBits = 32,
+        Words = (Max + WordBits - 1) / WordBits
+    };
+
+    friend class ItemsIterator<BitmapItems, Item>;
+
+public:
+    typedef ItemsIterator<BitmapItems, Item> Iterator;
+    typedef Iterator iterator;
+    typedef Iterator const_iterator;
+
+    BitmapItems(T const &endSymbol, Allocator *allocator)
+            : mEndSymbol(endSymbol),
+            mCount(0),
+            mCapacity(0),
+            mChilds(0),
+            mAllocator(allocator) {
+        std::fill(mBits, mBits + Words, 0u);
+        std::fill(mRanks, mRanks + Words, (unsigned short)0);
+    }
+
+    ~BitmapItems() {
+        releaseArray();
+    }
+
+    Allocator *allocator() const {
+        return mAllocator;
+    }
+
+    const_iterator find(const T & k) const {
+        int pos = position(mSymolToIndex(k));
+        if (pos >= 0) {
+            return Iterator(this, pos);
+        }
+        return end();
+    }
+
+    iterator begin() const {
+        return Iterator(this, 0);
+    }
+
+    iterator end() const {
+        return Iterator(this, mCount);
+    }
+
+    void clear() {
+        releaseArray();
+        std::fill(mBits, mBits + Words, 0u);
+        std::fill(mRanks, mRanks + Words, (unsigned short)0);
+        mCount = 0;
+    }
+
+    void swap(BitmapItems &oth) {
+        std::swap(mEndSymbol, oth.mEndSymbol);
+        std::swap_ranges(mBits, mBits + Words, oth.mBits);
+        std::swap_ranges(mRanks, mRanks + Words, oth.mRanks);
+        std::swap(mCount, oth.mCount);
+        std::swap(mCapacity, oth.mCapacity);
+        std::swap(mChilds, oth.mChilds);
+        std::swap(mSymolToIndex, oth.mSymolToIndex);
+        std::swap(mAllocator, oth.mAllocator);
+    }
+
+    bool empty() const {
+        return mCount == 0;
+    }
+
+    // Number of items in the node
+    unsigned int childCount() const {
+        return mCount;
+    }
+
+    // Called by the node before any item is added, depth is the number of key symbols above the node
+    void setDepth(unsigned int) {}
+
+    // The depth is only kept by rtv::HybridItems
+    unsigned int depth() const {
+        return 0;
+    }
+
+    // Returns the item of the symbol and true if it is created
+    std::pair<Item *, bool> insertItem(T const &k) {
+        std::pair<Item *, bool> ret(getItem(k), false);
+        if (!ret.first) {
+            ret.first = createNodeItem(k);
+            ret.second = true;
+            attachItem(ret.first);
+        }
+        return ret;
+    }
+
+    // Adds an item created by the caller, there should not be an item with the same key
+    void attachItem(Item *item) {
+        if (mCount == mCapacity) {
+            resize(mCapacity ? mCapacity * 2 : 1);
+        }
+        unsigned int index = mSymolToIndex(item->get());
+        unsigned int pos = rank(index);
+        for (unsigned int i = mCount; i > pos; --i) {
+            mChilds[i] = mChilds[i - 1];
+        }
+        mChilds[pos] = item;
+        ++mCount;
+
+        mBits[index / WordBits] |= 1u << (index % WordBits);
+        for (unsigned int w = index / WordBits + 1; w < Words; ++w) {
+            ++mRanks[w];
+        }
+    }
+
+    bool eraseItem(T const &k) {
+        unsigned int index = mSymolToIndex(k);
+        int pos = position(index);
+        if (pos < 0) {
+            return false;
+        }
+        NodeClass::destroyItem(mAllocator, mChilds[pos]);
+        for (unsigned int i = pos + 1; i < mCount; ++i) {
+            mChilds[i - 1] = mChilds[i];
+        }
+        --mCount;
+
+        mBits[index / WordBits] &= ~(1u << (index % WordBits));
+        for (unsigned int w = index / WordBits + 1; w < Words; ++w) {
+            --mRanks[w];
+        }
+
+        if (!mCount) {
+            releaseArray();
+        } else if (mCount <= mCapacity / 4) {
+            resize(mCapacity / 2);
+        }
+        return true;
+    }
+
+    Item *getItem(T const &k) const {
+        int pos = position(mSymolToIndex(k));
+        if (pos >= 0) {
+            return mChilds[pos];
+        }
+        return 0;
+    }
+
+    void prefetchItem(T const &) const {
+        if (mChilds) {
+            RTV_PREFETCH(mChilds);
+        }
+    }
+
+    NodeItemClass *createNodeItem(T const &k) {
+        return NodeClass::createItem(mAllocator, k);
+    }
+
+private:
+    BitmapItems(BitmapItems const &);
+    BitmapItems &operator=(BitmapItems const &);
+
+    Item *itemAt(unsigned int pos) const {
+        return mChilds[pos];
+    }
+
+    // number of items with an index lower than index
+    unsigned int rank(unsigned int index) const {
+        unsigned int bit = index % WordBits;
+        unsigned int word = index / WordBits;
+        return mRanks[word] + (bit ? Bits::popCount(mBits[word] & ((1u << bit) - 1)) : 0);
+    }
+
+    int position(unsigned int index) const {
+        if (!(mBits[index / WordBits] & (1u << (index % WordBits)))) {
+            return -1;
+        }
+        return rank(index);
+    }
+
+    void resize(unsigned int capacity) {
+        Item **childs = static_cast<Item **>(mAllocator->allocate(capacity * sizeof(Item *)));
+        if (mChilds) {
+            std::copy(mChilds, mChilds + mCount, childs);
+            releaseArray();
+        }
+        mChilds = childs;
+        mCapacity = capacity;
+    }
+
+    void releaseArray() {
+        if (mChilds) {
+            mAllocator->deallocate(mChilds, mCapacity * sizeof(Item *));
+            mChilds = 0;
+            mCapacity = 0;
+        }
+    }
+
+protected:
+    T mEndSymbol;
+    // bit i of the bitmap is set if the symbol of index i has an item
+    unsigned int mBits[Words];
+    // number of bits set in the words before each word
+    unsigned short mRanks[Words];
+    unsigned int mCount;
+    unsigned int mCapacity;
+    Item **mChilds;
+    M mSymolToIndex;
+    Allocator *mAllocator;
+};
+
+/*!
+ * @brief Container representing each node in the Trie.
+ *
+ *
+ * With this class the items of a node are kept in a small open addressing hash table with linear probing,
+ * for large alphabets such as wchar_t or token numbers where an array of size Max is not possible.
+ * The index of each symbol given by M is kept in the table next to its item, so probing does not
+ * touch the items, and the table doubles when it is three quarters full. Tables of up to 4 slots
+ * fill up completely, so a node with a single item takes a single slot.
+ * The items are ordered by Cmp for iteration in an index which is sorted the first time the node is
+ * iterated or searched with find after it changed, so adding and erasing an item stay constant time.
+ * Threads which iterate the node at the same time each sort their own index and the first one published
+ * is kept, the index is taken from operator new as the allocators are not shared between threads.
+ * @tparam T Type for each element in the key
+ * @tparam V Type of the value that the key will be representing
+ * @tparam Cmp Comparison functor
+ * @tparam M Functor which maps a symbol to its index, symbols which are not equal must have different indexes
+ * @tparam A Allocator used for the nodes, node items and tables, rtv::HeapAllocator or rtv::SlabAllocator
+ */
+template < typename T,
+typename V,
+typename Cmp,
+typename M = SymbolToIndexMapper<T>,
+typename A = HeapAllocator > class HashItems
+{
+public:
+    typedef A Allocator;
+    typedef NodeItem<T, V, Cmp, HashItems<T, V, Cmp, M, A> > Item;
+    typedef Node<T, V, Cmp, HashItems<T, V, Cmp, M, A> > NodeClass;
+    typedef typename NodeClass::NodeItemClass NodeItemClass;
+
+private:
+    friend class ItemsIterator<HashItems, Item>;
+
+public:
+    typedef ItemsIterator<HashItems, Item> Iterator;
+    typedef Iterator iterator;
+    typedef Iterator const_iterator;
+
+    HashItems(T const &endSymbol, Allocator *allocator)
+            : mEndSymbol(endSymbol),
+            mCount(0),
+            mCapacity(0),
+            mBits(0),
+            mChilds(0),
+            mOrder(0),
+            mAllocator(allocator) {}
+
+    ~HashItems() {
+        releaseTable();
+    }
+
+    Allocator *allocator() const {
+        return mAllocator;
+    }
+
+    const_iterator find(const T & k) const {
+        const Item *item = getItem(k);
+        if (item) {
+            Item **order = ordered();
+            return Iterator(this, std::lower_bound(order, order + mCount, item, ItemLess()) - order);
+        }
+        return end();
+    }
+
+    iterator begin() const {
+        return Iterator(this, 0);
+    }
+
+    iterator end() const {
+        return Iterator(this, mCount);
+    }
+
+    void clear() {
+        releaseTable();
+        mCount = 0;
+    }
+
+    void swap(HashItems &oth) {
+        std::swap(mEndSymbol, oth.mEndSymbol);
+        std::swap(mCount, oth.mCount);
+        std::swap(mCapacity, oth.mCapacity);
+        std::swap(mBits, oth.mBits);
+        std::swap(mChilds, oth.mChilds);
+        Item **order = loadOrder();
+        storeOrder(oth.loadOrder());
+        oth.storeOrder(order);
+        std::swap(mSymolToIndex, oth.mSymolToIndex);
+        std::swap(mAllocator, oth.mAllocator);
+    }
+
+    bool empty() const {
+        return mCount == 0;
+    }
+
+    // Number of items in the node
+    unsigned int childCount() const {
+        return mCount;
+    }
+
+    // Called by the node before any item is added, depth is the number of key symbols above the node
+    void setDepth(unsigned int) {}
+
+    // The depth is only kept by rtv::HybridItems
+    unsigned int depth() const {
+        return 0;
+    }
+
+    // Returns the item of the symbol and true if it is created
+    std::pair<Item *, bool> insertItem(T const &k) {
+        std::pair<Item *, bool> ret(getItem(k), false);
+        if (!ret.first) {
+            ret.first = createNodeItem(k);
+            ret.second = true;
+            attachItem(ret.first);
+        }
+        return ret;
+    }
+
+    // Adds an item created by the caller, there should not be an item with the same key
+    void attachItem(Item *item) {
+        if (mCount == mCapacity || (mCapacity > 4 && (mCount + 1) * 4 > mCapacity * 3)) {
+            resize(mCapacity ? mCapacity * 2 : 1);
+        }
+        place(mSymolToIndex(item->get()), item);
+        releaseOrder();
+        ++mCount;
+    }
+
+    bool eraseItem(T const &k) {
+        int slot = position(mSymolToIndex(k));
+        if (slot < 0) {
+            return false;
+        }
+        releaseOrder();
+        NodeClass::destroyItem(mAllocator, mChilds[slot]);
+        remove(slot);
+        --mCount;
+
+        if (!mCount) {
+            clear();
+        } else if (mCapacity > 4 && mCount * 8 < mCapacity) {
+            resize(mCapacity / 2);
+        }
+        return true;
+    }
+
+    Item *getItem(T const &k) const {
+        int slot = position(mSymolToIndex(k));
+        if (slot >= 0) {
+            return mChilds[slot];
+        }
+        return 0;
+    }
+
+    void prefetchItem(T const &k) const {
+        if (mChilds) {
+            unsigned int slot = home(mSymolToIndex(k));
+            RTV_PREFETCH(indexes() + slot);
+            RTV_PREFETCH(mChilds + slot);
+        }
+    }
+
+    NodeItemClass *createNodeItem(T const &k) {
+        return NodeClass::createItem(mAllocator, k);
+    }
+
+private:
+    HashItems(HashItems const &);
+    HashItems &operator=(HashItems const &);
+
+    class ItemLess
+    {
+    public:
+        bool operator()(const Item *v1, const Item *v2) const {
+            return *v1 < *v2;
+        }
+    };
+
+    static std::size_t tableSize(unsigned int capacity) {
+        return capacity * (sizeof(Item *) + sizeof(unsigned int));
+    }
+
+    // the indexes of the symbols follow the items in the table
+    unsigned int *indexes() const {
+        return reinterpret_cast<unsigned int *>(mChilds + mCapacity);
+    }
+
+    // the items in the order of Cmp, sorted on the first use after the node changed
+    Item **ordered() const {
+        Item **order = loadOrder();
+        if (!order && mCount) {
+            Item **sorted = static_cast<Item **>(::operator new(mCount * sizeof(Item *)));
+            Item **next = sorted;
+            for (unsigned int slot = 0; slot < mCapacity; ++slot) {
+                if (mChilds[slot]) {
+                    *next++ = mChilds[slot];
+                }
+            }
+            std::sort(sorted, sorted + mCount, ItemLess());
+            order = publishOrder(sorted);
+            if (order != sorted) {
+                ::operator delete(sorted);
+            }
+        }
+        return order;
+    }
+
+#ifdef RTV_HAS_CXX11
+    Item **loadOrder() const {
+        return mOrder.load(std::memory_order_acquire);
+    }
+
+    void storeOrder(Item **order) const {
+        mOrder.store(order, std::memory_order_release);
+    }
+
+    // Keeps order unless another thread published its index first, returns the index kept
+    Item **publishOrder(Item **order) const {
+        Item **published = 0;
+        return mOrder.compare_exchange_strong(published, order, std::memory_order_acq_rel) ? order : published;
+    }
+#else
+    Item **loadOrder() const {
+        return mOrder;
+    }
+
+    void storeOrder(Item **order) const {
+        mOrder = order;
+    }
+
+    Item **publishOrder(Item **order) const {
+        mOrder = order;
+        return order;
+    }
+#endif
+
+    // Called when the node changes, no thread iterates a node which is being changed
+    void releaseOrder() {
+        Item **order = loadOrder();
+        if (order) {
+            ::operator delete(order);
+            storeOrder(0);
+        }
+    }
+
+    // slot where the probing for the index starts, by Fibonacci hashing
+    unsigned int home(unsigned int index) const {
+        return mBits ? (index * 2654435769u) >> (32 - mBits) : 0;
+    }
+
+    unsigned int nextSlot(unsigned int slot) const {
+        return (slot + 1) & (mCapacity - 1);
+    }
+
+    Item *itemAt(unsigned int pos) const {
+        return ordered()[pos];
+    }
+
+    int position(unsigned int index) const {
+        if (!mChilds) {
+            return -1;
+        }
+        const unsigned int *idx = indexes();
+        unsigned int slot = home(index);
+        // a full table has no empty slot to stop at
+        for (unsigned int probe = 0; probe < mCapacity && mChilds[slot]; ++probe, slot = nextSlot(slot)) {
+            if (idx[slot] == index) {
+                return slot;
+            }
+        }
+        return -1;
+    }
+
+    void place(unsigned int index, Item *item) {
+        unsigned int slot = home(index);
+        while (mChilds[slot]) {
+            slot = nextSlot(slot);
+        }
+        mChilds[slot] = item;
+        indexes()[slot] = index;
+    }
+
+    // Empties the slot and moves back the items after it which would not be found across the empty slot
+    void remove(unsigned int slot) {
+        unsigned int *idx = indexes();
+        mChilds[slot] = 0;
+        for (unsigned int next = nextSlot(slot); mChilds[next]; next = nextSlot(next)) {
+            unsigned int start = home(idx[next]);
+            // the item at next can move to slot if its probing starts cyclically outside (slot, next]
+            bool movable = slot < next ? (start <= slot || start > next) : (start <= slot && start > next);
+            if (movable) {
+                mChilds[slot] = mChilds[next];
+                idx[slot] = idx[next];
+                mChilds[next] = 0;
+                slot = next;
+            }
+        }
+    }
+
+    void resize(unsigned int capacity) {
+        Item **oldChilds = mChilds;
+        unsigned int *oldIndexes = indexes();
+        unsigned int oldCapacity = mCapacity;
+
+        mChilds = static_cast<Item **>(mAllocator->allocate(tableSize(capacity)));
+        std::fill(mChilds, mChilds + capacity, (Item *)0);
+        mCapacity = capacity;
+        for (mBits = 0; (1u << mBits) < capacity; ++mBits) {
+        }
+        for (unsigned int slot = 0; slot < oldCapacity; ++slot) {
+            if (oldChilds[slot]) {
+                place(oldIndexes[slot], oldChilds[slot]);
+            }
+        }
+        if (oldChilds) {
+            mAllocator->deallocate(oldChilds, tableSize(oldCapacity));
+        }
+    }
+
+    void releaseTable() {
+        releaseOrder();
+        if (mChilds) {
+            mAllocator->deallocate(mChilds, tableSize(mCapacity));
+            mChilds = 0;
+            mCapacity = 0;
+            mBits = 0;
+        }
+    }
+
+protected:
+    T mEndSymbol;
+    unsigned int mCount;
+    // a power of two, mBits is its logarithm
+    unsigned int mCapacity;
+    unsigned int mBits;
+    // mCapacity slots of items followed by the indexes of their symbols, empty slots hold 0
+    Item **mChilds;
+    // the items ordered by Cmp, 0 until the node is iterated after it changed
+#ifdef RTV_HAS_CXX11
+    mutable std::atomic<Item **> mOrder;
+#else
+    mutable Item **mOrder;
+#endif
+    M mSymolToIndex;
+    Allocator *mAllocator;
+};
+
+/*!
+ * @brief Container representing each node in the Trie.
+ *
+ *
+ * With this class the nodes shallower than Depth keep their items in an array of size Max as
+ * rtv::VectorItems does, and the nodes at Depth or below keep the indexes of their symbols
+ * in a sorted array next to an array of the items, which grows and shrinks by halves.
+ * This suits Tries whose first levels are dense and whose deeper nodes have only a few items.
+ * The depth of a node is the number of key symbols above it, so splitting or merging the labels of a
+ * compressed Trie does not move the nodes below to another depth.
+ * The layout of a node is chosen when it is made, Trie::stats tells which Depth takes the least memory
+ * for the keys of a Trie. The items of both layouts are in the order of their index.
+ * @tparam T Type for each element in the key
+ * @tparam V Type of the value that the key will be representing
+ * @tparam Cmp Comparison functor
+ * @tparam Depth Depth of the first nodes having the sparse layout, the root is at depth 0
+ * @tparam Max Maximum element that a Trie node can have
+ * @tparam M Functor which maps a symbol to its index in the node
+ * @tparam A Allocator used for the nodes, node items and item arrays, rtv::HeapAllocator or rtv::SlabAllocator
+ */
+template < typename T,
+typename V,
+typename Cmp,
+int Depth = 3,
+int Max = 256,
+typename M = SymbolToIndexMapper<T>,
+typename A = HeapAllocator > class HybridItems
+{
+public:
+    typedef A Allocator;
+    typedef NodeItem<T, V, Cmp, HybridItems<T, V, Cmp, Depth, Max, M, A> > Item;
+    typedef Node<T, V, Cmp, HybridItems<T, V, Cmp, Depth, Max, M, A> > NodeClass;
+    typedef typename NodeClass::NodeItemClass NodeItemClass;
+
+private:
+    typedef SortedSymbolSearch<unsigned int, std::less<unsigned int> > Search;
+
+    friend class ItemsIterator<HybridItems, Item>;
+
+public:
+    typedef ItemsIterator<HybridItems, Item> Iterator;
+    typedef Iterator iterator;
+    typedef Iterator const_iterator;
+
+    HybridItems(T const &endSymbol, Allocator *allocator)
+            : mEndSymbol(endSymbol),
+            mDense(Depth > 0),
+            mCount(0),
+            mCapacity(0),
+            mDepth(0),
+            mChilds(0),
+            mAllocator(allocator) {}
+
+    ~HybridItems() {
+        releaseLayout();
+    }
+
+    // Bytes taken by a node having items items with the dense or the sparse layout, used by rtv::TrieStats
+    static std::size_t nodeBytes(bool dense, unsigned int items) {
+        std::size_t bytes = sizeof(NodeClass) + items * sizeof(NodeItemClass);
+        if (items) {
+            unsigned int capacity = 1;
+            while (capacity < items) {
+                capacity *= 2;
+            }
+            bytes += dense ? denseSize() : sparseSize(capacity);
+        }
+        return bytes;
+    }
+
+    // Bytes taken by a value out of its node, used by rtv::TrieStats
+    static std::size_t valueBytes() {
+        return NodeValue<V, A>::allocatedBytes();
+    }
+
+    // Bytes taken by labels holding symbols symbols in all, used by rtv::TrieStats
+    static std::size_t labelBytes(std::size_t labels, std::size_t symbols) {
+        return NodeLabel<T, A>::allocatedBytes(labels, symbols);
+    }
+
+    Allocator *allocator() const {
+        return mAllocator;
+    }
+
+    const_iterator find(const T & k) const {
+        int pos = position(mSymolToIndex(k));
+        if (pos >= 0) {
+            return Iterator(this, pos);
+        }
+        return end();
+    }
+
+    iterator begin() const {
+        return Iterator(this, 0);
+    }
+
+    iterator end() const {
+        return Iterator(this, limit());
+    }
+
+    void clear() {
+        releaseLayout();
+        mCount = 0;
+    }
+
+    void swap(HybridItems &oth) {
+        std::swap(mEndSymbol, oth.mEndSymbol);
+        std::swap(mDense, oth.mDense);
+        std::swap(mCount, oth.mCount);
+        std::swap(mCapacity, oth.mCapacity);
+        std::swap(mDepth, oth.mDepth);
+        std::swap(mChilds, oth.mChilds);
+        std::swap(mSymolToIndex, oth.mSymolToIndex);
+        std::swap(mAllocator, oth.mAllocator);
+    }
+
+    bool empty() const {
+        return mCount == 0;
+    }
+
+    // Number of items in the node
+    unsigned int childCount() const {
+        return mCount;
+    }
+
+    // Called by the node before any item is added, depth is the number of key symbols above the node
+    void setDepth(unsigned int depth) {
+        mDepth = depth;
+        mDense = depth < (unsigned int)Depth;
+    }
+
+    unsigned int depth() const {
+        return mDepth;
+    }
+
+    // Returns the item of the symbol and true if it is created
+    std::pair<Item *, bool> insertItem(T const &k) {
+        std::pair<Item *, bool> ret(getItem(k), false);
+        if (!ret.first) {
+            ret.first = createNodeItem(k);
+            ret.second = true;
+            attachItem(ret.first);
+        }
+        return ret;
+    }
+
+    // Adds an item created by the caller, there should not be an item with the same key
+    void attachItem(Item *item) {
+        unsigned int index = mSymolToIndex(item->get());
+        if (mDense) {
+            if (!mChilds) {
+                mChilds = static_cast<Item **>(mAllocator->allocate(denseSize()));
+                std::fill(mChilds, mChilds + Max, (Item *)0);
+            }
+            mChilds[index] = item;
+        } else {
+            if (mCount == mCapacity) {
+                resize(mCapacity ? mCapacity * 2 : 1);
+            }
+            unsigned int *idx = indexes();
+            unsigned int pos = std::lower_bound(idx, idx + mCount, index) - idx;
+            for (unsigned int i = mCount; i > pos; --i) {
+                idx[i] = idx[i - 1];
+                mChilds[i] = mChilds[i - 1];
+            }
+            idx[pos] = index;
+            mChilds[pos] = item;
+        }
+        ++mCount;
+    }
+
+    bool eraseItem(T const &k) {
+        int pos = position(mSymolToIndex(k));
+        if (pos < 0) {
+            return false;
+        }
+        NodeClass::destroyItem(mAllocator, mChilds[pos]);
+        if (mDense) {
+            mChilds[pos] = 0;
+        } else {
+            unsigned int *idx = indexes();
+            for (unsigned int i = pos + 1; i < mCount; ++i) {
+                idx[i - 1] = idx[i];
+                mChilds[i - 1] = mChilds[i];
+            }
+        }
+        --mCount;
+
+        if (!mCount) {
+            clear();
+        } else if (!mDense && mCount <= mCapacity / 4) {
+            resize(mCapacity / 2);
+        }
+        return true;
+    }
+
+    Item *getItem(T const &k) const {
+        int pos = position(mSymolToIndex(k));
+        if (pos >= 0) {
+            return mChilds[pos];
+        }
+        return 0;
+    }
+
+    void prefetchItem(T const &k) const {
+        if (!mChilds) {
+            return;
+        }
+        if (mDense) {
+            RTV_PREFETCH(mChilds + mSymolToIndex(k));
+        } else {
+            RTV_PREFETCH(indexes());
+        }
+    }
+
+    NodeItemClass *createNodeItem(T const &k) {
+        return NodeClass::createItem(mAllocator, k);
+    }
+
+private:
+    HybridItems(HybridItems const &);
+    HybridItems &operator=(HybridItems const &);
+
+    static std::size_t denseSize() {
+        return Max * sizeof(Item *);
+    }
+
+    // the search of the indexes may read up to a whole block past the last index
+    static std::size_t sparseSize(unsigned int capacity) {
+        return capacity * sizeof(Item *) +
+               (capacity + Search::Lanes - 1) / Search::Lanes * Search::Lanes * sizeof(unsigned int);
+    }
+
+    // the indexes of the symbols follow the items in the sparse layout
+    unsigned int *indexes() const {
+        return reinterpret_cast<unsigned int *>(mChilds + mCapacity);
+    }
+
+    unsigned int limit() const {
+        if (!mChilds) {
+            return 0;
+        }
+        return mDense ? Max : mCount;
+    }
+
+    Item *itemAt(unsigned int pos) const {
+        return mChilds[pos];
+    }
+
+    int position(unsigned int index) const {
+        if (!mChilds) {
+            return -1;
+        }
+        if (mDense) {
+            return mChilds[index] ? (int)index : -1;
+        }
+        return Search::find(indexes(), mCount, index);
+    }
+
+    void resize(unsigned int capacity) {
+        Item **childs = static_cast<Item **>(mAllocator->allocate(sparseSize(capacity)));
+        unsigned int *idx = reinterpret_cast<unsigned int *>(childs + capacity);
+        std::fill(idx, idx + (sparseSize(capacity) - capacity * sizeof(Item *)) / sizeof(unsigned int), 0u);
+        if (mChilds) {
+            std::copy(mChilds, mChilds + mCount, childs);
+            std::copy(indexes(), indexes() + mCount, idx);
+            releaseLayout();
+        }
+        mChilds = childs;
+        mCapacity = capacity;
+    }
+
+    void releaseLayout() {
+        if (mChilds) {
+            mAllocator->deallocate(mChilds, mDense ? denseSize() : sparseSize(mCapacity));
+            mChilds = 0;
+            mCapacity = 0;
+        }
+    }
+
+protected:
+    T mEndSymbol;
+    bool mDense;
+    unsigned int mCount;
+    // capacity of the sparse layout
+    unsigned int mCapacity;
+    unsigned int mDepth;
+    // Max items of the dense layout, or mCapacity items followed by the sorted indexes of their symbols
+    Item **mChilds;
+    M mSymolToIndex;
+    Allocator *mAllocator;
+};
+
+/*!
+ * @brief Lookups and iteration shared by the read only Tries, rtv::MappedTrie, rtv::DoubleArrayTrie and rtv::LoudsTrie.
+ *
+ * Derived names its nodes by State and the edges leaving a node by Edge. It gives
+ * root(node) which is false when there is no root, child(node, symbol, next) which is false when
+ * the node has no edge with the symbol, valueOf(node), edges(node) as the first edge and the end of the
+ * edges of the node, nextEdge(node, edge), target(node, edge) and label(edge), in the order of Cmp.
+ * @tparam Derived The read only Trie
+ * @tparam T Type for each element in the key
+ * @tparam V Type of the value that the key will be representing
+ * @tparam State Type naming a node of Derived
+ * @tparam Edge Type naming an edge of Derived
+ */
+template < typename Derived,
+typename T,
+typename V,
+typename State,
+typename Edge > class ReadOnlyTrie
+{
+public:
+    typedef std::pair<const T *, const V *> KeyValuePair;
+
+    static const std::size_t npos = static_cast<std::size_t>(-1);
+
+    /*!
+     * @brief Iterates the elements under a node, each node before the nodes below it.
+     */
+    class ConstIterator
+    {
+    private:
+        struct Frame {
+            State mNode;
+            Edge mNext;
+            Edge mEnd;
+        };
+
+    public:
+        ConstIterator()
+                : mTrie(0),
+                mKeyValuePair((const T *)0, (const V *)0) {}
+
+        // Starts at the node of the prefix, the key is the prefix terminated by 'end' symbol
+        ConstIterator(const Derived *trie, State node, const T *prefix, std::size_t length)
+                : mTrie(trie),
+                mKey(prefix, prefix + length),
+                mKeyValuePair((const T *)0, (const V *)0) {
+            push(node);
+            mKey.push_back(trie->endSymbol());
+            if (!settle()) {
+                next();
+            }
+        }
+
+        ConstIterator(ConstIterator const &oth)
+                : mTrie(oth.mTrie),
+                mFrames(oth.mFrames),
+                mKey(oth.mKey),
+                mKeyValuePair(oth.mKeyValuePair) {
+            relink();
+        }
+
+        ConstIterator &operator=(ConstIterator const &oth) {
+            mTrie = oth.mTrie;
+            mFrames = oth.mFrames;
+            mKey = oth.mKey;
+            mKeyValuePair = oth.mKeyValuePair;
+            relink();
+            return *this;
+        }
+
+        const KeyValuePair &operator*() const {
+            return mKeyValuePair;
+        }
+
+        const KeyValuePair *operator->() const {
+            return &mKeyValuePair;
+        }
+
+        bool operator==(ConstIterator const &oth) const {
+            if (mFrames.empty() || oth.mFrames.empty()) {
+                return mFrames.empty() && oth.mFrames.empty();
+            }
+            return mKeyValuePair.second == oth.mKeyValuePair.second;
+        }
+
+        bool operator!=(ConstIterator const &oth) const {
+            return !(*this == oth);
+        }
+
+        ConstIterator &operator++() {
+            next();
+            return *this;
+        }
+
+        ConstIterator operator++(int) {
+            ConstIterator iter = *this;
+            next();
+            return iter;
+        }
+
+    private:
+        void push(State node) {
+            std::pair<Edge, Edge> edges = mTrie->edges(node);
+            Frame frame = { node, edges.first, edges.second };
+            mFrames.push_back(frame);
+        }
+
+        // Points the pair at the value of the node on top, false if it has no value
+        bool settle() {
+            const V *value = mTrie->valueOf(mFrames.back().mNode);
+            if (!value) {
+                return false;
+            }
+            mKeyValuePair.first = &mKey[0];
+            mKeyValuePair.second = value;
+            return true;
+        }
+
+        void relink() {
+            if (!mFrames.empty()) {
+                mKeyValuePair.first = &mKey[0];
+            }
+        }
+
+        void next() {
+            while (!mFrames.empty()) {
+                Frame &top = mFrames.back();
+                if (top.mNext != top.mEnd) {
+                    Edge edge = top.mNext;
+                    State node = top.mNode;
+                    top.mNext = mTrie->nextEdge(node, edge);
+                    push(mTrie->target(node, edge));
+                    mKey.back() = mTrie->label(edge);
+                    mKey.push_back(mTrie->endSymbol());
+                    if (settle()) {
+                        return;
+                    }
+                } else {
+                    mFrames.pop_back();
+                    mKey.pop_back();
+                    if (!mKey.empty()) {
+                        mKey.back() = mTrie->endSymbol();
+                    }
+                }
+            }
+        }
+
+    private:
+        const Derived *mTrie;
+        std::vector<Frame> mFrames;
+        std::vector<T> mKey;
+        KeyValuePair mKeyValuePair;
+    };
+
+public:
+    /*!
+     * Retrieves the value of a key
+     * @param key Key to be searched for, should be terminated by 'end' symbol
+     * @return Pointer to the value of the key, 0 if the key is not present
+     */
+    const V *get(const T *key) const {
+        return get(key, npos);
+    }
+
+    /*!
+     * Retrieves the value of a key
+     * @param key Key to be searched for, need not be terminated
+     * @param length Number of symbols in the key
+     * @return Pointer to the value of the key, 0 if the key is not present
+     */
+    const V *get(const T *key, std::size_t length) const {
+        State node;
+        return walk(key, measure(key, length), node) ? derived().valueOf(node) : 0;
+    }
+
+    /*!
+     * Checks whether the given key is present
+     * @param key Key to be searched for, should be terminated by 'end' symbol
+     * @return true if the key is present
+     */
+    bool hasKey(const T *key) const {
+        return get(key, npos) != 0;
+    }
+
+    /*!
+     * Checks whether the given key is present
+     * @param key Key to be searched for, need not be terminated
+     * @param length Number of symbols in the key
+     * @return true if the key is present
+     */
+    bool hasKey(const T *key, std::size_t length) const {
+        return get(key, length) != 0;
+    }
+
+    /*!
+     * Retrieves ConstIterator to the elements with common prefix
+     * @param prefix Part of the key which should be searched, should be terminated by 'end' symbol
+     * @return ConstIterator to the first element with the prefix, end() if there is none
+     */
+    ConstIterator startsWith(const T *prefix) const {
+        return startsWith(prefix, npos);
+    }
+
+    /*!
+     * Retrieves ConstIterator to the elements with common prefix
+     * @param prefix Part of the key which should be searched, need not be terminated
+     * @param length Number of symbols in the prefix
+     * @return ConstIterator to the first element with the prefix, end() if there is none
+     */
+    ConstIterator startsWith(const T *prefix, std::size_t length) const {
+        length = measure(prefix, length);
+        State node;
+        if (!walk(prefix, length, node)) {
+            return end();
+        }
+        return ConstIterator(&derived(), node, prefix, length);
+    }
+
+    /*!
+     * Finds the longest key which is a prefix of the given key, see Trie::longestPrefixOf
+     * @param key Key to be searched for, should be terminated by 'end' symbol
+     * @return An std::pair with pair::first set to the length of the longest matching key and
+     *         pair::second to pointer to its value, pair::second is 0 if no key matches
+     */
+    std::pair<std::size_t, const V *> longestPrefixOf(const T *key) const {
+        return longestPrefixOf(key, npos);
+    }
+
+    /*!
+     * Finds the longest key which is a prefix of the given key, see Trie::longestPrefixOf
+     * @param key Key to be searched for, need not be terminated
+     * @param length Number of symbols in the key
+     * @return An std::pair with pair::first set to the length of the longest matching key and
+     *         pair::second to pointer to its value, pair::second is 0 if no key matches
+     */
+    std::pair<std::size_t, const V *> longestPrefixOf(const T *key, std::size_t length) const {
+        LongestPrefix<V> visitor;
+        visitPrefixes(key, measure(key, length), visitor);
+        return visitor.mResult;
+    }
+
+    /*!
+     * Finds all the keys which are prefixes of the given key, see Trie::prefixesOf
+     * @param key Key to be searched for, should be terminated by 'end' symbol
+     * @param callback Called as callback(length, value) for each matching key, shortest first
+     * @return The callback, after it has been called for all the matching keys
+     */
+    template <typename Callback>
+    Callback prefixesOf(const T *key, Callback callback) const {
+        return prefixesOf(key, npos, callback);
+    }
+
+    /*!
+     * Finds all the keys which are prefixes of the given key, see Trie::prefixesOf
+     * @param key Key to be searched for, need not be terminated
+     * @param length Number of symbols in the key
+     * @param callback Called as callback(length, value) for each matching key, shortest first
+     * @return The callback, after it has been called for all the matching keys
+     */
+    template <typename Callback>
+    Callback prefixesOf(const T *key, std::size_t length, Callback callback) const {
+        visitPrefixes(key, measure(key, length), callback);
+        return callback;
+    }
+
+    /*!
+     * @return ConstIterator to the first element in the order of Cmp
+     */
+    ConstIterator begin() const {
+        State node;
+        if (!derived().root(node)) {
+            return end();
+        }
+        T endSymbol = derived().endSymbol();
+        return ConstIterator(&derived(), node, &endSymbol, 0);
+    }
+
+    /*!
+     * @return ConstIterator past the last element
+     */
+    ConstIterator end() const {
+        return ConstIterator();
+    }
+
+protected:
+    std::size_t measure(const T *key, std::size_t length) const {
+        if (length == npos) {
+            T endSymbol = derived().endSymbol();
+            for (length = 0; key[length] != endSymbol; ++length) {
+            }
+        }
+        return length;
+    }
+
+private:
+    const Derived &derived() const {
+        return static_cast<const Derived &>(*this);
+    }
+
+    // Sets node to the node of the key, false if the key leaves the Trie
+    bool walk(const T *key, std::size_t length, State &node) const {
+        if (!derived().root(node)) {
+            return false;
+        }
+        for (std::size_t i = 0; i < length; ++i) {
+            if (!derived().child(node, key[i], node)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <typename Visitor>
+    void visitPrefixes(const T *key, std::size_t length, Visitor &visitor) const {
+        State node;
+        if (!derived().root(node)) {
+            return;
+        }
+        for (std::size_t i = 0;; ++i) {
+            const V *value = derived().valueOf(node);
+            if (value) {
+                visitor(i, *value);
+            }
+            if (i == length || !derived().child(node, key[i], node)) {
+                return;
+            }
+        }
+    }
+};
+
+template < typename Derived,
+typename T,
+typename V,
+typename State,
+typename Edge > const std::size_t ReadOnlyTrie<Derived, T, V, State, Edge>::npos;
+
+/*!
+ * @brief Header of the file written by Trie::save and mapped by rtv::MappedTrie.
+ *
+ * The header is followed by the end symbol, the nodes, the symbols of the edges, the nodes which
+ * the edges lead to and the values. Each part starts at a multiple of Alignment bytes and the nodes
+ * refer to the edges, the nodes and the values by index, so the file can be mapped at any address.
+ * The file is read on machines with the same byte order and type sizes as the one which wrote it.
+ */
+struct TrieFileHeader {
+    enum {
+        Alignment = 16,
+        Format = 1
+    };
+
+    // The edges of a node are contiguous and sorted by Cmp, mValue is the index of the value plus one, 0 for none
+    struct Node {
+        unsigned int mFirstEdge;
+        unsigned int mEdgeCount;
+        unsigned int mValue;
+    };
+
+    static const char *magic() {
+        return "rtvtrie";
+    }
+
+    static std::size_t align(std::size_t offset) {
+        return (offset + Alignment - 1) / Alignment * Alignment;
+    }
+
+    std::size_t endSymbolOffset() const {
+        return align(sizeof(TrieFileHeader));
+    }
+
+    std::size_t nodesOffset() const {
+        return align(endSymbolOffset() + mSymbolSize);
+    }
+
+    std::size_t symbolsOffset() const {
+        return align(nodesOffset() + (std::size_t)mNodeCount * sizeof(Node));
+    }
+
+    std::size_t targetsOffset() const {
+        return align(symbolsOffset() + (std::size_t)mEdgeCount * mSymbolSize);
+    }
+
+    std::size_t valuesOffset() const {
+        return align(targetsOffset() + (std::size_t)mEdgeCount * sizeof(unsigned int));
+    }
+
+    std::size_t fileSize() const {
+        return valuesOffset() + (std::size_t)mValueCount * mValueSize;
+    }
+
+    /*!
+     * Checks each part against length before the next offset is taken, so the counts of a corrupt
+     * header cannot wrap the offsets around in to the file
+     * @param length Size of the file
+     * @return true if all the parts are in the first length bytes
+     */
+    bool fits(std::size_t length) const {
+        return mSymbolSize > 0 && mValueSize > 0 && endSymbolOffset() + mSymbolSize <= length &&
+               fitsAt(nodesOffset(), mNodeCount, sizeof(Node), length) &&
+               fitsAt(symbolsOffset(), mEdgeCount, mSymbolSize, length) &&
+               fitsAt(targetsOffset(), mEdgeCount, sizeof(unsigned int), length) &&
+               fitsAt(valuesOffset(), mValueCount, mValueSize, length);
+    }
+
+    static bool fitsAt(std::size_t offset, unsigned int count, std::size_t size, std::size_t length) {
+        return offset <= length && count <= (length - offset) / size;
+    }
+
+    char mMagic[8];
+    unsigned int mFormat;
+    unsigned int mSymbolSize;
+    unsigned int mValueSize;
+    unsigned int mNodeCount;
+    unsigned int mEdgeCount;
+    unsigned int mValueCount;
+    unsigned int mRoot;
+    unsigned int mReserved;
+};
+
+/*!
+ * @brief Writes the elements of a Trie in the format of rtv::TrieFileHeader, used by Trie::save.
+ *
+ * The keys are taken in the order of the iteration, in which the keys under a node are contiguous,
+ * and a node is written after all the nodes below it.
+ */
+template < typename T,
+typename V,
+typename Cmp > class TrieFileWriter
+{
+private:
+    typedef std::pair<T, unsigned int> Edge;
+
+    // Node whose subtree is still being read
+    struct Open {
+        Open()
+                : mValue(0) {}
+
+        std::vector<Edge> mEdges;
+        unsigned int mValue;
+    };
+
+    static bool edgeLess(Edge const &e1, Edge const &e2) {
+        return Cmp()(e1.first, e2.first);
+    }
+
+public:
+    explicit TrieFileWriter(const T &endSymbol)
+            : mEndSymbol(endSymbol),
+            mOpen(1) {}
+
+    /*!
+     * Writes the elements of a range of Trie iterators to a file
+     * @param path Name of the file, which is replaced
+     * @param first Iterator to the first element
+     * @param last Iterator past the last element
+     * @return true if the file is written, false otherwise
+     */
+    template <typename ConstIterator>
+    bool write(const char *path, ConstIterator first, ConstIterator last) {
+        for (; first != last; ++first) {
+            add(first->first, *first->second);
+        }
+        while (mOpen.size() > 1) {
+            closeNode();
+        }
+        unsigned int root = emit(mOpen.back());
+
+        TrieFileHeader header;
+        std::fill(header.mMagic, header.mMagic + sizeof(header.mMagic), 0);
+        std::copy(TrieFileHeader::magic(), TrieFileHeader::magic() + 7, header.mMagic);
+        header.mFormat = TrieFileHeader::Format;
+        header.mSymbolSize = sizeof(T);
+        header.mValueSize = sizeof(V);
+        header.mNodeCount = (unsigned int)mNodes.size();
+        header.mEdgeCount = (unsigned int)mSymbols.size();
+        header.mValueCount = (unsigned int)mValues.size();
+        header.mRoot = root;
+        header.mReserved = 0;
+
+        std::FILE *file = std::fopen(path, "wb");
+        if (!file) {
+            return false;
+        }
+        bool written = writePart(file, &header, sizeof(header), 0) &&
+                       writePart(file, &mEndSymbol, sizeof(T), header.endSymbolOffset()) &&
+                       writePart(file, data(mNodes), mNodes.size() * sizeof(TrieFileHeader::Node),
+                                 header.nodesOffset()) &&
+                       writePart(file, data(mSymbols), mSymbols.size() * sizeof(T), header.symbolsOffset()) &&
+                       writePart(file, data(mTargets), mTargets.size() * sizeof(unsigned int),
+                                 header.targetsOffset()) &&
+                       writePart(file, data(mValues), mValues.size() * sizeof(V), header.valuesOffset());
+        return std::fclose(file) == 0 && written;
+    }
+
+private:
+    TrieFileWriter(TrieFileWriter const &);
+    TrieFileWriter &operator=(TrieFileWriter const &);
+
+    template <typename E>
+    static const void *data(std::vector<E> const &v) {
+        return v.empty() ? 0 : &v[0];
+    }
+
+    // Pads the file up to offset and writes the part
+    static bool writePart(std::FILE *file, const void *part, std::size_t size, std::size_t offset) {
+        for (long at = std::ftell(file); at >= 0 && (std::size_t)at < offset; ++at) {
+            if (std::fputc(0, file) == EOF) {
+                return false;
+            }
+        }
+        return size == 0 || std::fwrite(part, size, 1, file) == 1;
+    }
+
+    void add(const T *key, V const &value) {
+        // the nodes of the previous key which are not on the path of this key are complete
+        std::size_t common = 0;
+        while (common < mPath.size() && key[common] != mEndSymbol && key[common] == mPath[common]) {
+            ++common;
+        }
+        while (mPath.size() > common) {
+            closeNode();
+        }
+        for (; key[common] != mEndSymbol; ++common) {
+            mPath.push_back(key[common]);
+            mOpen.push_back(Open());
+        }
+        mValues.push_back(value);
+        mOpen.back().mValue = (unsigned int)mValues.size();
+    }
+
+    void closeNode() {
+        unsigned int node = emit(mOpen.back());
+        mOpen.pop_back();
+        mOpen.back().mEdges.push_back(Edge(mPath.back(), node));
+        mPath.pop_back();
+    }
+
+    unsigned int emit(Open &open) {
+        std::sort(open.mEdges.begin(), open.mEdges.end(), &edgeLess);
+        TrieFileHeader::Node node;
+        node.mFirstEdge = (unsigned int)mSymbols.size();
+        node.mEdgeCount = (unsigned int)open.mEdges.size();
+        node.mValue = open.mValue;
+        for (std::size_t i = 0; i < open.mEdges.size(); ++i) {
+            mSymbols.push_back(open.mEdges[i].first);
+            mTargets.push_back(open.mEdges[i].second);
+        }
+        mNodes.push_back(node);
+        return (unsigned int)(mNodes.size() - 1);
+    }
+
+private:
+    T mEndSymbol;
+    std::vector<T> mPath;
+    std::vector<Open> mOpen;
+    std::vector<TrieFileHeader::Node> mNodes;
+    std::vector<T> mSymbols;
+    std::vector<unsigned int> mTargets;
+    std::vector<V> mValues;
+};
+
+/*!
+ * @mainpage Simple Trie
+ * @section intro_sec Introduction
+ * This is an implementation of prefix Trie data structure. This implementation is in C++ and using template.
+ * @section features Features
+ * Following are the main operations provided by the Trie.
+ * <ul>
+ * <li>Adding key, value pair
+ * <li>Removing an element by key
+ * <li>Checking the existence of a key
+ * <li>Retrieving value by key
+ * <li>Find elements with common prefix
+ * <li>Iterator
+ * <li>Sorted array node layout searched with SSE2 or AVX2
+ * <li>Bitmap node layout with a dense item array indexed by population count
+ * <li>Hash table node layout for large alphabets
+ * <li>Dense nodes near the root and sparse nodes below, with a report of the best depth to switch
+ * <li>Path compression
+ * <li>Slab allocation of nodes
+ * <li>Length delimited keys
+ * <li>Batched lookup with prefetching
+ * <li>Longest prefix match
+ * <li>Finding all keys which are prefixes of a key
+ * <li>Bulk loading of sorted keys
+ * <li>Parallel loading on several threads (C++11)
+ * <li>Lock free lookups and writers locking only the nodes they change, rtv::ConcurrentTrie (C++11)
+ * <li>Constant time snapshots with path copying, rtv::PersistentTrie (C++11)
+ * <li>Parallel writers on independently locked shards, rtv::ShardedTrie (C++11)
+ * <li>Saving to a file which is memory mapped and read without loading, rtv::MappedTrie
+ * <li>Compact read only double array Trie made from a Trie by rtv::freeze, rtv::DoubleArrayTrie
+ * <li>Succinct read only Trie of about 2 bits a node for the shape, rtv::LoudsTrie
+ * </ul>
+ */
+
+
+/*!
+ * @brief Trie main class
+ * @tparam T Type for each element in the key
+ * @tparam V Type of the value that the key will be representing
+ * @tparam Cmp Comparison functor
+ * @tparam Items The data structure that represents each node in the Trie.
+ *               Items can be rtv::SetItems<T, V, Cmp, A>, rtv::VectorItems<T, V, Cmp, Max, M, A>,
+ *               rtv::AdaptiveItems<T, V, Cmp, Max, M, A>, rtv::SortedArrayItems<T, V, Cmp, A>,
+ *               rtv::BitmapItems<T, V, Cmp, Max, M, A>, rtv::HashItems<T, V, Cmp, M, A> or
+ *               rtv::HybridItems<T, V, Cmp, Depth, Max, M, A>,
+ *               Max is the integer representing number of elements in each Trie node and
+ *               A is the allocator used for the nodes, rtv::HeapAllocator by default.
+ *
+ * @section usage_sec Usage of the Trie
+ * @subsection usage_declaration Declarating the Trie
+ * A Trie with key as chars and value as std::string can be declared as given below
+ * @code
+ * #include <string>
+ * #include <trie.h>
+ *
+ * int main(int argc, char ** argv) {
+ *
+ *     rtv::Trie<char, std::string> dictionary('$');
+ *
+ *     return 0;
+ * }
+ * @endcode
+ *
+ * @subsection usage_population Populatiion and deletion from the Trie
+ * Trie can be populated by using the Trie::insert method and element can be removed using Trie::erase.
+ * @code
+ * #include <trie.h>
+ * #include <string>
+ * #include <iostream>
+ *
+ * int main(int argc, char ** argv) {
+ *
+ *     rtv::Trie<char, std::string> dictionary('$');
+ *
+ *     // adding key value pair to the Trie
+ *     if (dictionary.insert("karma$", "Destiny or fate, following as effect from cause").second) {
+ *         std::cout << "added karma" << std::endl;
+ *     }
+ *
+ *     // removing key from the Trie
+ *     if (dictionary.erase("karma$")) {
+ *         std::cout << "removed karma" << std::endl;
+ *     }
+ *
+ *     return 0;
+ * }
+ *
+ * @endcode
+ * @subsection usage_retrieval Retrieval of Value
+ * Value for a key can be retrieved using Trie::get method and
+ * the existence of the key can be tested using Trie::hasKey method.
+ * @code
+ * #include <trie.h>
+ * #include <string>
+ * #include <iostream>
+ *
+ * int main(int argc, char ** argv) {
+ *
+ *     rtv::Trie<char, std::string> dictionary('$');
+ *
+ *     dictionary.insert("karma$", "Destiny or fate, following as effect from cause");
+ *
+ *     if (dictionary.hasKey("karma$")) {
+ *         std::cout << "key karma found" << std::endl;
+ *     }
+ *     std::string * result = dictionary.get("karma$");
+ *     if (result) {
+ *         std::cout << result->c_str() << std::endl;
+ *     }
+ *
+ *     return 0;
+ * }
+ * @endcode
+ *
+ * @subsection usage_length_delimited Keys without the end symbol
+ * Every method taking a key also accepts the key with its length, or a std::basic_string_view when
+ * compiled as C++17. The key is then used as it is without appending the end symbol,
+ * the key should not contain the end symbol.
+ * @code
+ * #include <trie.h>
+ * #include <string>
+ *
+ * int main(int argc, char ** argv) {
+ *
+ *     rtv::Trie<char, std::string> dictionary('$');
+ *     std::string key("karma");
+ *
+ *     dictionary.insert(key.data(), key.size(), "Destiny or fate, following as effect from cause");
+ *     std::string * result = dictionary.get(key.data(), key.size());
+ *
+ *     return 0;
+ * }
+ * @endcode
+ *
+ * @subsection usage_searching Searching keys which have common prefix
+ * Keys which begins with a specific charactars can be retrieved using Trie::startsWith method
+ * @code
+ * #include <trie.h>
+ * #include <string>
+ * #include <iostream>
+ * #include <vector>
+ *
+ * int main(int argc, char ** argv) {
+ *
+ *     rtv::Trie<char, std::string> dictionary('\0');
+ *
+ *     dictionary.insert("karma", "Destiny or fate, following as effect from cause");
+ *     rtv::Trie<char, std::string>::Iterator iter = dictionary.startsWith("kar");
+ *
+ *     for (; iter != dictionary.end(); ++iter) {
+ *         std::cout << iter->first << " : " << iter->second->c_str() << std::endl;
+ *     }
+ *
+ *     return 0;
+ * }
+ * @endcode
+ *
+ * @subsection usage_array_of_node Trie with each Node as an array
+ * Here each node of the Trie is an array. The advantage is that the searching of a symbol in the array takes O(1) time (is constant time).
+ * The disadvantage is that the array will have empty elements so the space used will more than actually required.
+ *
+ * @code
+ *
+ * #include <trie.h>
+ * #include <string>
+ * #include <iostream>
+ * #include <vector>
+ *
+ * int main(int argc, char ** argv) {
+ *
+ *     // Here 256 is the size of array in each node
+ *     rtv::Trie<char, std::string, std::less<char>,
+ *               rtv::VectorItems<char, std::string, std::less<char>, 256> > dictionary('$');
+ *
+ *     return 0;
+ * }
+ * @endcode
+ *
+ * @subsection usage_vector_item Efficient use of Trie for alphabets
+ * Below example shows how to use Trie to operate on alphabets efficiently.
+ * Here VectorItems is used to store alphabets with size of 28 (26 alphabets + space + end symbol).
+ *
+ * @code
+ * #include <trie.h>
+ * #include <string>
+ * #include <iostream>
+ * #include <vector>
+ * #include <cctype>
+ *
+ * class TrieCaseInsensitiveCompare
+ * {
+ * public:
+ *     bool operator()(char v1, char v2) {
+ *         int i1 = std::tolower(v1);
+ *         int i2 = std::tolower(v2);
+ *         return i1 < i2;
+ *     }
+ * };
+ *
+ * // key to vector index converter
+ * // case insensitive and includes alphabets, space and end symbol
+ * class AlphaToIndex
+ * {
+ * public:
+ *     unsigned int operator()(const char & c) const {
+ *         unsigned int index = 0;
+ *         if (c == ' ') {
+ *             index = 27;
+ *         } else if (c >= 'A' && c <= 'Z') {
+ *             index = c - 'A' + 1;
+ *         } else if (c >= 'a' && c <= 'z') {
+ *             index = c - 'a' + 1;
+ *         }
+ *         return index;
+ *     }
+ * };
+ *
+ * int main(int argc, char ** argv) {
+ *
+ *     rtv::Trie<char, std::string,
+ *               TrieCaseInsensitiveCompare,
+ *               rtv::VectorItems<char, std::string, TrieCaseInsensitiveCompare, 28, AlphaToIndex>
+ *               > dictionary('\0');
+ *
+ *     // adding key value pair to the Trie
+ *     if (dictionary.insert("karma", "Destiny or fate, following as effect from cause").second) {
+ *         std::cout << "added karma" << std::endl;
+ *     }
+ *
+ *     // removing key from the Trie
+ *     if (dictionary.erase("karma")) {
+ *         std::cout << "removed karma" << std::endl;
+ *     }
+ *
+ *     return 0;
+ * }
+ *
+ * @endcode
+ *
+ * @subsection usage_set_of_node Trie with each Node as a set
+ * Here each node will be an ordered set.
+ * Here there will be no extra usage of space but search for a symbol in the node takes logarithmic time.
+ * Trie with this feature can also be used for caseinsensitive symbol handling.
+ * @code
+ *
+ * #include <trie.h>
+ * #include <string>
+ * #include <iostream>
+ * #include <set>
+ *
+ * int main(int argc, char ** argv) {
+ *
+ *     rtv::Trie<char, std::string, std::less<char>,
+ *               rtv::SetItems<char, std::string, std::less<char> > > dictionary('$');
+ *
+ *     return 0;
+ * }
+ * @endcode
+ * @subsection usage_adaptive_node Trie with each Node adapting its layout
+ * Here each node starts as a small sorted array and grows to an array of size Max as items are added.
+ * Searching a symbol takes near constant time while the space used stays propotional to the number of items.
+ * @code
+ *
+ * #include <trie.h>
+ * #include <string>
+ *
+ * int main(int argc, char ** argv) {
+ *
+ *     rtv::Trie<char, std::string, std::less<char>,
+ *               rtv::AdaptiveItems<char, std::string, std::less<char>, 256> > dictionary('$');
+ *
+ *     return 0;
+ * }
+ * @endcode
+ *
+ * @subsection usage_sorted_array_node Trie with each Node as a sorted array
+ * Here the symbols of each node are kept in a sorted array next to the array of its items.
+ * The space used is propotional to the number of items, and for integer symbols compared by std::less
+ * the symbols are searched with SSE2 or AVX2 when the compiler targets them.
+ * @code
+ *
+ * #include <trie.h>
+ * #include <string>
+ *
+ * int main(int argc, char ** argv) {
+ *
+ *     rtv::Trie<char, std::string, std::less<char>,
+ *               rtv::SortedArrayItems<char, std::string, std::less<char> > > dictionary('$');
+ *
+ *     return 0;
+ * }
+ * @endcode
+ *
+ * @subsection usage_bitmap_node Trie with each Node as a bitmap
+ * Here each node keeps a bitmap of Max bits and an array of only the items which are present.
+ * Searching a symbol takes constant time as with the array of size Max, while a node with a few items
+ * takes a few dozen bytes instead of Max pointers.
+ * @code
+ *
+ * #include <trie.h>
+ * #include <string>
+ *
+ * int main(int argc, char ** argv) {
+ *
+ *     rtv::Trie<char, std::string, std::less<char>,
+ *               rtv::BitmapItems<char, std::string, std::less<char>, 256> > dictionary('$');
+ *
+ *     return 0;
+ * }
+ * @endcode
+ *
+ * @subsection usage_hash_node Trie with each Node as a hash table
+ * For large alphabets such as wchar_t or the numbers of the tokens of a text, each node can keep its items
+ * in a hash table. Searching a symbol takes constant time on average and the table grows with the node.
+ * @code
+ *
+ * #include <trie.h>
+ *
+ * int main(int argc, char ** argv) {
+ *
+ *     rtv::Trie<unsigned int, int, std::less<unsigned int>,
+ *               rtv::HashItems<unsigned int, int, std::less<unsigned int> > > ngrams(0xffffffffu);
+ *
+ *     unsigned int tokens[] = {17, 4711, 42};
+ *     ngrams.insert(tokens, 3, 1);
+ *
+ *     return 0;
+ * }
+ * @endcode
+ *
+ * @subsection usage_hybrid_node Trie with dense nodes near the root
+ * Here the nodes above Depth are arrays of size Max and the nodes below are sorted arrays of only their items.
+ * Trie::stats counts the nodes at each depth of a Trie, whatever its Items, and reports the bytes each Depth
+ * would take.
+ * @code
+ *
+ * #include <trie.h>
+ * #include <string>
+ * #include <cstdio>
+ *
+ * int main(int argc, char ** argv) {
+ *
+ *     typedef rtv::HybridItems<char, std::string, std::less<char>, 2, 256> Hybrid;
+ *     rtv::Trie<char, std::string, std::less<char>, Hybrid> dictionary('$');
+ *
+ *     dictionary.insert("karma$", "Destiny or fate, following as effect from cause");
+ *     dictionary.stats().report<Hybrid>(stdout);
+ *
+ *     return 0;
+ * }
+ * @endcode
+ *
+ * @subsection usage_path_compression Trie with path compression
+ * Long keys such as URLs create long chains of nodes with a single child.
+ * With path compression each chain is stored as a single node holding a multi symbol label,
+ * the label is split on insertion and merged back on removal.
+ * @code
+ *
+ * #include <trie.h>
+ * #include <string>
+ *
+ * int main(int argc, char ** argv) {
+ *
+ *     rtv::Trie<char, std::string> urls('\0', true);
+ *
+ *     urls.insert("http://www.example.com/index.html", "index");
+ *     urls.insert("http://www.example.com/about.html", "about");
+ *
+ *     return 0;
+ * }
+ * @endcode
+ *
+ * @subsection usage_slab_allocator Trie with slab allocated nodes
+ * Nodes and node items can be carved out of large slabs instead of allocating each of them from the heap.
+ * Erased nodes are reused by later insertions and all the slabs are freed at once when the Trie is cleared.
+ * @code
+ *
+ * #include <trie.h>
+ * #include <string>
+ *
+ * int main(int argc, char ** argv) {
+ *
+ *     rtv::Trie<char, std::string, std::less<char>,
+ *               rtv::SetItems<char, std::string, std::less<char>, rtv::SlabAllocator<> > > dictionary('$');
+ *
+ *     return 0;
+ * }
+ * @endcode
+ * @subsection usage_iterator Using Trie::Iterator
+ * Trie iterator can be used the same way as STL iterator.
+ * Key and value can be accessed from iterator using first and secod member.
+ * first is vector of key characters and second is a pointer to the value.
+ * @code
+ * #include <trie.h>
+ * #include <string>
+ * #include <iostream>
+ * #include <vector>
+ *
+ * int main(int argc, char ** argv) {
+ *
+ *     rtv::Trie<char, std::string> dictionary('\0');
+ *
+ *     dictionary.insert("karma$", "Destiny or fate, following as effect from cause");
+ *
+ *     rtv::Trie<char, std::string>::Iterator iter = dictionary.begin();
+ *     rtv::Trie<char, std::string>::Iterator iend = dictionary.end();
+ *
+ *     for (; iter != iend; ++iter) {
+ *
+ *         std::cout << iter->first  << " " << iter->second->c_str() << std::endl;
+ *     }
+ *
+ *     return 0;
+ * }
+ * @endcode
+ */
+template < typename T,
+typename V,
+typename Cmp = std::less<T>,
+typename Items = SetItems<T, V, Cmp> > class Trie
+{
+public:
+    typedef typename Node<T, V, Cmp, Items>::Iterator Iterator;
+    typedef typename Node<T, V, Cmp, Items>::ConstIterator ConstIterator;
+    typedef typename Node<T, V, Cmp, Items>::Allocator Allocator;
+
+public:
+    /*!
+     * @param endSymbol The symbol which marks the end of key input
+     * @param pathCompression If true a chain of nodes with a single child is stored as one node
+     *                        holding a multi symbol label, this reduces the number of nodes for long keys
+     */
+    Trie(const T &endSymbol, bool pathCompression = false)
+            : mRoot(endSymbol, 0, mAllocator.get(), pathCompression) {}
+
+#ifdef RTV_HAS_CXX11
+    /*!
+     * Moves the elements of oth in to the new Trie in constant time, oth is left empty.
+     * All the iterators of oth become invalid. oth is left without an allocator, which it makes
+     * the next time a key is added to it, so the move allocates nothing
+     * @param oth The Trie to be moved from
+     */
+    Trie(Trie &&oth) noexcept
+            : mAllocator(0),
+            mRoot(oth.endSymbol(), 0, 0, oth.pathCompression()) {
+        swap(oth);
+    }
+
+    /*!
+     * Drops the elements of the Trie and moves the elements of oth in to it in constant time,
+     * oth is left empty. All the iterators of both Tries become invalid
+     * @param oth The Trie to be moved from
+     * @return Reference to the Trie
+     */
+    Trie &operator=(Trie &&oth) noexcept {
+        if (this != &oth) {
+            clear();
+            swap(oth);
+        }
+        return *this;
+    }
+#endif
+
+    /*!
+     * Exchanges the elements, the end symbol and the allocator of the two Tries in constant time.
+     * All the iterators of both Tries become invalid, as an iterator climbs from its node up to the
+     * root it was taken from
+     * @param oth The Trie to be swapped with
+     */
+    void swap(Trie &oth) {
+        mAllocator.swap(oth.mAllocator);
+        mRoot.swap(oth.mRoot);
+    }
+
+    /*!
+     * Add a key with value in to the Trie
+     * @param key Key which should be inserted, should be terminated by 'end' symbol
+     * @param value The value that is to be set with the key
+     * @return An std::pair with pair::first set to the Iterator points to the element and pair::second to true is key is newly inserted, false otherwise
+     */
+    std::pair<Iterator, bool> insert(const T *key, V const &value) {
+        return root().insert(key, value);
+    }
+
+    /*!
+     * Add a key with value in to the Trie
+     * @param key Key which should be inserted, need not be terminated by 'end' symbol
+     * @param length Number of symbols in the key, the key should not contain the 'end' symbol
+     * @param value The value that is to be set with the key
+     * @return An std::pair with pair::first set to the Iterator points to the element and pair::second to true is key is newly inserted, false otherwise
+     */
+    std::pair<Iterator, bool> insert(const T *key, std::size_t length, V const &value) {
+        return root().insert(key, length, value);
+    }
+
+#ifdef RTV_HAS_STRING_VIEW
+    /*!
+     * Add a key with value in to the Trie
+     * @param key Key which should be inserted, should not contain the 'end' symbol
+     * @param value The value that is to be set with the key
+     * @return An std::pair with pair::first set to the Iterator points to the element and pair::second to true is key is newly inserted, false otherwise
+     */
+    std::pair<Iterator, bool> insert(std::basic_string_view<T> key, V const &value) {
+        return root().insert(key.data(), key.size(), value);
+    }
+#endif
+
+    /*!
+     * Add a key with value in to the Trie without building an Iterator to the element,
+     * which makes it faster than Trie::insert when loading many keys
+     * @param key Key which should be inserted, should be terminated by 'end' symbol
+     * @param value The value that is to be set with the key
+     * @return An std::pair with pair::first set to pointer to the value of the element (0 on failure)
+     *         and pair::second to true is key is newly inserted, false otherwise
+     */
+    std::pair<V *, bool> insertFast(const T *key, V const &value) {
+        return root().insertFast(key, Node<T, V, Cmp, Items>::npos, value);
+    }
+
+    /*!
+     * Add a key with value in to the Trie without building an Iterator to the element
+     * @param key Key which should be inserted, need not be terminated by 'end' symbol
+     * @param length Number of symbols in the key, the key should not contain the 'end' symbol
+     * @param value The value that is to be set with the key
+     * @return An std::pair with pair::first set to pointer to the value of the element (0 on failure)
+     *         and pair::second to true is key is newly inserted, false otherwise
+     */
+    std::pair<V *, bool> insertFast(const T *key, std::size_t length, V const &value) {
+        return root().insertFast(key, length, value);
+    }
+
+#ifdef RTV_HAS_STRING_VIEW
+    /*!
+     * Add a key with value in to the Trie without building an Iterator to the element
+     * @param key Key which should be inserted, should not contain the 'end' symbol
+     * @param value The value that is to be set with the key
+     * @return An std::pair with pair::first set to pointer to the value of the element (0 on failure)
+     *         and pair::second to true is key is newly inserted, false otherwise
+     */
+    std::pair<V *, bool> insertFast(std::basic_string_view<T> key, V const &value) {
+        return root().insertFast(key.data(), key.size(), value);
+    }
+#endif
+
+    /*!
+     * Add a key with value in to the Trie, the value of the key is replaced if the key is already present
+     * @param key Key which should be inserted, should be terminated by 'end' symbol
+     * @param value The value that is to be set with the key
+     * @return An std::pair with pair::first set to the Iterator points to the element and pair::second to true is key is newly inserted, false if the value is assigned
+     */
+    std::pair<Iterator, bool> insertOrAssign(const T *key, V const &value) {
+        return root().insertOrAssign(key, Node<T, V, Cmp, Items>::npos, value);
+    }
+
+    /*!
+     * Add a key with value in to the Trie, the value of the key is replaced if the key is already present
+     * @param key Key which should be inserted, need not be terminated by 'end' symbol
+     * @param length Number of symbols in the key, the key should not contain the 'end' symbol
+     * @param value The value that is to be set with the key
+     * @return An std::pair with pair::first set to the Iterator points to the element and pair::second to true is key is newly inserted, false if the value is assigned
+     */
+    std::pair<Iterator, bool> insertOrAssign(const T *key, std::size_t length, V const &value) {
+        return root().insertOrAssign(key, length, value);
+    }
+
+#ifdef RTV_HAS_STRING_VIEW
+    /*!
+     * Add a key with value in to the Trie, the value of the key is replaced if the key is already present
+     * @param key Key which should be inserted, should not contain the 'end' symbol
+     * @param value The value that is to be set with the key
+     * @return An std::pair with pair::first set to the Iterator points to the element and pair::second to true is key is newly inserted, false if the value is assigned
+     */
+    std::pair<Iterator, bool> insertOrAssign(std::basic_string_view<T> key, V const &value) {
+        return root().insertOrAssign(key.data(), key.size(), value);
+    }
+#endif
+
+#ifdef RTV_HAS_CXX11
+    /*!
+     * Add a key with value in to the Trie, the value is moved in to the Trie if the key is inserted
+     * @param key Key which should be inserted, should be terminated by 'end' symbol
+     * @param value The value that is to be set with the key
+     * @return An std::pair with pair::first set to the Iterator points to the element and pair::second to true is key is newly inserted, false otherwise
+     */
+    std::pair<Iterator, bool> insert(const T *key, V &&value) {
+        return root().insert(key, Node<T, V, Cmp, Items>::npos, std::move(value));
+    }
+
+    /*!
+     * Add a key with value in to the Trie, the value is moved in to the Trie if the key is inserted
+     * @param key Key which should be inserted, need not be terminated by 'end' symbol
+     * @param length Number of symbols in the key, the key should not contain the 'end' symbol
+     * @param value The value that is to be set with the key
+     * @return An std::pair with pair::first set to the Iterator points to the element and pair::second to true is key is newly inserted, false otherwise
+     */
+    std::pair<Iterator, bool> insert(const T *key, std::size_t length, V &&value) {
+        return root().insert(key, length, std::move(value));
+    }
+
+    /*!
+     * Add a key with value in to the Trie, the value of the key is replaced if the key is already present.
+     * The value is moved in to the Trie in both the cases
+     * @param key Key which should be inserted, should be terminated by 'end' symbol
+     * @param value The value that is to be set with the key
+     * @return An std::pair with pair::first set to the Iterator points to the element and pair::second to true is key is newly inserted, false if the value is assigned
+     */
+    std::pair<Iterator, bool> insertOrAssign(const T *key, V &&value) {
+        return root().insertOrAssign(key, Node<T, V, Cmp, Items>::npos, std::move(value));
+    }
+
+    /*!
+     * Add a key with value in to the Trie, the value of the key is replaced if the key is already present.
+     * The value is moved in to the Trie in both the cases
+     * @param key Key which should be inserted, need not be terminated by 'end' symbol
+     * @param length Number of symbols in the key, the key should not contain the 'end' symbol
+     * @param value The value that is to be set with the key
+     * @return An std::pair with pair::first set to the Iterator points to the element and pair::second to true is key is newly inserted, false if the value is assigned
+     */
+    std::pair<Iterator, bool> insertOrAssign(const T *key, std::size_t length, V &&value) {
+        return root().insertOrAssign(key, length, std::move(value));
+    }
+
+    /*!
+     * Add a key in to the Trie with the value constructed in place from args.
+     * The value is constructed only if the key is not already present, so Trie::emplace and
+     * Trie::tryEmplace behave the same
+     * @param key Key which should be inserted, should be terminated by 'end' symbol
+     * @param args Arguments passed to the constructor of the value
+     * @return An std::pair with pair::first set to the Iterator points to the element and pair::second to true is key is newly inserted, false otherwise
+     */
+    template <typename... Args>
+    std::pair<Iterator, bool> emplace(const T *key, Args&&... args) {
+        return root().emplace(key, Node<T, V, Cmp, Items>::npos, std::forward<Args>(args)...);
+    }
+
+    /*!
+     * Add a key in to the Trie with the value constructed in place from args,
+     * nothing is constructed if the key is already present
+     * @param key Key which should be inserted, should be terminated by 'end' symbol
+     * @param args Arguments passed to the constructor of the value
+     * @return An std::pair with pair::first set to the Iterator points to the element and pair::second to true is key is newly inserted, false otherwise
+     */
+    template <typename... Args>
+    std::pair<Iterator, bool> tryEmplace(const T *key, Args&&... args) {
+        return root().emplace(key, Node<T, V, Cmp, Items>::npos, std::forward<Args>(args)...);
+    }
+
+#ifdef RTV_HAS_STRING_VIEW
+    /*!
+     * Add a key with value in to the Trie, the value is moved in to the Trie if the key is inserted
+     * @param key Key which should be inserted, should not contain the 'end' symbol
+     * @param value The value that is to be set with the key
+     * @return An std::pair with pair::first set to the Iterator points to the element and pair::second to true is key is newly inserted, false otherwise
+     */
+    std::pair<Iterator, bool> insert(std::basic_string_view<T> key, V &&value) {
+        return root().insert(key.data(), key.size(), std::move(value));
+    }
+
+    /*!
+     * Add a key with value in to the Trie, the value of the key is replaced if the key is already present.
+     * The value is moved in to the Trie in both the cases
+     * @param key Key which should be inserted, should not contain the 'end' symbol
+     * @param value The value that is to be set with the key
+     * @return An std::pair with pair::first set to the Iterator points to the element and pair::second to true is key is newly inserted, false if the value is assigned
+     */
+    std::pair<Iterator, bool> insertOrAssign(std::basic_string_view<T> key, V &&value) {
+        return root().insertOrAssign(key.data(), key.size(), std::move(value));
+    }
+
+    /*!
+     * Add a key in to the Trie with the value constructed in place from args, see Trie::emplace
+     * @param key Key which should be inserted, should not contain the 'end' symbol
+     * @param args Arguments passed to the constructor of the value
+     * @return An std::pair with pair::first set to the Iterator points to the element and pair::second to true is key is newly inserted, false otherwise
+     */
+    template <typename... Args>
+    std::pair<Iterator, bool> emplace(std::basic_string_view<T> key, Args&&... args) {
+        return root().emplace(key.data(), key.size(), std::forward<Args>(args)...);
+    }
+
+    /*!
+     * Add a key in to the Trie with the value constructed in place from args, see Trie::tryEmplace
+     * @param key Key which should be inserted, should not contain the 'end' symbol
+     * @param args Arguments passed to the constructor of the value
+     * @return An std::pair with pair::first set to the Iterator points to the element and pair::second to true is key is newly inserted, false otherwise
+     */
+    template <typename... Args>
+    std::pair<Iterator, bool> tryEmplace(std::basic_string_view<T> key, Args&&... args) {
+        return root().emplace(key.data(), key.size(), std::forward<Args>(args)...);
+    }
+#endif
+#endif
+
+    /*!
+     * Add the key value pairs of a range sorted by key in to the Trie.
+     * In to an empty Trie each key is built from the end of the path of the previous key, the items of the
+     * symbols it does not share with the previous key are appended to their nodes without searching them.
+     * The keys from the first one out of the order of Cmp, and all the keys when the Trie is not empty,
+     * are inserted one at a time. Keys already present are left unchanged.
+     * If an exception is thrown while the sorted keys are built in to an empty Trie, it is left empty.
+     * @param first Iterator to the first pair, pair::first is the key and pair::second is the value.
+     *              The key can be an std::basic_string, an std::vector or a pointer to symbols
+     *              terminated by 'end' symbol
+     * @param last Iterator past the last pair
+     * @return Number of keys newly inserted
+     */
+    template <typename InputIterator>
+    std::size_t bulkLoad(InputIterator first, InputIterator last) {
+        return root().bulkLoad(first, last);
+    }
+
+#ifdef RTV_HAS_CXX11
+    /*!
+     * Add the key value pairs of a range in to the Trie using several threads.
+     * The keys are grouped by their first prefixLength symbols and each worker thread builds the subtrees
+     * of its groups with Trie::bulkLoad and an allocator forked from the allocator of the Trie.
+     * The subtrees are then grafted on to the Trie and the allocators joined back. Where the Trie already
+     * has nodes on the path of a subtree the two are merged, splitting the labels of a compressed Trie
+     * where they differ, and the keys already present are left unchanged.
+     * Each group is built in the order of the range, so sorted ranges are built fastest.
+     * An exception thrown by a worker, std::bad_alloc for one, is rethrown by the calling thread once all
+     * the workers are done, the keys built by the workers are then dropped and the Trie is left as it was.
+     * @param first Iterator to the first pair, the range is traversed once and should be a forward range.
+     *              pair::first is the key and pair::second is the value, see Trie::bulkLoad
+     * @param last Iterator past the last pair
+     * @param threads Number of worker threads, 0 for std::thread::hardware_concurrency
+     * @param prefixLength Number of leading symbols which decide the group of a key,
+     *                     keys shorter than it are added by the calling thread
+     * @return Number of keys newly inserted
+     */
+    template <typename ForwardIterator>
+    std::size_t parallelLoad(ForwardIterator first, ForwardIterator last, unsigned int threads = 0,
+                             std::size_t prefixLength = 1) {
+        return root().parallelLoad(first, last, threads, prefixLength);
+    }
+#endif
+
+    /*!
+     * Writes the elements to a file which rtv::MappedTrie maps in to memory and reads without loading it.
+     * The values are copied byte by byte, so V should be a plain old data type
+     * @param path Name of the file, which is replaced
+     * @return true if the file is written, false otherwise
+     */
+    bool save(const char *path) const {
+#ifdef RTV_HAS_CXX11
+        static_assert(std::is_trivially_copyable<V>::value, "Trie::save copies the values byte by byte");
+#endif
+        return TrieFileWriter<T, V, Cmp>(endSymbol()).write(path, begin(), end());
+    }
+
+    /*!
+     * Remove the entry with the given key from the Trie
+     * @param key Key which should be erased, should be terminated by 'end' symbol
+     * @return true if the given key is erased from the Trie, false otherwise
+     */
+    bool erase(const T *key) {
+        return mRoot.erase(key);
+    }
+
+    /*!
+     * Remove the entry with the given key from the Trie
+     * @param key Key which should be erased, need not be terminated by 'end' symbol
+     * @param length Number of symbols in the key, the key should not contain the 'end' symbol
+     * @return true if the given key is erased from the Trie, false otherwise
+     */
+    bool erase(const T *key, std::size_t length) {
+        return mRoot.erase(key, length);
+    }
+
+#ifdef RTV_HAS_STRING_VIEW
+    /*!
+     * Remove the entry with the given key from the Trie
+     * @param key Key which should be erased, should not contain the 'end' symbol
+     * @return true if the given key is erased from the Trie, false otherwise
+     */
+    bool erase(std::basic_string_view<T> key) {
+        return mRoot.erase(key.data(), key.size());
+    }
+#endif
+
+    /*!
+     * Remove the entry with the given key from the Trie
+     * @param pos Iterator pointing to a single element to be removed from the Trie
+     * @return true if the given key is erased form the Trie, false otherwise
+     */
+    bool erase(Iterator pos) {
+        return mRoot.erase(pos);
+    }
+
+    /*!
+     * Retrieves the value for the given key
+     * @param key Key to be searched for, should be terminated by 'end' symbol
+     * @return Constant pointer to value for the given key, 0 on failure
+     */
+    const V *get(const T *key) const {
+        return mRoot.get(key);
+    }
+
+    /*!
+     * Retrieves the value for the given key
+     * @param key Key to be searched for, should be terminated by 'end' symbol
+     * @return Pointer to value for the given key, 0 on failure
+     */
+    V *get(const T *key) {
+        return mRoot.get(key);
+    }
+
+    /*!
+     * Retrieves the value for the given key
+     * @param key Key to be searched for, need not be terminated by 'end' symbol
+     * @param length Number of symbols in the key, the key should not contain the 'end' symbol
+     * @return Constant pointer to value for the given key, 0 on failure
+     */
+    const V *get(const T *key, std::size_t length) const {
+        return mRoot.get(key, length);
+    }
+
+    /*!
+     * Retrieves the value for the given key
+     * @param key Key to be searched for, need not be terminated by 'end' symbol
+     * @param length Number of symbols in the key, the key should not contain the 'end' symbol
+     * @return Pointer to value for the given key, 0 on failure
+     */
+    V *get(const T *key, std::size_t length) {
+        return mRoot.get(key, length);
+    }
+
+#ifdef RTV_HAS_STRING_VIEW
+    /*!
+     * Retrieves the value for the given key
+     * @param key Key to be searched for, should not contain the 'end' symbol
+     * @return Constant pointer to value for the given key, 0 on failure
+     */
+    const V *get(std::basic_string_view<T> key) const {
+        return mRoot.get(key.data(), key.size());
+    }
+
+    /*!
+     * Retrieves the value for the given key
+     * @param key Key to be searched for, should not contain the 'end' symbol
+     * @return Pointer to value for the given key, 0 on failure
+     */
+    V *get(std::basic_string_view<T> key) {
+        return mRoot.get(key.data(), key.size());
+    }
+#endif
+
+    /*!
+     * Retrieves the value for the given key,
+     * If key does not match the key of any element in the Trie,
+     * the function inserts a new element with that key and returns a reference to its mapped value
+     * @param key Key to be searched for, should be terminated by 'end' symbol
+     * @return Reference to value for the given key
+     */
+    V &operator[](const T *key) {
+#ifdef RTV_HAS_CXX11
+        return *(root().emplaceFast(key, Node<T, V, Cmp, Items>::npos).first);
+#else
+        return *(insertFast(key, V()).first);
+#endif
+    }
+
+#ifdef RTV_HAS_STRING_VIEW
+    /*!
+     * Retrieves the value for the given key,
+     * If key does not match the key of any element in the Trie,
+     * the function inserts a new element with that key and returns a reference to its mapped value
+     * @param key Key to be searched for, should not contain the 'end' symbol
+     * @return Reference to value for the given key
+     */
+    V &operator[](std::basic_string_view<T> key) {
+        return *(root().emplaceFast(key.data(), key.size()).first);
+    }
+#endif
+
+    /*!
+     * Checks whether the given key is present in the Trie
+     * @param key Key to be searched for, should be terminated by 'end' symol
+     * @return true if the key is present
+     */
+    bool hasKey(const T *key) const {
+        return mRoot.hasKey(key);
+    }
+
+    /*!
+     * Checks whether the given key is present in the Trie
+     * @param key Key to be searched for, need not be terminated by 'end' symbol
+     * @param length Number of symbols in the key, the key should not contain the 'end' symbol
+     * @return true if the key is present
+     */
+    bool hasKey(const T *key, std::size_t length) const {
+        return mRoot.hasKey(key, length);
+    }
+
+#ifdef RTV_HAS_STRING_VIEW
+    /*!
+     * Checks whether the given key is present in the Trie
+     * @param key Key to be searched for, should not contain the 'end' symbol
+     * @return true if the key is present
+     */
+    bool hasKey(std::basic_string_view<T> key) const {
+        return mRoot.hasKey(key.data(), key.size());
+    }
+#endif
+
+    /*!
+     * Test whether Trie is empty
+     * @return true if the Trie size is 0, false otherwise
+     */
+    bool empty() const {
+        return mRoot.empty();
+    }
+
+    /*!
+     * Counts the nodes, items and values at each depth of the Trie, for choosing the Depth of rtv::HybridItems
+     * @return The counts of the Trie
+     */
+    TrieStats stats() const {
+        TrieStats stats;
+        mRoot.collectStats(stats, 0);
+        return stats;
+    }
+
+    /*!
+     * Returns the number of elements in the Trie
+     * @return Number of key value pair in the Trie
+     */
+    unsigned int size() const {
+        return mRoot.size();
+    }
+
+    /*!
+     * All the elements in the Trie are dropped, leaving the Trie with a size of 0.
+     * Memory held by the allocator of the Trie is released as well.
+     */
+    void clear() {
+        mRoot.clear();
+        if (mAllocator.get()) {
+            mAllocator.get()->release();
+        }
+    }
+
+    /*!
+     * Retrieves Iterator to the elements with common prefix
+     * @param prefix Part of the key which should be searched, should be terminated by 'end' symbol
+     * @return Iterator to the elements with prefix specified in 'prefix'
+     */
+    Iterator startsWith(const T *prefix) {
+        return mRoot.startsWith(prefix);
+    }
+
+    /*!
+     * Retrieves ConstIterator to the elements with common prefix
+     * @param prefix Part of the key which should be searched, should be terminated by 'end' symbol
+     * @return ConstIterator to the elements with prefix specified in 'prefix'
+     */
+    ConstIterator startsWith(const T *prefix) const {
+        return mRoot.startsWith(prefix);
+    }
+
+    /*!
+     * Retrieves Iterator to the elements with common prefix
+     * @param prefix Part of the key which should be searched, need not be terminated by 'end' symbol
+     * @param length Number of symbols in the prefix, the prefix should not contain the 'end' symbol
+     * @return Iterator to the elements with prefix specified in 'prefix'
+     */
+    Iterator startsWith(const T *prefix, std::size_t length) {
+        return mRoot.startsWith(prefix, length);
+    }
+
+    /*!
+     * Retrieves ConstIterator to the elements with common prefix
+     * @param prefix Part of the key which should be searched, need not be terminated by 'end' symbol
+     * @param length Number of symbols in the prefix, the prefix should not contain the 'end' symbol
+     * @return ConstIterator to the elements with prefix specified in 'prefix'
+     */
+    ConstIterator startsWith(const T *prefix, std::size_t length) const {
+        return mRoot.startsWith(prefix, length);
+    }
+
+#ifdef RTV_HAS_STRING_VIEW
+    /*!
+     * Retrieves Iterator to the elements with common prefix
+     * @param prefix Part of the key which should be searched, should not contain the 'end' symbol
+     * @return Iterator to the elements with prefix specified in 'prefix'
+     */
+    Iterator startsWith(std::basic_string_view<T> prefix) {
+        return mRoot.startsWith(prefix.data(), prefix.size());
+    }
+
+    /*!
+     * Retrieves ConstIterator to the elements with common prefix
+     * @param prefix Part of the key which should be searched, should not contain the 'end' symbol
+     * @return ConstIterator to the elements with prefix specified in 'prefix'
+     */
+    ConstIterator startsWith(std::basic_string_view<T> prefix) const {
+        return mRoot.startsWith(prefix.data(), prefix.size());
+    }
+#endif
+
+    /*!
+     * Checks whether chains of single child nodes are compressed
+     * @return true if the Trie was created with path compression
+     */
+    bool pathCompression() const {
+        return mRoot.compressed();
+    }
+
+    /*!
+     * Retrieves the end symbol
+     * @return end symbol
+     */
+    T endSymbol() const {
+        return mRoot.endSymbol();
+    }
+
+    /*!
+     * Returns an iterator referring to the first element in the Trie
+     * @return An iterator to the first element in the Trie
+     */
+    Iterator begin() {
+        return mRoot.begin();
+    }
+
+    /*!
+     * Returns an iterator referring to the past-the-end element in the Trie
+     * @return An iterator to the element past the end of the Trie
+     */
+    Iterator end() {
+        return mRoot.end();
+    }
+
+    /*!
+     * Searches the Trie for an element with 'key' as key
+     * @param key Key to be searched for, should be terminated by 'end' symbol
+     * @return Iterator to the element with key 'key' if found, otherwise an Iterator to Trie::end
+     */
+    Iterator find(const T *key) {
+        return mRoot.find(key);
+    }
+
+    /*!
+     * Searches the Trie for an element with 'key' as key
+     * @param key Key to be searched for, should be terminated by 'end' symbol
+     * @return ConstIterator to the element with key 'key' if found, otherwise an ConstIterator to Trie::end
+     */
+    ConstIterator find(const T *key) const {
+        return mRoot.find(key);
+    }
+
+    /*!
+     * Searches the Trie for an element with 'key' as key
+     * @param key Key to be searched for, need not be terminated by 'end' symbol
+     * @param length Number of symbols in the key, the key should not contain the 'end' symbol
+     * @return Iterator to the element with key 'key' if found, otherwise an Iterator to Trie::end
+     */
+    Iterator find(const T *key, std::size_t length) {
+        return mRoot.find(key, length);
+    }
+
+    /*!
+     * Searches the Trie for an element with 'key' as key
+     * @param key Key to be searched for, need not be terminated by 'end' symbol
+     * @param length Number of symbols in the key, the key should not contain the 'end' symbol
+     * @return ConstIterator to the element with key 'key' if found, otherwise an ConstIterator to Trie::end
+     */
+    ConstIterator find(const T *key, std::size_t length) const {
+        return mRoot.find(key, length);
+    }
+
+#ifdef RTV_HAS_STRING_VIEW
+    /*!
+     * Searches the Trie for an element with 'key' as key
+     * @param key Key to be searched for, should not contain the 'end' symbol
+     * @return Iterator to the element with key 'key' if found, otherwise an Iterator to Trie::end
+     */
+    Iterator find(std::basic_string_view<T> key) {
+        return mRoot.find(key.data(), key.size());
+    }
+
+    /*!
+     * Searches the Trie for an element with 'key' as key
+     * @param key Key to be searched for, should not contain the 'end' symbol
+     * @return ConstIterator to the element with key 'key' if found, otherwise an ConstIterator to Trie::end
+     */
+    ConstIterator find(std::basic_string_view<T> key) const {
+        return mRoot.find(key.data(), key.size());
+    }
+#endif
+
+    /*!
+     * Finds the longest key in the Trie which is a prefix of the given key, walking the key only once
+     * @param key Key to be searched for, should be terminated by 'end' symbol
+     * @return An std::pair with pair::first set to the length of the longest matching key and
+     *         pair::second to pointer to its value, pair::second is 0 if no key matches
+     */
+    std::pair<std::size_t, V *> longestPrefixOf(const T *key) {
+        return mRoot.longestPrefixOf(key);
+    }
+
+    /*!
+     * Finds the longest key in the Trie which is a prefix of the given key, walking the key only once
+     * @param key Key to be searched for, should be terminated by 'end' symbol
+     * @return An std::pair with pair::first set to the length of the longest matching key and
+     *         pair::second to constant pointer to its value, pair::second is 0 if no key matches
+     */
+    std::pair<std::size_t, const V *> longestPrefixOf(const T *key) const {
+        return mRoot.longestPrefixOf(key);
+    }
+
+    /*!
+     * Finds the longest key in the Trie which is a prefix of the given key, walking the key only once
+     * @param key Key to be searched for, need not be terminated by 'end' symbol
+     * @param length Number of symbols in the key, the key should not contain the 'end' symbol
+     * @return An std::pair with pair::first set to the length of the longest matching key and
+     *         pair::second to pointer to its value, pair::second is 0 if no key matches
+     */
+    std::pair<std::size_t, V *> longestPrefixOf(const T *key, std::size_t length) {
+        return mRoot.longestPrefixOf(key, length);
+    }
+
+    /*!
+     * Finds the longest key in the Trie which is a prefix of the given key, walking the key only once
+     * @param key Key to be searched for, need not be terminated by 'end' symbol
+     * @param length Number of symbols in the key, the key should not contain the 'end' symbol
+     * @return An std::pair with pair::first set to the length of the longest matching key and
+     *         pair::second to constant pointer to its value, pair::second is 0 if no key matches
+     */
+    std::pair<std::size_t, const V *> longestPrefixOf(const T *key, std::size_t length) const {
+        return mRoot.longestPrefixOf(key, length);
+    }
+
+#ifdef RTV_HAS_STRING_VIEW
+    /*!
+     * Finds the longest key in the Trie which is a prefix of the given key, walking the key only once
+     * @param key Key to be searched for, should not contain the 'end' symbol
+     * @return An std::pair with pair::first set to the length of the longest matching key and
+     *         pair::second to pointer to its value, pair::second is 0 if no key matches
+     */
+    std::pair<std::size_t, V *> longestPrefixOf(std::basic_string_view<T> key) {
+        return mRoot.longestPrefixOf(key.data(), key.size());
+    }
+
+    /*!
+     * Finds the longest key in the Trie which is a prefix of the given key, walking the key only once
+     * @param key Key to be searched for, should not contain the 'end' symbol
+     * @return An std::pair with pair::first set to the length of the longest matching key and
+     *         pair::second to constant pointer to its value, pair::second is 0 if no key matches
+     */
+    std::pair<std::size_t, const V *> longestPrefixOf(std::basic_string_view<T> key) const {
+        return mRoot.longestPrefixOf(key.data(), key.size());
+    }
+#endif
+
+    /*!
+     * Finds all the keys in the Trie which are prefixes of the given key, walking the key only once.
+     * callback(length, value) is called for each matching key, shortest first,
+     * where length is the number of symbols in the matching key and value is reference to its value
+     * @param key Key to be searched for, should be terminated by 'end' symbol
+     * @param callback Function or functor to be called for each matching key
+     * @return The callback, after it has been called for all the matching keys
+     */
+    template <typename Callback>
+    Callback prefixesOf(const T *key, Callback callback) {
+        return mRoot.prefixesOf(key, Node<T, V, Cmp, Items>::npos, callback);
+    }
+
+    /*!
+     * Finds all the keys in the Trie which are prefixes of the given key, walking the key only once.
+     * callback(length, value) is called for each matching key, shortest first,
+     * where length is the number of symbols in the matching key and value is constant reference to its value
+     * @param key Key to be searched for, should be terminated by 'end' symbol
+     * @param callback Function or functor to be called for each matching key
+     * @return The callback, after it has been called for all the matching keys
+     */
+    template <typename Callback>
+    Callback prefixesOf(const T *key, Callback callback) const {
+        return mRoot.prefixesOf(key, Node<T, V, Cmp, Items>::npos, callback);
+    }
+
+    /*!
+     * Finds all the keys in the Trie which are prefixes of the given key, see Trie::prefixesOf
+     * @param key Key to be searched for, need not be terminated by 'end' symbol
+     * @param length Number of symbols in the key, the key should not contain the 'end' symbol
+     * @param callback Function or functor to be called for each matching key
+     * @return The callback, after it has been called for all the matching keys
+     */
+    template <typename Callback>
+    Callback prefixesOf(const T *key, std::size_t length, Callback callback) {
+        return mRoot.prefixesOf(key, length, callback);
+    }
+
+    /*!
+     * Finds all the keys in the Trie which are prefixes of the given key, see Trie::prefixesOf
+     * @param key Key to be searched for, need not be terminated by 'end' symbol
+     * @param length Number of symbols in the key, the key should not contain the 'end' symbol
+     * @param callback Function or functor to be called for each matching key
+     * @return The callback, after it has been called for all the matching keys
+     */
+    template <typename Callback>
+    Callback prefixesOf(const T *key, std::size_t length, Callback callback) const {
+        return mRoot.prefixesOf(key, length, callback);
+    }
+
+#ifdef RTV_HAS_STRING_VIEW
+    /*!
+     * Finds all the keys in the Trie which are prefixes of the given key, see Trie::prefixesOf
+     * @param key Key to be searched for, should not contain the 'end' symbol
+     * @param callback Function or functor to be called for each matching key
+     * @return The callback, after it has been called for all the matching keys
+     */
+    template <typename Callback>
+    Callback prefixesOf(std::basic_string_view<T> key, Callback callback) {
+        return mRoot.prefixesOf(key.data(), key.size(), callback);
+    }
+
+    /*!
+     * Finds all the keys in the Trie which are prefixes of the given key, see Trie::prefixesOf
+     * @param key Key to be searched for, should not contain the 'end' symbol
+     * @param callback Function or functor to be called for each matching key
+     * @return The callback, after it has been called for all the matching keys
+     */
+    template <typename Callback>
+    Callback prefixesOf(std::basic_string_view<T> key, Callback callback) const {
+        return mRoot.prefixesOf(key.data(), key.size(), callback);
+    }
+#endif
+
+    /*!
+     * Retrieves the values for a batch of keys.
+     * The keys are looked up in lockstep, prefetching the next node of every key in flight,
+     * which is faster than calling Trie::get for each key when the Trie does not fit in the cache
+     * @param keys Keys to be searched for, should be terminated by 'end' symbol unless lengths is given
+     * @param count Number of keys
+     * @param values Receives pointer to the value for each key, 0 if the key is not present
+     * @param lengths Number of symbols in each key, 0 if the keys are terminated by 'end' symbol
+     */
+    void getMany(const T * const *keys, std::size_t count, V **values, const std::size_t *lengths = 0) {
+        mRoot.getMany(keys, count, values, lengths);
+    }
+
+    /*!
+     * Retrieves the values for a batch of keys.
+     * The keys are looked up in lockstep, prefetching the next node of every key in flight,
+     * which is faster than calling Trie::get for each key when the Trie does not fit in the cache
+     * @param keys Keys to be searched for, should be terminated by 'end' symbol unless lengths is given
+     * @param count Number of keys
+     * @param values Receives constant pointer to the value for each key, 0 if the key is not present
+     * @param lengths Number of symbols in each key, 0 if the keys are terminated by 'end' symbol
+     */
+    void getMany(const T * const *keys, std::size_t count, const V **values, const std::size_t *lengths = 0) const {
+        mRoot.getMany(keys, count, values, lengths);
+    }
+
+    /*!
+     * Searches the Trie for a batch of keys, see Trie::getMany
+     * @param keys Keys to be searched for, should be terminated by 'end' symbol unless lengths is given
+     * @param count Number of keys
+     * @param results Receives Iterator to the element for each key, Trie::end if the key is not present
+     * @param lengths Number of symbols in each key, 0 if the keys are terminated by 'end' symbol
+     */
+    void findMany(const T * const *keys, std::size_t count, Iterator *results, const std::size_t *lengths = 0) {
+        mRoot.findMany(keys, count, results, lengths);
+    }
+
+    /*!
+     * Searches the Trie for a batch of keys, see Trie::getMany
+     * @param keys Keys to be searched for, should be terminated by 'end' symbol unless lengths is given
+     * @param count Number of keys
+     * @param results Receives ConstIterator to the element for each key, Trie::end if the key is not present
+     * @param lengths Number of symbols in each key, 0 if the keys are terminated by 'end' symbol
+     */
+    void findMany(const T * const *keys, std::size_t count, ConstIterator *results,
+                  const std::size_t *lengths = 0) const {
+        mRoot.findMany(keys, count, results, lengths);
+    }
+
+    /*!
+     * Returns an constant iterator referring to the first element in the Trie
+     * @return An constant iterator to the first element in the Trie
+     */
+    ConstIterator begin() const {
+        return mRoot.begin();
+    }
+
+    /*!
+     * Returns an constant iterator referring to the past-the-end element in the Trie
+     * @return An constant iterator to the element past the end of the Trie
+     */
+    ConstIterator end() const {
+        return mRoot.end();
+    }
+
+private:
+    Trie(Trie const &);
+    Trie &operator=(Trie const &);
+
+    // The root to add keys to, a Trie moved from gets a new allocator and a root using it here
+    Node<T, V, Cmp, Items> &root() {
+        if (!mAllocator.get()) {
+            Node<T, V, Cmp, Items> root(mRoot.endSymbol(), 0, mAllocator.create(), mRoot.compressed());
+            mRoot.swap(root);
+        }
+        return mRoot;
+    }
+
+private:
+    // declared before the root, so that it is destroyed after the nodes
+    AllocatorOwner<Allocator> mAllocator;
+    Node<T, V, Cmp, Items> mRoot;
+};
+
+/*!
+ * Exchanges the elements of the two Tries in constant time, see Trie::swap
+ */
+template < typename T,
+typename V,
+typename Cmp,
+typename Items > void swap(Trie<T, V, Cmp, Items> &t1, Trie<T, V, Cmp, Items> &t2)
+{
+    t1.swap(t2);
+}
+
+}
+
+#endif
@@ -13,11 +13,14 @@
 #define TRIETEST_H
 
 #include <iostream>
+#include <map>
+#include <string>
 #include <vector>
 #include <algorithm>
 #include <cctype>
 #include <cstdlib>
 #include <ctime>
+#include <stdexcept>
 
 #include "testsuite.h"
 
@@ -39,6 +42,296 @@ public:
     }
 };
 
+// key to index converter
+// case insensitive and includes alphabets, space and end symbol
+class AlphaToIndex
+{
+public:
+    unsigned int operator()(const char & c) const {
+        unsigned int index = 27;
+        if (c == ' ') {
+            index = 26;
+        } else if (c >= 'A' && c <= 'Z') {
+            index = c - 'A';
+        } else if (c >= 'a' && c <= 'z') {
+            index = c - 'a';
+        }
+        return index;
+    }
+};
+
+// Heap allocator counting the blocks and the bytes it has given out, those not yet taken back are live
+class CountingAllocator
+{
+public:
+    void *allocate(std::size_t size) {
+        ++allocations();
+        ++live();
+        bytes() += size;
+        return ::operator new(size);
+    }
+
+    void deallocate(void *p, std::size_t size) {
+        --live();
+        bytes() -= size;
+        ::operator delete(p);
+    }
+
+    void release() {}
+
+    CountingAllocator *fork() {
+        return this;
+    }
+
+    void join(CountingAllocator *) {}
+
+    // the counts are kept in functions so that every test which includes this header shares them
+    static std::size_t &allocations() {
+        static std::size_t count = 0;
+        return count;
+    }
+
+    static std::size_t &live() {
+        static std::size_t count = 0;
+        return count;
+    }
+
+    static std::size_t &bytes() {
+        static std::size_t count = 0;
+        return count;
+    }
+};
+
+// Value whose copy throws when armed and the value copied is negative
+class ThrowingValue
+{
+public:
+    explicit ThrowingValue(int value)
+            : mValue(value) {}
+
+    ThrowingValue(ThrowingValue const &oth)
+            : mValue(oth.mValue) {
+        if (armed() && mValue < 0) {
+            throw std::runtime_error("negative value");
+        }
+    }
+
+    static bool &armed() {
+        static bool isArmed = false;
+        return isArmed;
+    }
+
+    int mValue;
+};
+
+// Records the lengths of the keys passed to the Trie::prefixesOf callback
+class PrefixLengths
+{
+public:
+    template <typename V>
+    void operator()(std::size_t length, V &) {
+        mLengths.push_back(length);
+    }
+
+    std::vector<std::size_t> mLengths;
+};
+
+// Checks a read only Trie, rtv::MappedTrie, rtv::DoubleArrayTrie or rtv::LoudsTrie, against the keys it was made of
+class ReadOnlyTrieTestCases : public rtv::RTest
+{
+protected:
+    typedef std::map<std::string, int> Expected;
+
+    // Keys made of a few parts, so that many of them are prefixes of others
+    template <typename TrieType>
+    static void fill(TrieType &aTrie, Expected &expected, unsigned int seed) {
+        const char *parts[] = {"a", "ab", "abc", "b", "ba", "karma", "dharma", ""};
+
+        std::srand(seed);
+        for (int round = 0; round < 2000; ++round) {
+            std::string key;
+            int depth = std::rand() % 4;
+            for (int i = 0; i < depth; ++i) {
+                key += parts[std::rand() % 8];
+            }
+            aTrie.insert(key.c_str(), round);
+            expected.insert(std::make_pair(key, round));
+        }
+    }
+
+    template <typename ReadOnly>
+    void checkContents(ReadOnly const &trie, Expected const &expected) {
+        EXPECT_TRUE(trie.size() == expected.size());
+        EXPECT_TRUE(trie.empty() == expected.empty());
+
+        Expected::const_iterator eiter = expected.begin();
+        for (typename ReadOnly::ConstIterator iter = trie.begin(); iter != trie.end(); ++iter, ++eiter) {
+            EXPECT_TRUE(eiter != expected.end() && eiter->first.compare(iter->first) == 0);
+            EXPECT_TRUE(eiter != expected.end() && *iter->second == eiter->second);
+        }
+        EXPECT_TRUE(eiter == expected.end());
+
+        for (Expected::const_iterator iter = expected.begin(); iter != expected.end(); ++iter) {
+            EXPECT_TRUE(trie.get(iter->first.c_str()) && *trie.get(iter->first.c_str()) == iter->second);
+            EXPECT_TRUE(trie.hasKey(iter->first.c_str(), iter->first.length()));
+            EXPECT_TRUE(!trie.hasKey((iter->first + "z").c_str()));
+
+            std::string prefix = iter->first.substr(0, iter->first.length() / 2);
+            Expected::const_iterator piter = expected.lower_bound(prefix);
+            typename ReadOnly::ConstIterator siter = trie.startsWith(prefix.c_str(), prefix.length());
+            for (; siter != trie.end(); ++siter, ++piter) {
+                EXPECT_TRUE(piter != expected.end() && piter->first.compare(siter->first) == 0);
+            }
+            EXPECT_TRUE(piter == expected.end() || piter->first.compare(0, prefix.length(), prefix) != 0);
+
+            // the keys which are prefixes of the key followed by other symbols
+            std::string longer = iter->first + "zq";
+            PrefixLengths lengths = trie.prefixesOf(longer.c_str(), PrefixLengths());
+            std::vector<std::size_t> expectedLengths;
+            for (std::size_t length = 0; length <= longer.length(); ++length) {
+                if (expected.find(longer.substr(0, length)) != expected.end()) {
+                    expectedLengths.push_back(length);
+                }
+            }
+            EXPECT_TRUE(lengths.mLengths == expectedLengths);
+            std::pair<std::size_t, const int *> longest = trie.longestPrefixOf(longer.c_str(), longer.length());
+            EXPECT_TRUE(longest.first == iter->first.length() && longest.second && *longest.second == iter->second);
+        }
+        EXPECT_TRUE(trie.startsWith("zz") == trie.end());
+    }
+};
+
+// Keys of two symbols, the first symbols spread over the root and each of them followed by a different
+// number of second symbols, so that the nodes go through all the layouts of their Items policy
+template <typename Symbol>
+class TwoSymbolKeys
+{
+public:
+    TwoSymbolKeys(unsigned int firstCount, long firstStep, unsigned int secondSpread, long secondBase, long secondStep)
+            : mFirstCount(firstCount),
+              mFirstStep(firstStep),
+              mSecondSpread(secondSpread),
+              mSecondBase(secondBase),
+              mSecondStep(secondStep),
+              mFirst(1),
+              mSecond(1) {}
+
+    bool operator()(std::vector<Symbol> &key) {
+        if (mSecond > mFirst % mSecondSpread + 1) {
+            ++mFirst;
+            mSecond = 1;
+        }
+        if (mFirst > mFirstCount) {
+            return false;
+        }
+        key.clear();
+        key.push_back((Symbol)(mFirst * mFirstStep));
+        key.push_back((Symbol)(mSecondBase + mSecond * mSecondStep));
+        ++mSecond;
+        return true;
+    }
+
+private:
+    unsigned int mFirstCount;
+    long mFirstStep;
+    unsigned int mSecondSpread;
+    long mSecondBase;
+    long mSecondStep;
+    unsigned int mFirst;
+    unsigned int mSecond;
+};
+
+// Checks a Trie against a std::map of the same keys, the oracle, walking it forwards and backwards and
+// looking up every key, so that the Items policies which lay out their nodes differently are held to the same
+// expectations
+template <typename Symbol>
+class TrieLayoutTestCases : public rtv::RTest
+{
+protected:
+    typedef std::map<std::vector<Symbol>, int> Expected;
+
+public:
+    // the oracle maps a std::string or a std::vector of the symbols to the values
+    template <typename TrieType, typename Oracle>
+    void checkContents(TrieType const &aTrie, Oracle const &expected) {
+        typedef typename Oracle::key_type Key;
+        EXPECT_TRUE(aTrie.size() == expected.size());
+
+        typename Oracle::const_iterator eiter = expected.begin();
+        typename TrieType::ConstIterator iter = aTrie.begin();
+        for (; iter != aTrie.end(); ++iter, ++eiter) {
+            EXPECT_TRUE(eiter != expected.end() && keyOf<Key>(aTrie, iter->first) == eiter->first);
+            EXPECT_TRUE(eiter != expected.end() && *iter->second == eiter->second);
+        }
+        EXPECT_TRUE(eiter == expected.end());
+
+        // walking back from the end visits the keys in the reverse order
+        typename Oracle::const_reverse_iterator riter = expected.rbegin();
+        iter = aTrie.end();
+        while (iter != aTrie.begin()) {
+            --iter;
+            EXPECT_TRUE(riter != expected.rend() && keyOf<Key>(aTrie, iter->first) == riter->first);
+            ++riter;
+        }
+        EXPECT_TRUE(riter == expected.rend());
+
+        for (eiter = expected.begin(); eiter != expected.end(); ++eiter) {
+            Key key = eiter->first;
+            key.push_back(aTrie.endSymbol());
+            EXPECT_TRUE(aTrie.get(&key[0]) && *aTrie.get(&key[0]) == eiter->second);
+        }
+    }
+
+    // Inserts the keys made by generate, which returns false after the last one, then erases them in a random
+    // order. The Trie is checked against the oracle every checkEvery keys on the way up and on the way down
+    template <typename TrieType, typename KeyGenerator>
+    void growAndShrink(TrieType &aTrie, KeyGenerator generate, unsigned int seed, std::size_t checkEvery) {
+        Expected expected;
+        std::vector<Symbol> key;
+
+        std::srand(seed);
+        for (int value = 0; generate(key); ++value) {
+            bool inserted = expected.insert(std::make_pair(key, value)).second;
+            EXPECT_TRUE(aTrie.insert(&key[0], key.size(), value).second == inserted);
+            if ((value + 1) % checkEvery == 0) {
+                checkContents(aTrie, expected);
+            }
+        }
+        checkContents(aTrie, expected);
+
+        while (!expected.empty()) {
+            typename Expected::iterator iter = expected.begin();
+            std::advance(iter, std::rand() % expected.size());
+            key = iter->first;
+            EXPECT_TRUE(aTrie.get(&key[0], key.size()) && *aTrie.get(&key[0], key.size()) == iter->second);
+            EXPECT_TRUE(aTrie.erase(&key[0], key.size()));
+            EXPECT_FALSE(aTrie.hasKey(&key[0], key.size()));
+            expected.erase(iter);
+
+            // the key next to the one erased is there only when the oracle has it
+            ++key.back();
+            if (key.back() != aTrie.endSymbol()) {
+                EXPECT_TRUE(aTrie.hasKey(&key[0], key.size()) == (expected.count(key) == 1));
+            }
+            if (expected.size() % checkEvery == 0) {
+                checkContents(aTrie, expected);
+            }
+        }
+        EXPECT_TRUE(aTrie.empty());
+        EXPECT_TRUE(aTrie.begin() == aTrie.end());
+    }
+
+private:
+    template <typename Key, typename TrieType, typename T>
+    static Key keyOf(TrieType const &aTrie, const T *symbols) {
+        std::size_t length = 0;
+        while (symbols[length] != aTrie.endSymbol()) {
+            ++length;
+        }
+        return Key(symbols, symbols + length);
+    }
+};
+
 template <typename D>
 class TrieTestCases: public rtv::RTest
 {
@@ -711,6 +1004,309 @@ public:
             bool res = aTrie[key.c_str()].compare(*aTrie.get(key.c_str())) == 0;
             EXPECT_TRUE(res);
         }
+
+        //Test length delimited key functionality
+        aTrie.clear();
+        for (SampleValuesIter iter = sv.begin();
+                iter != sv.end(); ++iter) {
+            // keys are followed by other symbols instead of the 'end' symbol
+            std::string buffer = iter->first + iter->first;
+            EXPECT_TRUE(aTrie.insert(buffer.c_str(), iter->first.length(), iter->second).second);
+            EXPECT_TRUE(aTrie.insert(buffer.c_str(), iter->first.length(), iter->second).second == false);
+        }
+        EXPECT_TRUE(aTrie.size() == sv.size());
+
+        for (SampleValuesIter iter = sv.begin();
+                iter != sv.end(); ++iter) {
+            std::string buffer = iter->first + iter->first;
+            std::size_t length = iter->first.length();
+            EXPECT_TRUE(aTrie.hasKey(buffer.c_str(), length));
+            EXPECT_TRUE(aTrie.get(buffer.c_str(), length) != 0 &&
+                        aTrie.get(buffer.c_str(), length)->compare(iter->second) == 0);
+            TrieIterator titer = aTrie.find(buffer.c_str(), length);
+            EXPECT_TRUE(titer != aTrie.end() && keyToString(endSymbol, titer->first) == iter->first + endSymbol);
+            EXPECT_TRUE(aTrie.startsWith(buffer.c_str(), length) != aTrie.end());
+            EXPECT_TRUE(((const TheTrie &)aTrie).startsWith(buffer.c_str(), length) != ((const TheTrie &)aTrie).end());
+            if (!isPresent(buffer, sv)) {
+                EXPECT_FALSE(aTrie.hasKey(buffer.c_str(), buffer.length()));
+            }
+            if (length > 1 && !isPresent(iter->first.substr(0, length - 1), sv)) {
+                EXPECT_FALSE(aTrie.hasKey(buffer.c_str(), length - 1));
+                EXPECT_TRUE(aTrie.find(buffer.c_str(), length - 1) == aTrie.end());
+            }
+        }
+
+        for (NegativeSampleValuesIter iter = mNegativeSampleValues.begin();
+                iter != mNegativeSampleValues.end(); ++iter) {
+            EXPECT_FALSE(aTrie.hasKey(iter->c_str(), iter->length()));
+            EXPECT_FALSE(aTrie.erase(iter->c_str(), iter->length()));
+        }
+
+#ifdef RTV_HAS_STRING_VIEW
+        for (SampleValuesIter iter = sv.begin();
+                iter != sv.end(); ++iter) {
+            std::string_view key(iter->first);
+            EXPECT_TRUE(aTrie.hasKey(key));
+            EXPECT_TRUE(aTrie.get(key) == aTrie.get(key.data(), key.size()));
+            EXPECT_TRUE(aTrie.find(key) == aTrie.find(key.data(), key.size()));
+            EXPECT_TRUE(aTrie.startsWith(key.substr(0, 1)) != aTrie.end());
+            EXPECT_TRUE(aTrie[key].compare(iter->second) == 0);
+            EXPECT_TRUE(aTrie.insert(key, iter->second).second == false);
+        }
+#endif
+
+        trieSize = aTrie.size();
+        for (SampleValuesIter iter = sv.begin();
+                iter != sv.end(); ++iter) {
+            std::string buffer = iter->first + iter->first;
+            EXPECT_TRUE(aTrie.erase(buffer.c_str(), iter->first.length()));
+            EXPECT_FALSE(aTrie.hasKey(buffer.c_str(), iter->first.length()));
+            EXPECT_TRUE(--trieSize == aTrie.size());
+        }
+        EXPECT_TRUE(aTrie.empty());
+
+        //Test Trie::insertFast functionality
+        aTrie.clear();
+        for (SampleValuesIter iter = sv.begin();
+                iter != sv.end(); ++iter) {
+            std::string key = iter->first + endSymbol;
+            std::pair<std::string *, bool> res = aTrie.insertFast(key.c_str(), iter->second);
+            EXPECT_TRUE(res.second);
+            EXPECT_TRUE(res.first == aTrie.get(key.c_str()));
+            EXPECT_TRUE(res.first && res.first->compare(iter->second) == 0);
+            res = aTrie.insertFast(iter->first.c_str(), iter->first.length(), std::string());
+            EXPECT_FALSE(res.second);
+            EXPECT_TRUE(res.first == aTrie.get(key.c_str()));
+        }
+        EXPECT_TRUE(aTrie.size() == sv.size());
+
+        //Test Trie::insertOrAssign functionality
+        for (SampleValuesIter iter = sv.begin();
+                iter != sv.end(); ++iter) {
+            std::string key = iter->first + endSymbol;
+            EXPECT_FALSE(aTrie.insertOrAssign(key.c_str(), iter->first).second);
+            EXPECT_TRUE(aTrie.get(key.c_str())->compare(iter->first) == 0);
+        }
+        EXPECT_TRUE(aTrie.size() == sv.size());
+        aTrie.clear();
+        for (SampleValuesIter iter = sv.begin();
+                iter != sv.end(); ++iter) {
+            std::pair<TrieIterator, bool> res = aTrie.insertOrAssign(iter->first.c_str(), iter->first.length(),
+                                                                     iter->second);
+            EXPECT_TRUE(res.second);
+            EXPECT_TRUE(res.first != aTrie.end() && res.first->second->compare(iter->second) == 0);
+        }
+        aTrie.clear();
+
+        //Test Trie::swap functionality
+        TrieTestCases::populateTrieWithSampleValues(aTrie, sv);
+        bool compressed = aTrie.pathCompression();
+        TheTrie other(endSymbol == '$' ? '\0' : '$');
+        other.swap(aTrie);
+        EXPECT_TRUE(aTrie.empty());
+        EXPECT_TRUE(aTrie.endSymbol() != endSymbol);
+        EXPECT_TRUE(other.endSymbol() == endSymbol);
+        EXPECT_TRUE(other.pathCompression() == compressed);
+        EXPECT_TRUE(other.size() == sv.size());
+        for (SampleValuesIter iter = sv.begin();
+                iter != sv.end(); ++iter) {
+            std::string key = iter->first + endSymbol;
+            EXPECT_TRUE(other.get(key.c_str()) && other.get(key.c_str())->compare(iter->second) == 0);
+            EXPECT_TRUE(other.erase(key.c_str()));
+            EXPECT_TRUE(other.insert(key.c_str(), iter->second).second);
+        }
+        std::size_t count = 0;
+        for (TrieIterator iter = other.begin(); iter != other.end(); ++iter) {
+            ++count;
+        }
+        EXPECT_TRUE(count == sv.size());
+        swap(aTrie, other);
+        EXPECT_TRUE(other.empty());
+        EXPECT_TRUE(aTrie.endSymbol() == endSymbol);
+        EXPECT_TRUE(aTrie.size() == sv.size());
+
+#ifdef RTV_HAS_CXX11
+        //Test Trie move functionality
+        static_assert(std::is_nothrow_move_constructible<TheTrie>::value &&
+                      std::is_nothrow_move_assignable<TheTrie>::value, "moving a Trie should not throw");
+        TheTrie moved(std::move(aTrie));
+        EXPECT_TRUE(aTrie.empty());
+        EXPECT_TRUE(moved.size() == sv.size());
+        EXPECT_TRUE(moved.pathCompression() == compressed);
+        for (SampleValuesIter iter = sv.begin();
+                iter != sv.end(); ++iter) {
+            std::string key = iter->first + endSymbol;
+            EXPECT_TRUE(moved.hasKey(key.c_str()));
+        }
+        aTrie = std::move(moved);
+        EXPECT_TRUE(moved.empty());
+        EXPECT_TRUE(aTrie.size() == sv.size());
+        EXPECT_TRUE(aTrie.endSymbol() == endSymbol);
+        TrieTestCases::populateTrieWithSampleValues(moved, sv);
+        EXPECT_TRUE(moved.size() == sv.size());
+#endif
+        aTrie.clear();
+
+        //Test Trie::longestPrefixOf and Trie::prefixesOf functionality
+        TrieTestCases::populateTrieWithSampleValues(aTrie, sv);
+        std::vector<std::string> inputs;
+        for (SampleValuesIter iter = sv.begin();
+                iter != sv.end(); ++iter) {
+            inputs.push_back(iter->first);
+            inputs.push_back(iter->first + "sXyz");
+            inputs.push_back(iter->first.substr(0, iter->first.length() / 2));
+        }
+        inputs.insert(inputs.end(), mNegativeSampleValues.begin(), mNegativeSampleValues.end());
+        for (std::size_t i = 0; i < inputs.size(); ++i) {
+            // longest truncation of the input present in the Trie
+            std::size_t expected = 0;
+            const std::string *expectedValue = 0;
+            std::vector<std::size_t> expectedLengths;
+            for (std::size_t n = 0; n <= inputs[i].length(); ++n) {
+                std::string truncated = inputs[i].substr(0, n) + endSymbol;
+                if (aTrie.hasKey(truncated.c_str())) {
+                    expected = n;
+                    expectedValue = aTrie.get(truncated.c_str());
+                    expectedLengths.push_back(n);
+                }
+            }
+            std::string key = inputs[i] + endSymbol;
+            EXPECT_TRUE(aTrie.prefixesOf(key.c_str(), PrefixLengths()).mLengths == expectedLengths);
+            EXPECT_TRUE(((const TheTrie &)aTrie).prefixesOf(inputs[i].c_str(), inputs[i].length(),
+                                                             PrefixLengths()).mLengths == expectedLengths);
+            std::pair<std::size_t, std::string *> match = aTrie.longestPrefixOf(key.c_str());
+            EXPECT_TRUE(match.second == expectedValue);
+            EXPECT_TRUE(!expectedValue || match.first == expected);
+            std::pair<std::size_t, const std::string *> constMatch =
+                ((const TheTrie &)aTrie).longestPrefixOf(inputs[i].c_str(), inputs[i].length());
+            EXPECT_TRUE(constMatch.second == expectedValue);
+            EXPECT_TRUE(!expectedValue || constMatch.first == expected);
+        }
+        aTrie.clear();
+
+        //Test Trie::getMany and Trie::findMany functionality
+        TrieTestCases::populateTrieWithSampleValues(aTrie, sv);
+        std::vector<std::string> batch;
+        for (SampleValuesIter iter = sv.begin();
+                iter != sv.end(); ++iter) {
+            batch.push_back(iter->first + endSymbol);
+        }
+        for (NegativeSampleValuesIter iter = mNegativeSampleValues.begin();
+                iter != mNegativeSampleValues.end(); ++iter) {
+            batch.push_back(*iter + endSymbol);
+        }
+        std::vector<const char *> batchKeys;
+        std::vector<std::size_t> batchLengths;
+        for (std::size_t i = 0; i < batch.size(); ++i) {
+            batchKeys.push_back(batch[i].c_str());
+            batchLengths.push_back(batch[i].length() - 1);
+        }
+
+        std::vector<std::string *> values(batch.size());
+        std::vector<const std::string *> constValues(batch.size());
+        std::vector<TrieIterator> results(batch.size(), aTrie.end());
+        std::vector<TrieConstIterator> constResults(batch.size(), ((const TheTrie &)aTrie).end());
+        aTrie.getMany(&batchKeys[0], batch.size(), &values[0]);
+        ((const TheTrie &)aTrie).getMany(&batchKeys[0], batch.size(), &constValues[0], &batchLengths[0]);
+        aTrie.findMany(&batchKeys[0], batch.size(), &results[0], &batchLengths[0]);
+        ((const TheTrie &)aTrie).findMany(&batchKeys[0], batch.size(), &constResults[0]);
+        for (std::size_t i = 0; i < batch.size(); ++i) {
+            EXPECT_TRUE(values[i] == aTrie.get(batchKeys[i]));
+            EXPECT_TRUE(constValues[i] == aTrie.get(batchKeys[i]));
+            EXPECT_TRUE(results[i] == aTrie.find(batchKeys[i]));
+            EXPECT_TRUE(constResults[i] == ((const TheTrie &)aTrie).find(batchKeys[i]));
+        }
+        aTrie.clear();
+
+        //Test Trie::bulkLoad functionality
+        SampleValues sorted(sv);
+        std::sort(sorted.begin(), sorted.end());
+        std::size_t inserted = aTrie.bulkLoad(sorted.begin(), sorted.end());
+        TheTrie expected(endSymbol, compressed);
+        TrieTestCases::populateTrieWithSampleValues(expected, sv);
+        EXPECT_TRUE(inserted == expected.size());
+        EXPECT_TRUE(aTrie.size() == expected.size());
+        for (TrieIterator iter = expected.begin(); iter != expected.end(); ++iter) {
+            EXPECT_TRUE(aTrie.get(iter->first) && aTrie.get(iter->first)->compare(*iter->second) == 0);
+        }
+        count = 0;
+        for (TrieIterator iter = aTrie.begin(); iter != aTrie.end(); ++iter) {
+            ++count;
+        }
+        EXPECT_TRUE(count == expected.size());
+        // the nodes built at once keep their items in the same order as the nodes built by insert
+        TrieIterator loadedIter = aTrie.begin();
+        for (TrieIterator iter = expected.begin(); iter != expected.end(); ++iter, ++loadedIter) {
+            EXPECT_TRUE(loadedIter != aTrie.end() &&
+                        keyToString(endSymbol, loadedIter->first) == keyToString(endSymbol, iter->first));
+        }
+        EXPECT_TRUE(aTrie.bulkLoad(sorted.begin(), sorted.end()) == 0);
+        aTrie.clear();
+        // a sorted run followed by keys out of order
+        SampleValues rotated(sorted.begin() + sorted.size() / 2, sorted.end());
+        rotated.insert(rotated.end(), sorted.begin(), sorted.begin() + sorted.size() / 2);
+        EXPECT_TRUE(aTrie.bulkLoad(rotated.begin(), rotated.end()) == expected.size());
+        for (TrieIterator iter = expected.begin(); iter != expected.end(); ++iter) {
+            EXPECT_TRUE(aTrie.get(iter->first) && aTrie.get(iter->first)->compare(*iter->second) == 0);
+        }
+        aTrie.clear();
+        // keys terminated by the end symbol, unsorted and partly present
+        std::vector< std::pair<const char *, std::string> > terminated;
+        for (std::size_t i = 0; i < sv.size(); ++i) {
+            terminated.push_back(std::make_pair(batch[i].c_str(), batch[i]));
+        }
+        EXPECT_TRUE(aTrie.insert(batch[0].c_str(), std::string()).second);
+        aTrie.bulkLoad(terminated.rbegin(), terminated.rend());
+        for (std::size_t i = 0; i < sv.size(); ++i) {
+            EXPECT_TRUE(aTrie.hasKey(batch[i].c_str()));
+        }
+        EXPECT_TRUE(aTrie.get(batch[0].c_str())->empty());
+        aTrie.clear();
+
+#ifdef RTV_HAS_CXX11
+        //Test Trie::parallelLoad functionality
+        sorted.push_back(std::make_pair(std::string(), std::string("empty")));
+        for (std::size_t prefixLength = 0; prefixLength < 4; ++prefixLength) {
+            std::size_t loaded = aTrie.parallelLoad(sorted.begin(), sorted.end(), 4, prefixLength);
+            EXPECT_TRUE(loaded == expected.size() + 1);
+            EXPECT_TRUE(aTrie.size() == expected.size() + 1);
+            std::string empty(1, endSymbol);
+            EXPECT_TRUE(aTrie.get(empty.c_str()) && aTrie.get(empty.c_str())->compare("empty") == 0);
+            for (TrieIterator iter = expected.begin(); iter != expected.end(); ++iter) {
+                EXPECT_TRUE(aTrie.get(iter->first) && aTrie.get(iter->first)->compare(*iter->second) == 0);
+            }
+            count = 0;
+            for (TrieIterator iter = aTrie.begin(); iter != aTrie.end(); ++iter) {
+                ++count;
+            }
+            EXPECT_TRUE(count == aTrie.size());
+            // the loaded Trie can be modified with its own allocator
+            for (TrieIterator iter = expected.begin(); iter != expected.end(); ++iter) {
+                EXPECT_TRUE(aTrie.erase(iter->first));
+            }
+            EXPECT_TRUE(aTrie.size() == 1);
+            // grafted on to a Trie which is not empty, the keys present keep their values
+            std::size_t kept = 0;
+            for (std::size_t i = 0; i < sorted.size(); i += 2) {
+                std::string key = sorted[i].first + endSymbol;
+                kept += aTrie.insert(key.c_str(), std::string("kept")).second ? 1 : 0;
+            }
+            EXPECT_TRUE(aTrie.parallelLoad(sorted.begin(), sorted.end(), 4, prefixLength) == expected.size() - kept);
+            EXPECT_TRUE(aTrie.size() == expected.size() + 1);
+            count = 0;
+            std::size_t keptCount = 0;
+            for (TrieIterator iter = aTrie.begin(); iter != aTrie.end(); ++iter) {
+                ++count;
+                keptCount += iter->second->compare("kept") == 0 ? 1 : 0;
+            }
+            EXPECT_TRUE(count == aTrie.size() && keptCount == kept);
+            for (TrieIterator iter = expected.begin(); iter != expected.end(); ++iter) {
+                EXPECT_TRUE(aTrie.hasKey(iter->first));
+            }
+            EXPECT_TRUE(aTrie.parallelLoad(sorted.begin(), sorted.end()) == 0);
+            aTrie.clear();
+        }
+#endif
     }
 };
 
@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2012, Ranjith TV
+ * All rights reserved.
+ *
+ * Licensed under the BSD 3-Clause ("BSD New" or "BSD Simplified") license.
+ * You may obtain a copy of the License at
+ *
+ * http://www.opensource.org/licenses/BSD-3-Clause
+ *
+ */
+
+#include "mapped_trie.h"
+#include "trietest.h"
+
+#include <map>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstddef>
+
+using namespace rtv;
+
+namespace
+{
+
+class MappedTrieTestCases : public ReadOnlyTrieTestCases
+{
+protected:
+    typedef rtv::MappedTrie<char, int> TheMappedTrie;
+
+    static const char *path() {
+        return "trietest_mapped.bin";
+    }
+};
+
+TEST_F(MappedTrieTestCases, MappedTrieCase_SaveAndMap)
+{
+    rtv::Trie<char, int> aTrie('\0');
+    Expected expected;
+    fill(aTrie, expected, 11);
+
+    EXPECT_TRUE(aTrie.save(path()));
+    TheMappedTrie mapped;
+    EXPECT_TRUE(mapped.open(path()));
+    EXPECT_TRUE(mapped.isOpen());
+    EXPECT_TRUE(mapped.endSymbol() == '\0');
+    checkContents(mapped, expected);
+
+    // an iterator copied on the way keeps its own key
+    TheMappedTrie::ConstIterator iter = mapped.startsWith("ka");
+    TheMappedTrie::ConstIterator copy = iter++;
+    EXPECT_TRUE(std::string(copy->first) == "karma" && iter != copy);
+
+    mapped.close();
+    EXPECT_TRUE(!mapped.isOpen() && mapped.empty() && mapped.begin() == mapped.end());
+    EXPECT_TRUE(!mapped.get("karma"));
+    std::remove(path());
+}
+
+TEST_F(MappedTrieTestCases, MappedTrieCase_OtherItemsAndCompression)
+{
+    rtv::Trie<char, int, std::less<char>, rtv::VectorItems<char, int, std::less<char>, 256> > vectorTrie('\0');
+    Expected vectorExpected;
+    fill(vectorTrie, vectorExpected, 11);
+    EXPECT_TRUE(vectorTrie.save(path()));
+    TheMappedTrie mapped;
+    EXPECT_TRUE(mapped.open(path()));
+    checkContents(mapped, vectorExpected);
+
+    rtv::Trie<char, int> compressedTrie('\0', true);
+    Expected compressedExpected;
+    fill(compressedTrie, compressedExpected, 11);
+    compressedTrie.insert("dharmakarmadharma", -1);
+    compressedExpected["dharmakarmadharma"] = -1;
+    EXPECT_TRUE(compressedTrie.save(path()));
+    EXPECT_TRUE(mapped.open(path()));
+    checkContents(mapped, compressedExpected);
+    mapped.close();
+    std::remove(path());
+}
+
+TEST_F(MappedTrieTestCases, MappedTrieCase_EmptyAndInvalidFiles)
+{
+    rtv::Trie<char, int> aTrie('\0');
+    EXPECT_TRUE(aTrie.save(path()));
+    TheMappedTrie mapped;
+    EXPECT_TRUE(mapped.open(path()));
+    checkContents(mapped, Expected());
+
+    // an empty key is kept in the root
+    aTrie.insert("", 7);
+    EXPECT_TRUE(aTrie.save(path()));
+    EXPECT_TRUE(mapped.open(path()));
+    EXPECT_TRUE(mapped.get("") && *mapped.get("") == 7 && mapped.size() == 1);
+
+    // a Trie of other value type is not accepted
+    rtv::MappedTrie<char, double> other;
+    EXPECT_TRUE(!other.open(path()));
+
+    // nor a truncated file
+    std::FILE *file = std::fopen(path(), "wb");
+    EXPECT_TRUE(file && std::fwrite("rtvtrie", 8, 1, file) == 1);
+    std::fclose(file);
+    EXPECT_TRUE(!mapped.open(path()));
+    EXPECT_TRUE(!mapped.isOpen());
+    std::remove(path());
+
+    EXPECT_TRUE(!mapped.open(path()));
+}
+
+TEST_F(MappedTrieTestCases, MappedTrieCase_CorruptNodes)
+{
+    rtv::Trie<char, int> aTrie('\0');
+    aTrie.insert("karma", 1);
+    aTrie.insert("kar", 2);
+    aTrie.insert("dharma", 3);
+    EXPECT_TRUE(aTrie.save(path()));
+
+    std::vector<char> bytes;
+    std::FILE *file = std::fopen(path(), "rb");
+    for (int c = file ? std::fgetc(file) : EOF; c != EOF; c = std::fgetc(file)) {
+        bytes.push_back((char)c);
+    }
+    if (file) {
+        std::fclose(file);
+    }
+    TheMappedTrie mapped;
+    EXPECT_TRUE(mapped.open(path()));
+    mapped.close();
+
+    // each file keeps a valid header and has one field of a node or an edge pointing out of the file,
+    // or an edge leading back to its own node, open does not read them but the lookups skip them
+    const char *keys[] = {"karma", "kar", "dharma"};
+    rtv::TrieFileHeader header;
+    std::memcpy(&header, &bytes[0], sizeof(header));
+    std::size_t node = header.nodesOffset() + header.mRoot * sizeof(rtv::TrieFileHeader::Node);
+    std::size_t edge = header.targetsOffset();
+    unsigned int large = 0x7fffffff;
+    std::size_t offsets[] = {node, node + sizeof(unsigned int), node + 2 * sizeof(unsigned int), edge, edge};
+    unsigned int values[] = {large, large, header.mValueCount + 1, header.mNodeCount, 0};
+    for (int i = 0; i < 5; ++i) {
+        std::vector<char> corrupt(bytes);
+        unsigned int value = values[i];
+        if (i == 4) {
+            // the node of the first edge is the first node holding an edge
+            for (unsigned int n = 0; n < header.mNodeCount; ++n) {
+                rtv::TrieFileHeader::Node fileNode;
+                std::memcpy(&fileNode, &bytes[header.nodesOffset() + n * sizeof(fileNode)], sizeof(fileNode));
+                if (fileNode.mEdgeCount > 0 && fileNode.mFirstEdge == 0) {
+                    value = n;
+                    break;
+                }
+            }
+        }
+        std::memcpy(&corrupt[offsets[i]], &value, sizeof(value));
+        file = std::fopen(path(), "wb");
+        EXPECT_TRUE(file && std::fwrite(&corrupt[0], corrupt.size(), 1, file) == 1);
+        if (file) {
+            std::fclose(file);
+        }
+        EXPECT_TRUE(mapped.open(path()));
+        std::size_t count = 0;
+        for (TheMappedTrie::ConstIterator iter = mapped.begin(); iter != mapped.end(); ++iter) {
+            ++count;
+        }
+        EXPECT_TRUE(count <= 3);
+        for (int k = 0; k < 3; ++k) {
+            const int *value = mapped.get(keys[k]);
+            EXPECT_TRUE(!value || *value == k + 1);
+        }
+        mapped.close();
+    }
+
+    // counts whose sizes wrap around in unsigned int, with the value of the root past the real values,
+    // are rejected by open instead of being read out of the mapping
+    std::size_t counts[] = {offsetof(rtv::TrieFileHeader, mValueCount), offsetof(rtv::TrieFileHeader, mEdgeCount),
+                            offsetof(rtv::TrieFileHeader, mNodeCount)};
+    unsigned int wrapping[] = {0x40000000, 0x40000000, 0x20000000};
+    for (int i = 0; i < 3; ++i) {
+        std::vector<char> corrupt(bytes);
+        std::memcpy(&corrupt[counts[i]], &wrapping[i], sizeof(unsigned int));
+        unsigned int value = 0x3fffffff;
+        std::memcpy(&corrupt[node + 2 * sizeof(unsigned int)], &value, sizeof(value));
+        file = std::fopen(path(), "wb");
+        EXPECT_TRUE(file && std::fwrite(&corrupt[0], corrupt.size(), 1, file) == 1);
+        if (file) {
+            std::fclose(file);
+        }
+        EXPECT_TRUE(!mapped.open(path()));
+        EXPECT_TRUE(mapped.begin() == mapped.end());
+    }
+    std::remove(path());
+}
+
+}
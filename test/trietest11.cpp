@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2012, Ranjith TV
+ * All rights reserved.
+ *
+ * Licensed under the BSD 3-Clause ("BSD New" or "BSD Simplified") license.
+ * You may obtain a copy of the License at
+ *
+ * http://www.opensource.org/licenses/BSD-3-Clause
+ *
+ */
+
+#include "double_array_trie.h"
+#include "trietest.h"
+
+#include <map>
+#include <string>
+
+using namespace rtv;
+
+namespace
+{
+
+typedef ReadOnlyTrieTestCases DoubleArrayTrieTestCases;
+
+TEST_F(DoubleArrayTrieTestCases, DoubleArrayTrieCase_Freeze)
+{
+    rtv::Trie<char, int> aTrie('\0');
+    Expected expected;
+    fill(aTrie, expected, 13);
+
+    rtv::DoubleArrayTrie<char, int> frozen = rtv::freeze(aTrie);
+    EXPECT_TRUE(frozen.endSymbol() == '\0');
+    checkContents(frozen, expected);
+    EXPECT_TRUE(frozen.memoryUsage() > frozen.size() * sizeof(int));
+
+    // an iterator copied on the way keeps its own key
+    rtv::DoubleArrayTrie<char, int>::ConstIterator iter = frozen.startsWith("ka");
+    rtv::DoubleArrayTrie<char, int>::ConstIterator copy = iter++;
+    EXPECT_TRUE(std::string(copy->first) == "karma" && iter != copy);
+
+    // the frozen copy does not depend on the Trie
+    aTrie.clear();
+    checkContents(frozen, expected);
+}
+
+TEST_F(DoubleArrayTrieTestCases, DoubleArrayTrieCase_OtherItemsAndCompression)
+{
+    rtv::Trie<char, int, std::less<char>, rtv::VectorItems<char, int, std::less<char>, 256> > vectorTrie('\0');
+    Expected vectorExpected;
+    fill(vectorTrie, vectorExpected, 13);
+    checkContents(rtv::freeze(vectorTrie), vectorExpected);
+
+    rtv::Trie<char, int> compressedTrie('\0', true);
+    Expected compressedExpected;
+    fill(compressedTrie, compressedExpected, 13);
+    compressedTrie.insert("dharmakarmadharma", -1);
+    compressedExpected["dharmakarmadharma"] = -1;
+    checkContents(rtv::freeze(compressedTrie), compressedExpected);
+}
+
+TEST_F(DoubleArrayTrieTestCases, DoubleArrayTrieCase_SymbolsAndEmpty)
+{
+    rtv::Trie<char, int> emptyTrie('\0');
+    checkContents(rtv::freeze(emptyTrie), Expected());
+    rtv::DoubleArrayTrie<char, int> empty('\0');
+    checkContents(empty, Expected());
+
+    // symbols equal as per Cmp share their code
+    rtv::Trie<char, int, TrieCaseInsensitiveCompare> caseTrie('\0');
+    caseTrie.insert("Karma", 1);
+    caseTrie.insert("dharMA", 2);
+    caseTrie.insert("", 3);
+    rtv::DoubleArrayTrie<char, int, TrieCaseInsensitiveCompare> caseFrozen = rtv::freeze(caseTrie);
+    EXPECT_TRUE(caseFrozen.get("KARMA") && *caseFrozen.get("KARMA") == 1);
+    EXPECT_TRUE(caseFrozen.get("dharma") && *caseFrozen.get("dharma") == 2);
+    EXPECT_TRUE(caseFrozen.get("") && *caseFrozen.get("") == 3);
+    EXPECT_TRUE(!caseFrozen.hasKey("karm"));
+
+    // wider symbols are coded by searching the used symbols, bytes with the high bit set by the table
+    rtv::Trie<wchar_t, int> wideTrie(L'\0');
+    wideTrie.insert(L"\x263a\x263b", 1);
+    wideTrie.insert(L"\x263a", 2);
+    wideTrie.insert(L"abc", 3);
+    rtv::DoubleArrayTrie<wchar_t, int> wideFrozen = rtv::freeze(wideTrie);
+    EXPECT_TRUE(wideFrozen.size() == 3);
+    EXPECT_TRUE(wideFrozen.get(L"\x263a\x263b") && *wideFrozen.get(L"\x263a\x263b") == 1);
+    EXPECT_TRUE(wideFrozen.get(L"\x263a") && *wideFrozen.get(L"\x263a") == 2);
+    EXPECT_TRUE(!wideFrozen.hasKey(L"\x263b"));
+
+    rtv::Trie<char, int> byteTrie('\0');
+    byteTrie.insert("\xe2\x98\xba", 1);
+    byteTrie.insert("a\xff", 2);
+    rtv::DoubleArrayTrie<char, int> byteFrozen = rtv::freeze(byteTrie);
+    EXPECT_TRUE(byteFrozen.get("\xe2\x98\xba") && *byteFrozen.get("\xe2\x98\xba") == 1);
+    EXPECT_TRUE(byteFrozen.get("a\xff") && *byteFrozen.get("a\xff") == 2);
+    EXPECT_TRUE(!byteFrozen.hasKey("a\xfe"));
+}
+
+
+TEST_F(DoubleArrayTrieTestCases, DoubleArrayTrieCase_WideAlphabetIteration)
+{
+    // each node keeps the codes of its children, the iteration follows them in any alphabet
+    rtv::Trie<wchar_t, int> wideTrie(L'\0');
+    wchar_t key[3] = {L'\0', L'\0', L'\0'};
+    for (int i = 0; i < 4000; ++i) {
+        key[0] = (wchar_t)(0x4e00 + i);
+        key[1] = L'\0';
+        if (i % 2) {
+            wideTrie.insert(key, i);
+        }
+        key[1] = (wchar_t)(0x4e00 + 3999 - i);
+        wideTrie.insert(key, -i);
+    }
+    rtv::DoubleArrayTrie<wchar_t, int> wideFrozen = rtv::freeze(wideTrie);
+    EXPECT_TRUE(wideFrozen.size() == wideTrie.size());
+
+    rtv::Trie<wchar_t, int>::ConstIterator expected = wideTrie.begin();
+    rtv::DoubleArrayTrie<wchar_t, int>::ConstIterator iter = wideFrozen.begin();
+    for (; iter != wideFrozen.end() && expected != wideTrie.end(); ++iter, ++expected) {
+        EXPECT_TRUE(std::wstring(iter->first) == std::wstring(expected->first));
+        EXPECT_TRUE(*iter->second == *expected->second);
+    }
+    EXPECT_TRUE(iter == wideFrozen.end() && expected == wideTrie.end());
+
+    key[0] = (wchar_t)(0x4e00 + 7);
+    key[1] = L'\0';
+    iter = wideFrozen.startsWith(key);
+    EXPECT_TRUE(iter != wideFrozen.end() && *iter->second == 7);
+    ++iter;
+    EXPECT_TRUE(iter != wideFrozen.end() && *iter->second == -7);
+    ++iter;
+    EXPECT_TRUE(iter == wideFrozen.end());
+}
+}
@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2012, Ranjith TV
+ * All rights reserved.
+ *
+ * Licensed under the BSD 3-Clause ("BSD New" or "BSD Simplified") license.
+ * You may obtain a copy of the License at
+ *
+ * http://www.opensource.org/licenses/BSD-3-Clause
+ *
+ */
+
+#include "louds_trie.h"
+#include "trietest.h"
+
+#include <map>
+#include <string>
+#include <vector>
+#include <cstdlib>
+
+using namespace rtv;
+
+namespace
+{
+
+typedef ReadOnlyTrieTestCases LoudsTrieTestCases;
+
+TEST_F(LoudsTrieTestCases, LoudsTrieCase_Build)
+{
+    rtv::Trie<char, int> aTrie('\0');
+    Expected expected;
+    fill(aTrie, expected, 13);
+
+    rtv::LoudsTrie<char, int> louds(aTrie);
+    EXPECT_TRUE(louds.endSymbol() == '\0');
+    checkContents(louds, expected);
+
+    // an iterator copied on the way keeps its own key
+    rtv::LoudsTrie<char, int>::ConstIterator iter = louds.startsWith("ka");
+    rtv::LoudsTrie<char, int>::ConstIterator copy = iter++;
+    EXPECT_TRUE(std::string(copy->first) == "karma" && iter != copy);
+
+    // the copies do not depend on the Trie
+    rtv::LoudsTrie<char, int> other = louds;
+    aTrie.clear();
+    checkContents(louds, expected);
+    checkContents(other, expected);
+
+    rtv::Trie<char, int, std::less<char>, rtv::VectorItems<char, int, std::less<char>, 256> > vectorTrie('\0');
+    Expected vectorExpected;
+    fill(vectorTrie, vectorExpected, 13);
+    checkContents(rtv::LoudsTrie<char, int>(vectorTrie), vectorExpected);
+
+    rtv::Trie<char, int> compressedTrie('\0', true);
+    Expected compressedExpected;
+    fill(compressedTrie, compressedExpected, 13);
+    compressedTrie.insert("dharmakarmadharma", -1);
+    compressedExpected["dharmakarmadharma"] = -1;
+    checkContents(rtv::LoudsTrie<char, int>(compressedTrie), compressedExpected);
+}
+
+TEST_F(LoudsTrieTestCases, LoudsTrieCase_ManyNodes)
+{
+    // enough nodes for several blocks of the rank and select directories
+    rtv::Trie<char, int> aTrie('\0');
+    Expected expected;
+    std::srand(17);
+    for (int round = 0; round < 60000; ++round) {
+        std::string key;
+        int length = 1 + std::rand() % 10;
+        for (int i = 0; i < length; ++i) {
+            key += (char)('a' + std::rand() % 8);
+        }
+        aTrie.insert(key.c_str(), round);
+        expected.insert(std::make_pair(key, round));
+    }
+
+    rtv::LoudsTrie<char, int> louds(aTrie);
+    EXPECT_TRUE(louds.size() == expected.size());
+    EXPECT_TRUE(louds.nodeCount() > 65536);
+    EXPECT_TRUE(louds.shapeBits() < louds.nodeCount() * 5 / 2);
+
+    Expected::const_iterator eiter = expected.begin();
+    for (rtv::LoudsTrie<char, int>::ConstIterator iter = louds.begin(); iter != louds.end(); ++iter, ++eiter) {
+        EXPECT_TRUE(eiter != expected.end() && eiter->first.compare(iter->first) == 0);
+        EXPECT_TRUE(eiter != expected.end() && *iter->second == eiter->second);
+    }
+    EXPECT_TRUE(eiter == expected.end());
+    for (Expected::const_iterator iter = expected.begin(); iter != expected.end(); ++iter) {
+        EXPECT_TRUE(louds.get(iter->first.c_str()) && *louds.get(iter->first.c_str()) == iter->second);
+    }
+    EXPECT_TRUE(!louds.hasKey("z"));
+    EXPECT_TRUE(!louds.hasKey("aaaaaaaaaaaz"));
+}
+
+TEST_F(LoudsTrieTestCases, LoudsTrieCase_BitVector)
+{
+    rtv::BitVector bits;
+    std::vector<bool> expected;
+    std::srand(19);
+    for (int i = 0; i < 200000; ++i) {
+        // long runs of ones and of zeros as well as mixed bits
+        bool bit = i < 70000 ? std::rand() % 3 == 0 : (i < 140000 ? std::rand() % 50 != 0 : std::rand() % 50 == 0);
+        bits.pushBack(bit);
+        expected.push_back(bit);
+    }
+    bits.seal();
+    EXPECT_TRUE(bits.size() == expected.size());
+
+    std::size_t ones = 0;
+    std::size_t zeros = 0;
+    std::size_t rankErrors = 0;
+    std::size_t selectErrors = 0;
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+        rankErrors += bits[i] != expected[i] || bits.rank1(i) != ones;
+        if (expected[i]) {
+            ++ones;
+        } else {
+            selectErrors += bits.select0(zeros) != i;
+            ++zeros;
+        }
+    }
+    EXPECT_TRUE(rankErrors == 0);
+    EXPECT_TRUE(selectErrors == 0);
+    EXPECT_TRUE(bits.nextZero(0) == 0 || expected[0]);
+    EXPECT_TRUE(bits.nextZero(bits.select0(zeros - 2) + 1) == bits.select0(zeros - 1));
+}
+
+TEST_F(LoudsTrieTestCases, LoudsTrieCase_SymbolsAndEmpty)
+{
+    rtv::Trie<char, int> emptyTrie('\0');
+    checkContents(rtv::LoudsTrie<char, int>(emptyTrie), Expected());
+    rtv::LoudsTrie<char, int> empty('\0');
+    checkContents(empty, Expected());
+    EXPECT_TRUE(empty.nodeCount() == 1);
+
+    rtv::Trie<char, int, TrieCaseInsensitiveCompare> caseTrie('\0');
+    caseTrie.insert("Karma", 1);
+    caseTrie.insert("dharMA", 2);
+    caseTrie.insert("", 3);
+    rtv::LoudsTrie<char, int, TrieCaseInsensitiveCompare> caseLouds(caseTrie);
+    EXPECT_TRUE(caseLouds.get("KARMA") && *caseLouds.get("KARMA") == 1);
+    EXPECT_TRUE(caseLouds.get("dharma") && *caseLouds.get("dharma") == 2);
+    EXPECT_TRUE(caseLouds.get("") && *caseLouds.get("") == 3);
+    EXPECT_TRUE(!caseLouds.hasKey("karm"));
+
+    rtv::Trie<wchar_t, int> wideTrie(L'\0');
+    wideTrie.insert(L"\x263a\x263b", 1);
+    wideTrie.insert(L"\x263a", 2);
+    wideTrie.insert(L"abc", 3);
+    rtv::LoudsTrie<wchar_t, int> wideLouds(wideTrie);
+    EXPECT_TRUE(wideLouds.size() == 3);
+    EXPECT_TRUE(wideLouds.get(L"\x263a\x263b") && *wideLouds.get(L"\x263a\x263b") == 1);
+    EXPECT_TRUE(wideLouds.get(L"\x263a") && *wideLouds.get(L"\x263a") == 2);
+    EXPECT_TRUE(!wideLouds.hasKey(L"\x263b"));
+}
+
+}
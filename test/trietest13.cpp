@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2012, Ranjith TV
+ * All rights reserved.
+ *
+ * Licensed under the BSD 3-Clause ("BSD New" or "BSD Simplified") license.
+ * You may obtain a copy of the License at
+ *
+ * http://www.opensource.org/licenses/BSD-3-Clause
+ *
+ */
+
+#include "trie.h"
+#include "trietest.h"
+#include "testsuite.h"
+
+#include <map>
+#include <string>
+#include <cstdlib>
+
+using namespace rtv;
+
+namespace
+{
+
+typedef rtv::SetItems<char, std::string, std::less<char>, CountingAllocator> CountingSetItems;
+typedef rtv::VectorItems<char, std::string, std::less<char>, 256,
+                         rtv::SymbolToIndexMapper<char>, CountingAllocator> CountingVectorItems;
+typedef rtv::AdaptiveItems<char, std::string, std::less<char>, 256,
+                           rtv::SymbolToIndexMapper<char>, CountingAllocator> CountingAdaptiveItems;
+
+class TerminalTestCases : public TrieLayoutTestCases<char>
+{
+protected:
+    typedef std::map<std::string, std::string> Expected;
+
+    template <typename TrieType>
+    void checkContents(TrieType const &aTrie, Expected const &expected) {
+        TrieLayoutTestCases<char>::checkContents(aTrie, expected);
+        for (Expected::const_iterator eiter = expected.begin(); eiter != expected.end(); ++eiter) {
+            EXPECT_TRUE(!aTrie.hasKey((eiter->first + "z").c_str()));
+        }
+    }
+
+    template <typename Items>
+    void checkAllocations(bool compressed) {
+        typedef rtv::Trie<char, std::string, std::less<char>, Items> CountingTrie;
+        CountingAllocator::live() = 0;
+        {
+            CountingTrie aTrie('\0', compressed);
+            Expected expected;
+
+            aTrie.insert("abcd", "abcd");
+            expected["abcd"] = "abcd";
+            std::size_t allocations = CountingAllocator::allocations();
+            // the keys ending at nodes which are already there take no memory of the allocator
+            // but their value, which is larger than a pointer and so kept out of the node
+            const char *prefixes[] = {"abc", "ab", "a"};
+            for (int i = 0; i < 3; ++i) {
+                EXPECT_TRUE(aTrie.insert(prefixes[i], prefixes[i]).second);
+                expected[prefixes[i]] = prefixes[i];
+                EXPECT_TRUE(compressed || CountingAllocator::allocations() == allocations + i + 1);
+            }
+            EXPECT_TRUE(aTrie.insert("", "root").second);
+            expected[""] = "root";
+            EXPECT_TRUE(compressed || CountingAllocator::allocations() == allocations + 4);
+            EXPECT_TRUE(!aTrie.insert("ab", "again").second);
+            checkContents(aTrie, expected);
+
+            std::srand(21);
+            for (int round = 0; round < 500; ++round) {
+                std::string key;
+                int length = std::rand() % 6;
+                for (int i = 0; i < length; ++i) {
+                    key += (char)('a' + std::rand() % 4);
+                }
+                if (std::rand() % 3 == 0) {
+                    EXPECT_TRUE(aTrie.erase(key.c_str()) == (expected.erase(key) == 1));
+                } else {
+                    EXPECT_TRUE(aTrie.insert(key.c_str(), key).second == expected.insert(std::make_pair(key, key)).second);
+                }
+            }
+            checkContents(aTrie, expected);
+
+            // erasing every key leaves only the root behind
+            for (Expected::const_iterator iter = expected.begin(); iter != expected.end(); ++iter) {
+                EXPECT_TRUE(aTrie.erase(iter->first.c_str()));
+            }
+            EXPECT_TRUE(aTrie.empty() && aTrie.begin() == aTrie.end());
+            checkContents(aTrie, Expected());
+
+            aTrie.insert("karma", "karma");
+            aTrie.clear();
+            EXPECT_TRUE(aTrie.empty() && !aTrie.hasKey("karma"));
+        }
+        EXPECT_TRUE(CountingAllocator::live() == 0);
+    }
+};
+
+TEST_F(TerminalTestCases, TerminalCase_Allocations)
+{
+    checkAllocations<CountingSetItems>(false);
+    checkAllocations<CountingVectorItems>(false);
+    checkAllocations<CountingAdaptiveItems>(false);
+    checkAllocations<CountingSetItems>(true);
+    checkAllocations<CountingVectorItems>(true);
+}
+
+TEST_F(TerminalTestCases, TerminalCase_InlineValue)
+{
+    typedef rtv::Trie<char, int, std::less<char>, rtv::SetItems<char, int, std::less<char>, CountingAllocator> > IntTrie;
+    CountingAllocator::live() = 0;
+    {
+        IntTrie aTrie('\0');
+        aTrie.insert("abcd", 4);
+        std::size_t allocations = CountingAllocator::allocations();
+        // a value no larger than a pointer is kept in the node
+        const char *prefixes[] = {"abc", "ab", "a", ""};
+        for (int i = 0; i < 4; ++i) {
+            EXPECT_TRUE(aTrie.insert(prefixes[i], i).second);
+        }
+        EXPECT_TRUE(CountingAllocator::allocations() == allocations);
+        EXPECT_TRUE(*aTrie.get("ab") == 1 && *aTrie.get("") == 3);
+        EXPECT_TRUE(aTrie.erase("ab") && !aTrie.hasKey("ab") && aTrie.hasKey("abc"));
+    }
+    EXPECT_TRUE(CountingAllocator::live() == 0);
+}
+
+TEST_F(TerminalTestCases, TerminalCase_CompressedErase)
+{
+    rtv::Trie<char, std::string> aTrie('\0', true);
+    Expected expected;
+    const char *keys[] = {"dharma", "dharmakarma", "dharmakarmadharma", "karma", ""};
+    for (int i = 0; i < 5; ++i) {
+        aTrie.insert(keys[i], keys[i]);
+        expected[keys[i]] = keys[i];
+    }
+    checkContents(aTrie, expected);
+
+    // the node left with a single child and no value is merged with the child
+    EXPECT_TRUE(aTrie.erase("dharmakarma"));
+    expected.erase("dharmakarma");
+    checkContents(aTrie, expected);
+    EXPECT_TRUE(!aTrie.hasKey("dharmakarma") && aTrie.startsWith("dharmak") != aTrie.end());
+
+    EXPECT_TRUE(aTrie.erase("dharma"));
+    expected.erase("dharma");
+    checkContents(aTrie, expected);
+    EXPECT_TRUE(aTrie.startsWith("dharmakarmad") != aTrie.end());
+
+    // erasing through an iterator
+    EXPECT_TRUE(aTrie.erase(aTrie.find("")));
+    expected.erase("");
+    EXPECT_TRUE(!aTrie.erase(aTrie.end()));
+    checkContents(aTrie, expected);
+}
+
+TEST_F(TerminalTestCases, TerminalCase_Swap)
+{
+    rtv::Trie<char, std::string> first('\0');
+    rtv::Trie<char, std::string> second('\0');
+    first.insert("", "first root");
+    first.insert("a", "first a");
+    second.insert("b", "second b");
+
+    first.swap(second);
+    Expected expectedFirst;
+    expectedFirst["b"] = "second b";
+    Expected expectedSecond;
+    expectedSecond[""] = "first root";
+    expectedSecond["a"] = "first a";
+    checkContents(first, expectedFirst);
+    checkContents(second, expectedSecond);
+
+    first.insert("", "second root");
+    first.swap(second);
+    expectedFirst[""] = "second root";
+    checkContents(first, expectedSecond);
+    checkContents(second, expectedFirst);
+
+    // the swap and the move invalidate all the iterators, those taken again walk the elements moved below
+    // the other root
+    rtv::Trie<char, std::string> deep('\0');
+    deep.insert("abc", "abc");
+    deep.insert("abd", "abd");
+    deep.insert("x", "x");
+    rtv::Trie<char, std::string> other('\0');
+    deep.swap(other);
+    EXPECT_TRUE(deep.begin() == deep.end());
+    rtv::Trie<char, std::string>::Iterator iter = other.find("abc");
+    EXPECT_TRUE(iter != other.end() && *iter->second == "abc");
+    ++iter;
+    EXPECT_TRUE(iter != other.end() && *iter->second == "abd");
+    ++iter;
+    EXPECT_TRUE(iter != other.end() && *iter->second == "x");
+    ++iter;
+    EXPECT_TRUE(iter == other.end());
+
+#ifdef RTV_HAS_CXX11
+    rtv::Trie<char, std::string> moved(std::move(other));
+    iter = moved.find("abd");
+    ++iter;
+    EXPECT_TRUE(iter != moved.end() && *iter->second == "x");
+    EXPECT_TRUE(other.begin() == other.end());
+#endif
+}
+
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2012, Ranjith TV
+ * All rights reserved.
+ *
+ * Licensed under the BSD 3-Clause ("BSD New" or "BSD Simplified") license.
+ * You may obtain a copy of the License at
+ *
+ * http://www.opensource.org/licenses/BSD-3-Clause
+ *
+ */
+
+#include "trie.h"
+#include "trietest.h"
+#include "testsuite.h"
+
+using namespace rtv;
+
+namespace
+{
+
+typedef rtv::SortedArrayItems<char, std::string, std::less<char> > SortedArrayItemClass;
+
+typedef TrieTestCases< rtv::Trie<char, std::string, std::less<char>, SortedArrayItemClass> > TrieSortedArrayTestCases;
+
+TEST_F(TrieSortedArrayTestCases, TrieSortedArrayImplCase_Dollar_EndSymbol)
+{
+    TheTrie dictionary('$');
+    testSuite(dictionary);
+}
+
+TEST_F(TrieSortedArrayTestCases, TrieSortedArrayImplCase_Null_EndSymbol)
+{
+    TheTrie dictionary('\0');
+    testSuite(dictionary);
+}
+
+typedef TrieTestCases< rtv::Trie<char, std::string, TrieCaseInsensitiveCompare,
+                                 rtv::SortedArrayItems<char, std::string, TrieCaseInsensitiveCompare,
+                                                       rtv::SlabAllocator<> > > > TrieCaseInSensitiveSortedArrayTestCases;
+TEST_F(TrieCaseInSensitiveSortedArrayTestCases, TrieSortedArrayImplCase_CaseInsensitive)
+{
+    TheTrie dictionary('\0');
+    testSuite(dictionary);
+}
+
+typedef rtv::Trie<unsigned short, int, std::less<unsigned short>,
+                  rtv::SortedArrayItems<unsigned short, int, std::less<unsigned short> > > WideTrie;
+
+class TrieSortedArrayLayoutTestCases : public TrieLayoutTestCases<unsigned short>
+{
+protected:
+    // compares the search of up to limit sorted symbols with std::lower_bound
+    template <typename T>
+    void checkSearch(unsigned int limit) {
+        std::vector<T> symbols;
+        for (unsigned int count = 0; count < limit; ++count) {
+            symbols.push_back((T)(count * 3 + 1));
+            // the search reads whole blocks past the last symbol
+            std::vector<T> padded(symbols);
+            padded.resize(symbols.size() + 64, (T)(count * 3 + 2));
+            for (unsigned int symbol = 0; symbol < count * 3 + 8; ++symbol) {
+                int expected = -1;
+                typename std::vector<T>::iterator pos = std::lower_bound(symbols.begin(), symbols.end(), (T)symbol);
+                if (pos != symbols.end() && *pos == (T)symbol) {
+                    expected = pos - symbols.begin();
+                }
+                EXPECT_TRUE((rtv::SortedSymbolSearch<T, std::less<T> >::find(&padded[0], symbols.size(), (T)symbol) ==
+                             expected));
+            }
+        }
+    }
+};
+
+TEST_F(TrieSortedArrayLayoutTestCases, TrieSortedArrayImplCase_Search)
+{
+    checkSearch<unsigned char>(80);
+    checkSearch<unsigned short>(300);
+    checkSearch<unsigned int>(300);
+    checkSearch<wchar_t>(300);
+}
+
+TEST_F(TrieSortedArrayLayoutTestCases, TrieSortedArrayImplCase_GrowAndShrink)
+{
+    // the root holds a thousand items and each child holds a different number of items
+    WideTrie aTrie(0);
+    growAndShrink(aTrie, TwoSymbolKeys<unsigned short>(1000, 61, 40, 70000, -997), 11, 2000);
+}
+
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2012, Ranjith TV
+ * All rights reserved.
+ *
+ * Licensed under the BSD 3-Clause ("BSD New" or "BSD Simplified") license.
+ * You may obtain a copy of the License at
+ *
+ * http://www.opensource.org/licenses/BSD-3-Clause
+ *
+ */
+
+#include "trie.h"
+#include "trietest.h"
+#include "testsuite.h"
+
+using namespace rtv;
+
+namespace
+{
+
+typedef rtv::BitmapItems<char, std::string, std::less<char> > BitmapItemClass;
+
+typedef TrieTestCases< rtv::Trie<char, std::string, std::less<char>, BitmapItemClass> > TrieBitmapTestCases;
+
+TEST_F(TrieBitmapTestCases, TrieBitmapImplCase_Dollar_EndSymbol)
+{
+    TheTrie dictionary('$');
+    testSuite(dictionary);
+}
+
+TEST_F(TrieBitmapTestCases, TrieBitmapImplCase_Null_EndSymbol)
+{
+    TheTrie dictionary('\0');
+    testSuite(dictionary);
+}
+
+typedef TrieTestCases< rtv::Trie<char, std::string, TrieCaseInsensitiveCompare, rtv::BitmapItems<char, std::string,
+                             TrieCaseInsensitiveCompare, 28, AlphaToIndex> > > TrieCaseInSensitiveBitmapTestCases;
+TEST_F(TrieCaseInSensitiveBitmapTestCases, TrieBitmapImplCase_CustomBitmapItemCaseInsensitive)
+{
+    TheTrie dictionary('\0');
+    testSuite(dictionary);
+}
+
+typedef rtv::Trie<unsigned char, int, std::less<unsigned char>,
+                  rtv::BitmapItems<unsigned char, int, std::less<unsigned char>, 256,
+                                   rtv::SymbolToIndexMapper<unsigned char>, rtv::SlabAllocator<> > > WideTrie;
+
+typedef TrieLayoutTestCases<unsigned char> TrieBitmapLayoutTestCases;
+
+TEST_F(TrieBitmapLayoutTestCases, TrieBitmapImplCase_GrowAndShrink)
+{
+    // the root fills every word of the bitmap and each child holds a different number of items
+    WideTrie aTrie(0);
+    growAndShrink(aTrie, TwoSymbolKeys<unsigned char>(255, 1, 70, 256, -3), 5, 500);
+}
+
+TEST_F(TrieBitmapLayoutTestCases, TrieBitmapImplCase_Size)
+{
+    // a node holds the bitmap and the counts instead of Max pointers
+    EXPECT_TRUE(sizeof(BitmapItemClass) < 128);
+}
+
+}
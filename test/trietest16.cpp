@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2012, Ranjith TV
+ * All rights reserved.
+ *
+ * Licensed under the BSD 3-Clause ("BSD New" or "BSD Simplified") license.
+ * You may obtain a copy of the License at
+ *
+ * http://www.opensource.org/licenses/BSD-3-Clause
+ *
+ */
+
+#include "trie.h"
+#include "trietest.h"
+#include "testsuite.h"
+
+#include <cctype>
+#include <cstdlib>
+
+#ifdef RTV_HAS_CXX11
+#include <thread>
+#endif
+
+using namespace rtv;
+
+namespace
+{
+
+// maps the letters of both cases to the same index
+class CaseInsensitiveIndex
+{
+public:
+    unsigned int operator()(const char & c) const {
+        return static_cast<unsigned int>(std::tolower(c));
+    }
+};
+
+typedef rtv::HashItems<char, std::string, std::less<char> > HashItemClass;
+
+typedef TrieTestCases< rtv::Trie<char, std::string, std::less<char>, HashItemClass> > TrieHashTestCases;
+
+TEST_F(TrieHashTestCases, TrieHashImplCase_Dollar_EndSymbol)
+{
+    TheTrie dictionary('$');
+    testSuite(dictionary);
+}
+
+TEST_F(TrieHashTestCases, TrieHashImplCase_Null_EndSymbol)
+{
+    TheTrie dictionary('\0');
+    testSuite(dictionary);
+}
+
+typedef TrieTestCases< rtv::Trie<char, std::string, TrieCaseInsensitiveCompare,
+                                 rtv::HashItems<char, std::string, TrieCaseInsensitiveCompare, CaseInsensitiveIndex,
+                                                rtv::SlabAllocator<> > > > TrieCaseInSensitiveHashTestCases;
+TEST_F(TrieCaseInSensitiveHashTestCases, TrieHashImplCase_CaseInsensitive)
+{
+    TheTrie dictionary('\0');
+    testSuite(dictionary);
+}
+
+typedef rtv::Trie<unsigned int, int, std::less<unsigned int>,
+                  rtv::HashItems<unsigned int, int, std::less<unsigned int> > > TokenTrie;
+
+// Keys of one or two tokens, the first tokens collide in the low bits and the root grows to thousands of items
+class TokenKeys
+{
+public:
+    TokenKeys()
+            : mCount(0) {}
+
+    bool operator()(std::vector<unsigned int> &key) {
+        if (mCount == 20000) {
+            return false;
+        }
+        ++mCount;
+        unsigned int tokens[] = {(unsigned int)(std::rand() % 3000) << 12, (unsigned int)(std::rand() % 50)};
+        key.assign(tokens, tokens + 1 + std::rand() % 2);
+        return true;
+    }
+
+private:
+    int mCount;
+};
+
+typedef TrieLayoutTestCases<unsigned int> TrieHashLayoutTestCases;
+
+TEST_F(TrieHashLayoutTestCases, TrieHashImplCase_Tokens)
+{
+    TokenTrie aTrie(0xffffffffu);
+    growAndShrink(aTrie, TokenKeys(), 3, 3000);
+}
+
+#ifdef RTV_HAS_CXX11
+TEST_F(TrieHashLayoutTestCases, TrieHashImplCase_ConcurrentIteration)
+{
+    TokenTrie aTrie(0xffffffffu);
+    std::srand(9);
+    for (int value = 0; value < 5000; ++value) {
+        unsigned int key[] = {(unsigned int)(std::rand() % 300) << 12, (unsigned int)(std::rand() % 50)};
+        aTrie.insert(key, 2, value);
+    }
+
+    // the ordered index of each node is sorted by the first of the threads reaching it, the others use it
+    std::size_t counts[4] = {0, 0, 0, 0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.push_back(std::thread([&aTrie, &counts, t]() {
+            unsigned int last[] = {0, 0};
+            for (TokenTrie::ConstIterator iter = aTrie.begin(); iter != aTrie.end(); ++iter) {
+                bool ordered = last[0] < iter->first[0] || (last[0] == iter->first[0] && last[1] < iter->first[1]);
+                if (counts[t] > 0 && !ordered) {
+                    return;
+                }
+                last[0] = iter->first[0];
+                last[1] = iter->first[1];
+                ++counts[t];
+            }
+        }));
+    }
+    for (std::size_t t = 0; t < threads.size(); ++t) {
+        threads[t].join();
+    }
+    for (int t = 0; t < 4; ++t) {
+        EXPECT_TRUE(counts[t] == aTrie.size());
+    }
+
+    // a change drops the index, the next iteration sorts it again
+    unsigned int key[] = {300u << 12, 0};
+    EXPECT_TRUE(aTrie.insert(key, 2, -1).second);
+    TokenTrie::ConstIterator iter = aTrie.end();
+    --iter;
+    EXPECT_TRUE(iter->first[0] == key[0] && iter->first[1] == 0 && *iter->second == -1);
+}
+#endif
+
+}
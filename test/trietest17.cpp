@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2012, Ranjith TV
+ * All rights reserved.
+ *
+ * Licensed under the BSD 3-Clause ("BSD New" or "BSD Simplified") license.
+ * You may obtain a copy of the License at
+ *
+ * http://www.opensource.org/licenses/BSD-3-Clause
+ *
+ */
+
+#include "trie.h"
+#include "trietest.h"
+#include "testsuite.h"
+
+#include <cstdio>
+
+using namespace rtv;
+
+namespace
+{
+
+typedef TrieTestCases< rtv::Trie<char, std::string, std::less<char>,
+                                 rtv::HybridItems<char, std::string, std::less<char>, 2> > > TrieHybridTestCases;
+
+TEST_F(TrieHybridTestCases, TrieHybridImplCase_Dollar_EndSymbol)
+{
+    TheTrie dictionary('$');
+    testSuite(dictionary);
+}
+
+TEST_F(TrieHybridTestCases, TrieHybridImplCase_Null_EndSymbol)
+{
+    TheTrie dictionary('\0');
+    testSuite(dictionary);
+}
+
+typedef TrieTestCases< rtv::Trie<char, std::string, TrieCaseInsensitiveCompare,
+                                 rtv::HybridItems<char, std::string, TrieCaseInsensitiveCompare, 1, 28,
+                                                  AlphaToIndex, rtv::SlabAllocator<> > > >
+        TrieCaseInSensitiveHybridTestCases;
+TEST_F(TrieCaseInSensitiveHybridTestCases, TrieHybridImplCase_CaseInsensitive)
+{
+    TheTrie dictionary('\0');
+    testSuite(dictionary);
+}
+
+typedef TrieTestCases< rtv::Trie<char, std::string, std::less<char>,
+                                 rtv::HybridItems<char, std::string, std::less<char>, 0> > > TrieSparseHybridTestCases;
+TEST_F(TrieSparseHybridTestCases, TrieHybridImplCase_AllSparse)
+{
+    TheTrie dictionary('\0');
+    testSuite(dictionary);
+}
+
+typedef rtv::HybridItems<char, int, std::less<char>, 3, 28, AlphaToIndex, CountingAllocator> CountingHybrid;
+typedef rtv::HybridItems<char, std::string, std::less<char>, 3, 28, AlphaToIndex,
+                         CountingAllocator> CountingStringHybrid;
+
+class TrieHybridStatsTestCases : public rtv::RTest
+{
+protected:
+    // every three letter key and each of them followed by 'a'
+    template <typename TrieType>
+    static void fill(TrieType &aTrie) {
+        char key[] = "aaaa";
+        int value = 0;
+        for (char c0 = 'a'; c0 <= 'z'; ++c0) {
+            for (char c1 = 'a'; c1 <= 'z'; ++c1) {
+                for (char c2 = 'a'; c2 <= 'z'; ++c2) {
+                    key[0] = c0;
+                    key[1] = c1;
+                    key[2] = c2;
+                    aTrie.insert(key, 3, value++);
+                    aTrie.insert(key, 4, value++);
+                }
+            }
+        }
+    }
+};
+
+TEST_F(TrieHybridStatsTestCases, TrieHybridImplCase_Stats)
+{
+    rtv::Trie<char, int> setTrie('\0');
+    fill(setTrie);
+    rtv::TrieStats stats = setTrie.stats();
+
+    std::size_t nodes[] = {1, 26, 676, 17576, 17576};
+    std::size_t items[] = {26, 676, 17576, 17576, 0};
+    EXPECT_TRUE(stats.levels().size() == 5);
+    for (unsigned int depth = 0; depth < 5 && depth < stats.levels().size(); ++depth) {
+        EXPECT_TRUE(stats.levels()[depth].mNodes == nodes[depth]);
+        EXPECT_TRUE(stats.levels()[depth].mItems == items[depth]);
+    }
+    EXPECT_TRUE(stats.keys() == 2 * 17576);
+
+    // the full nodes take less as arrays of 28 and the nodes of one item less as sorted arrays
+    EXPECT_TRUE(stats.bestCutoff<CountingHybrid>() == 3);
+    EXPECT_TRUE(stats.hybridBytes<CountingHybrid>(3) < stats.hybridBytes<CountingHybrid>(0));
+    EXPECT_TRUE(stats.hybridBytes<CountingHybrid>(3) < stats.hybridBytes<CountingHybrid>(5));
+
+    // the Trie with that cutoff allocates what the stats tell, but for the root which is not allocated
+    CountingAllocator::bytes() = 0;
+    {
+        rtv::Trie<char, int, std::less<char>, CountingHybrid> hybridTrie('\0');
+        fill(hybridTrie);
+        EXPECT_TRUE(CountingAllocator::bytes() + sizeof(CountingHybrid::NodeClass) ==
+                    stats.hybridBytes<CountingHybrid>(3));
+        EXPECT_TRUE(hybridTrie.get("kar", 3) && hybridTrie.get("kara") && !hybridTrie.hasKey("karm"));
+    }
+    EXPECT_TRUE(CountingAllocator::bytes() == 0);
+
+    // a value larger than a pointer is allocated out of its node and counted too
+    {
+        rtv::Trie<char, std::string, std::less<char>, CountingStringHybrid> stringTrie('\0');
+        const char *keys[] = {"karma", "kar", "dharma", ""};
+        for (int i = 0; i < 4; ++i) {
+            stringTrie.insert(keys[i], keys[i]);
+        }
+        EXPECT_TRUE(CountingAllocator::bytes() + sizeof(CountingStringHybrid::NodeClass) ==
+                    stringTrie.stats().hybridBytes<CountingStringHybrid>(3));
+    }
+    EXPECT_TRUE(CountingAllocator::bytes() == 0);
+
+    // the depth of a node is the number of key symbols above it, splitting and merging the labels of a
+    // compressed Trie do not change it, so the layouts still match the stats
+    {
+        rtv::Trie<char, int, std::less<char>, CountingHybrid> compressedTrie('\0', true);
+        const char *keys[] = {"karmayoga", "karmabhumi", "kar", "karm", "dharmayoga", "dharmabhumi", "dharma", "k"};
+        for (int i = 0; i < 8; ++i) {
+            compressedTrie.insert(keys[i], i);
+        }
+        EXPECT_TRUE(CountingAllocator::bytes() + sizeof(CountingHybrid::NodeClass) ==
+                    compressedTrie.stats().hybridBytes<CountingHybrid>(3));
+        compressedTrie.erase("kar");
+        compressedTrie.erase("karm");
+        compressedTrie.erase("dharma");
+        EXPECT_TRUE(CountingAllocator::bytes() + sizeof(CountingHybrid::NodeClass) ==
+                    compressedTrie.stats().hybridBytes<CountingHybrid>(3));
+        EXPECT_TRUE(compressedTrie.get("karmabhumi") && *compressedTrie.get("karmabhumi") == 1);
+        EXPECT_TRUE(compressedTrie.size() == 5 && !compressedTrie.hasKey("karm"));
+    }
+    EXPECT_TRUE(CountingAllocator::bytes() == 0);
+
+    std::FILE *out = std::tmpfile();
+    if (out) {
+        stats.report<CountingHybrid>(out);
+        EXPECT_TRUE(std::ftell(out) > 0);
+        std::fclose(out);
+    }
+}
+
+}
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2012, Ranjith TV
+ * All rights reserved.
+ *
+ * Licensed under the BSD 3-Clause ("BSD New" or "BSD Simplified") license.
+ * You may obtain a copy of the License at
+ *
+ * http://www.opensource.org/licenses/BSD-3-Clause
+ *
+ */
+
+#include "trie.h"
+#include "trietest.h"
+#include "testsuite.h"
+
+#include <string>
+#include <vector>
+
+#ifdef RTV_HAS_CXX11
+using namespace rtv;
+
+namespace
+{
+
+typedef rtv::Trie<char, ThrowingValue, std::less<char>,
+                  rtv::SetItems<char, ThrowingValue, std::less<char>, rtv::SlabAllocator<> > > ThrowingTrie;
+
+typedef std::vector< std::pair<std::string, ThrowingValue> > ThrowingPairs;
+
+class TrieParallelLoadTestCases : public rtv::RTest
+{
+protected:
+    static ThrowingPairs samplePairs() {
+        ThrowingPairs pairs;
+        const char *keys[] = {"artha", "d", "dharma", "kar", "karma", "moksha"};
+        for (int i = 0; i < 6; ++i) {
+            pairs.push_back(std::make_pair(std::string(keys[i]), ThrowingValue(i)));
+        }
+        return pairs;
+    }
+};
+
+TEST_F(TrieParallelLoadTestCases, TrieParallelLoadCase_Throws)
+{
+    ThrowingPairs pairs = samplePairs();
+    pairs[4].second.mValue = -1;
+
+    // the exception of a worker is rethrown by the calling thread, which drops the keys of all the workers
+    ThrowingTrie aTrie('\0');
+    ThrowingValue::armed() = true;
+    bool thrown = false;
+    try {
+        aTrie.parallelLoad(pairs.begin(), pairs.end(), 4, 1);
+    } catch (std::runtime_error const &) {
+        thrown = true;
+    }
+    ThrowingValue::armed() = false;
+    EXPECT_TRUE(thrown);
+    EXPECT_TRUE(aTrie.empty() && aTrie.begin() == aTrie.end());
+
+    pairs[4].second.mValue = 4;
+    EXPECT_TRUE(aTrie.parallelLoad(pairs.begin(), pairs.end(), 4, 1) == 6);
+    EXPECT_TRUE(aTrie.get("karma") && aTrie.get("karma")->mValue == 4);
+}
+
+TEST_F(TrieParallelLoadTestCases, TrieParallelLoadCase_ThrowsIntoNonEmpty)
+{
+    ThrowingPairs pairs = samplePairs();
+    pairs[0].second.mValue = -1;
+
+    // nothing is grafted when a worker throws, the keys present are left as they were
+    ThrowingTrie aTrie('\0');
+    EXPECT_TRUE(aTrie.insert("karmic", ThrowingValue(7)).second);
+    ThrowingValue::armed() = true;
+    bool thrown = false;
+    try {
+        aTrie.parallelLoad(pairs.begin(), pairs.end(), 4, 1);
+    } catch (std::runtime_error const &) {
+        thrown = true;
+    }
+    ThrowingValue::armed() = false;
+    EXPECT_TRUE(thrown);
+    EXPECT_TRUE(aTrie.size() == 1);
+    EXPECT_TRUE(aTrie.get("karmic") && aTrie.get("karmic")->mValue == 7);
+    EXPECT_FALSE(aTrie.hasKey("karma"));
+}
+
+TEST_F(TrieParallelLoadTestCases, TrieParallelLoadCase_GraftIntoNonEmpty)
+{
+    for (int compressed = 0; compressed < 2; ++compressed) {
+        for (std::size_t prefixLength = 1; prefixLength < 4; ++prefixLength) {
+            // the subtrees of the workers are merged with those present, splitting the labels where they differ
+            ThrowingTrie aTrie('\0', compressed != 0);
+            EXPECT_TRUE(aTrie.insert("karmic", ThrowingValue(7)).second);
+            EXPECT_TRUE(aTrie.insert("dharma", ThrowingValue(8)).second);
+            EXPECT_TRUE(aTrie.insert("mok", ThrowingValue(9)).second);
+
+            ThrowingPairs pairs = samplePairs();
+            EXPECT_TRUE(aTrie.parallelLoad(pairs.begin(), pairs.end(), 4, prefixLength) == 5);
+            EXPECT_TRUE(aTrie.size() == 8);
+            EXPECT_TRUE(aTrie.get("dharma")->mValue == 8);
+            EXPECT_TRUE(aTrie.get("karmic")->mValue == 7);
+            EXPECT_TRUE(aTrie.get("mok")->mValue == 9);
+            for (std::size_t i = 0; i < pairs.size(); ++i) {
+                if (pairs[i].first != "dharma") {
+                    EXPECT_TRUE(aTrie.get(pairs[i].first.c_str())->mValue == pairs[i].second.mValue);
+                }
+            }
+
+            const char *ordered[] = {"artha", "d", "dharma", "kar", "karma", "karmic", "mok", "moksha"};
+            std::size_t count = 0;
+            for (ThrowingTrie::Iterator iter = aTrie.begin(); iter != aTrie.end(); ++iter, ++count) {
+                EXPECT_TRUE(count < 8 && std::string(iter->first) == ordered[count]);
+            }
+            EXPECT_TRUE(count == 8);
+
+            // the merged Trie is modified with its own allocator
+            EXPECT_TRUE(aTrie.erase("karma") && aTrie.erase("d"));
+            EXPECT_TRUE(aTrie.insert("karmaphala", ThrowingValue(10)).second);
+            EXPECT_TRUE(aTrie.size() == 7 && aTrie.hasKey("kar") && aTrie.hasKey("dharma"));
+        }
+    }
+}
+
+}
+#endif
@@ -38,25 +38,6 @@ public:
     }
 };
 
-// key to vector index converter
-// case insensitive and includes alphabets, space and end symbol
-class AlphaToIndex
-{
-public:
-    unsigned int operator()(const char & c) const {
-        unsigned int index = 27;
-        if (c == ' ') {
-            index = 26;
-        } else if (c >= 'A' && c <= 'Z') {
-            index = c - 'A';
-        } else if (c >= 'a' && c <= 'z') {
-            index = c - 'a';
-        }
-        return index;
-    }
-};
-
-
 typedef rtv::VectorItems<char, std::string, std::less<char>, 256> VectorItemClass;
 
 typedef TrieTestCases< rtv::Trie<char, std::string, std::less<char>, VectorItemClass> > TrieVectorTestCases;
@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2012, Ranjith TV
+ * All rights reserved.
+ *
+ * Licensed under the BSD 3-Clause ("BSD New" or "BSD Simplified") license.
+ * You may obtain a copy of the License at
+ *
+ * http://www.opensource.org/licenses/BSD-3-Clause
+ *
+ */
+
+#include "trie.h"
+#include "trietest.h"
+#include "testsuite.h"
+
+using namespace rtv;
+
+namespace
+{
+
+typedef rtv::SetItems<char, std::string, TrieCompare, rtv::SlabAllocator<> > SlabSetItemClass;
+
+typedef TrieTestCases< rtv::Trie<char, std::string, TrieCompare, SlabSetItemClass> > TrieSlabSetTestCases;
+
+TEST_F(TrieSlabSetTestCases, TrieSlabSetImplCase_Dollar_EndSymbol) {
+    TheTrie dictionary('$');
+    testSuite(dictionary);
+}
+
+TEST_F(TrieSlabSetTestCases, TrieSlabSetImplCase_Null_EndSymbol) {
+    TheTrie dictionary('\0');
+    testSuite(dictionary);
+}
+
+typedef rtv::VectorItems<char, std::string, std::less<char>, 256,
+                         rtv::SymbolToIndexMapper<char>, rtv::SlabAllocator<1024> > SlabVectorItemClass;
+
+typedef TrieTestCases< rtv::Trie<char, std::string, std::less<char>, SlabVectorItemClass> > TrieSlabVectorTestCases;
+
+TEST_F(TrieSlabVectorTestCases, TrieSlabVectorImplCase_Hash_EndSymbol) {
+    TheTrie dictionary('#');
+    testSuite(dictionary);
+}
+
+TEST_F(TrieSlabVectorTestCases, TrieSlabVectorImplCase_Null_EndSymbol) {
+    TheTrie dictionary('\0');
+    testSuite(dictionary);
+}
+
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2012, Ranjith TV
+ * All rights reserved.
+ *
+ * Licensed under the BSD 3-Clause ("BSD New" or "BSD Simplified") license.
+ * You may obtain a copy of the License at
+ *
+ * http://www.opensource.org/licenses/BSD-3-Clause
+ *
+ */
+
+#include "trie.h"
+#include "trietest.h"
+#include "testsuite.h"
+
+using namespace rtv;
+
+namespace
+{
+
+typedef rtv::AdaptiveItems<char, std::string, std::less<char> > AdaptiveItemClass;
+
+typedef TrieTestCases< rtv::Trie<char, std::string, std::less<char>, AdaptiveItemClass> > TrieAdaptiveTestCases;
+
+TEST_F(TrieAdaptiveTestCases, TrieAdaptiveImplCase_Dollar_EndSymbol)
+{
+    TheTrie dictionary('$');
+    testSuite(dictionary);
+}
+
+TEST_F(TrieAdaptiveTestCases, TrieAdaptiveImplCase_Null_EndSymbol)
+{
+    TheTrie dictionary('\0');
+    testSuite(dictionary);
+}
+
+typedef TrieTestCases< rtv::Trie<char, std::string, TrieCaseInsensitiveCompare, rtv::AdaptiveItems<char, std::string,
+                             TrieCaseInsensitiveCompare, 28, AlphaToIndex> > > TrieCaseInSensitiveAdaptiveTestCases;
+TEST_F(TrieCaseInSensitiveAdaptiveTestCases, TrieAdaptiveImplCase_CustomAdaptiveItemCaseInsensitive)
+{
+    TheTrie dictionary('\0');
+    testSuite(dictionary);
+}
+
+typedef rtv::Trie<unsigned char, int, std::less<unsigned char>,
+                  rtv::AdaptiveItems<unsigned char, int, std::less<unsigned char>, 256,
+                                     rtv::SymbolToIndexMapper<unsigned char>, rtv::SlabAllocator<> > > WideTrie;
+
+typedef TrieLayoutTestCases<unsigned char> TrieAdaptiveLayoutTestCases;
+
+TEST_F(TrieAdaptiveLayoutTestCases, TrieAdaptiveImplCase_GrowAndShrink)
+{
+    // the root grows through all the layouts and each child holds a different number of items
+    WideTrie aTrie(0);
+    growAndShrink(aTrie, TwoSymbolKeys<unsigned char>(255, 1, 60, 0, 4), 7, 500);
+}
+
+}
@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2012, Ranjith TV
+ * All rights reserved.
+ *
+ * Licensed under the BSD 3-Clause ("BSD New" or "BSD Simplified") license.
+ * You may obtain a copy of the License at
+ *
+ * http://www.opensource.org/licenses/BSD-3-Clause
+ *
+ */
+
+#include "trie.h"
+#include "trietest.h"
+#include "testsuite.h"
+
+#include <map>
+
+using namespace rtv;
+
+namespace
+{
+
+typedef TrieTestCases< rtv::Trie<char, std::string, TrieCompare,
+                                 rtv::SetItems<char, std::string, TrieCompare> > > TrieCompressedSetTestCases;
+
+TEST_F(TrieCompressedSetTestCases, TrieCompressedSetImplCase_Dollar_EndSymbol)
+{
+    TheTrie dictionary('$', true);
+    testSuite(dictionary);
+}
+
+TEST_F(TrieCompressedSetTestCases, TrieCompressedSetImplCase_Null_EndSymbol)
+{
+    TheTrie dictionary('\0', true);
+    testSuite(dictionary);
+}
+
+typedef TrieTestCases< rtv::Trie<char, std::string, std::less<char>,
+                                 rtv::VectorItems<char, std::string, std::less<char>, 256> > > TrieCompressedVectorTestCases;
+
+TEST_F(TrieCompressedVectorTestCases, TrieCompressedVectorImplCase_Hash_EndSymbol)
+{
+    TheTrie dictionary('#', true);
+    testSuite(dictionary);
+}
+
+typedef TrieTestCases< rtv::Trie<char, std::string, std::less<char>,
+                                 rtv::AdaptiveItems<char, std::string, std::less<char> > > > TrieCompressedAdaptiveTestCases;
+
+TEST_F(TrieCompressedAdaptiveTestCases, TrieCompressedAdaptiveImplCase_Null_EndSymbol)
+{
+    TheTrie dictionary('\0', true);
+    testSuite(dictionary);
+}
+
+class TrieCompressedOracleTestCases : public rtv::RTest
+{
+protected:
+    typedef rtv::Trie<char, int> TheTrie;
+    typedef std::map<std::string, int> Expected;
+
+    void checkContents(TheTrie &aTrie, Expected const &expected) {
+        EXPECT_TRUE(aTrie.size() == expected.size());
+
+        Expected::const_iterator eiter = expected.begin();
+        for (TheTrie::Iterator iter = aTrie.begin(); iter != aTrie.end(); ++iter, ++eiter) {
+            EXPECT_TRUE(eiter != expected.end() && eiter->first.compare(iter->first) == 0);
+            EXPECT_TRUE(eiter != expected.end() && *iter->second == eiter->second);
+        }
+        EXPECT_TRUE(eiter == expected.end());
+
+        Expected::const_reverse_iterator riter = expected.rbegin();
+        TheTrie::ConstIterator citer = ((const TheTrie &)aTrie).end();
+        if (!expected.empty()) {
+            for (--citer; citer != ((const TheTrie &)aTrie).end(); --citer, ++riter) {
+                EXPECT_TRUE(riter != expected.rend() && riter->first.compare(citer->first) == 0);
+            }
+            EXPECT_TRUE(riter == expected.rend());
+        }
+
+        for (Expected::const_iterator iter = expected.begin(); iter != expected.end(); ++iter) {
+            EXPECT_TRUE(aTrie.get(iter->first.c_str()) && *aTrie.get(iter->first.c_str()) == iter->second);
+            EXPECT_TRUE(aTrie.find(iter->first.c_str()) != aTrie.end());
+
+            for (std::size_t len = 0; len <= iter->first.length(); len += 5) {
+                std::string prefix = iter->first.substr(0, len);
+                std::size_t count = 0;
+                for (Expected::const_iterator piter = expected.lower_bound(prefix);
+                     piter != expected.end() && piter->first.compare(0, len, prefix) == 0; ++piter) {
+                    ++count;
+                }
+                std::size_t found = 0;
+                for (TheTrie::Iterator siter = aTrie.startsWith(prefix.c_str()); siter != aTrie.end(); ++siter) {
+                    EXPECT_TRUE(std::string(siter->first).compare(0, len, prefix) == 0);
+                    ++found;
+                }
+                EXPECT_TRUE(found == count);
+            }
+        }
+    }
+};
+
+TEST_F(TrieCompressedOracleTestCases, TrieCompressedImplCase_RandomUrls)
+{
+    const char *hosts[] = {"http://www.example.com/", "http://www.example.org/", "https://www.example.com/",
+                           "http://example.com/", "ftp://files.example.com/pub/"};
+    const char *parts[] = {"index", "index.html", "images/", "img", "about/team", "about", "a", "ab", "abc"};
+
+    TheTrie aTrie('\0', true);
+    Expected expected;
+
+    EXPECT_TRUE(aTrie.pathCompression());
+
+    std::srand(11);
+    for (int round = 0; round < 2000; ++round) {
+        std::string key = hosts[std::rand() % 5];
+        int depth = std::rand() % 4;
+        for (int i = 0; i < depth; ++i) {
+            key += parts[std::rand() % 9];
+        }
+
+        if (std::rand() % 3) {
+            bool inserted = aTrie.insert(key.c_str(), round).second;
+            EXPECT_TRUE(inserted == (expected.find(key) == expected.end()));
+            expected.insert(std::make_pair(key, round));
+        } else {
+            bool erased = aTrie.erase(key.c_str());
+            EXPECT_TRUE(erased == (expected.erase(key) == 1));
+        }
+        EXPECT_TRUE(aTrie.hasKey(key.c_str()) == (expected.find(key) != expected.end()));
+
+        if (round % 500 == 0) {
+            checkContents(aTrie, expected);
+        }
+    }
+    checkContents(aTrie, expected);
+
+    while (!expected.empty()) {
+        EXPECT_TRUE(aTrie.erase(aTrie.find(expected.begin()->first.c_str())));
+        expected.erase(expected.begin());
+    }
+    checkContents(aTrie, expected);
+    EXPECT_TRUE(aTrie.empty());
+}
+
+}
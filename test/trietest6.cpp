@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2012, Ranjith TV
+ * All rights reserved.
+ *
+ * Licensed under the BSD 3-Clause ("BSD New" or "BSD Simplified") license.
+ * You may obtain a copy of the License at
+ *
+ * http://www.opensource.org/licenses/BSD-3-Clause
+ *
+ */
+
+#include "trie.h"
+#include "trietest.h"
+#include "testsuite.h"
+
+#include <string>
+#include <vector>
+
+#ifdef RTV_HAS_CXX11
+#include <memory>
+#endif
+
+using namespace rtv;
+
+namespace
+{
+
+// Value which counts how many times it has been constructed, copied and moved
+class CountedValue
+{
+public:
+    CountedValue()
+            : mValue(0) {
+        ++constructed;
+    }
+
+    CountedValue(int value, std::string const &name)
+            : mValue(value),
+              mName(name) {
+        ++constructed;
+    }
+
+    CountedValue(CountedValue const &oth)
+            : mValue(oth.mValue),
+              mName(oth.mName) {
+        ++copied;
+    }
+
+    CountedValue &operator=(CountedValue const &oth) {
+        mValue = oth.mValue;
+        mName = oth.mName;
+        ++copied;
+        return *this;
+    }
+
+#ifdef RTV_HAS_CXX11
+    CountedValue(CountedValue &&oth)
+            : mValue(oth.mValue),
+              mName(std::move(oth.mName)) {
+        ++moved;
+    }
+
+    CountedValue &operator=(CountedValue &&oth) {
+        mValue = oth.mValue;
+        mName = std::move(oth.mName);
+        ++moved;
+        return *this;
+    }
+#endif
+
+    static void reset() {
+        constructed = 0;
+        copied = 0;
+        moved = 0;
+    }
+
+    int mValue;
+    std::string mName;
+
+    static int constructed;
+    static int copied;
+    static int moved;
+};
+
+int CountedValue::constructed = 0;
+int CountedValue::copied = 0;
+int CountedValue::moved = 0;
+
+class TrieValueTestCases : public rtv::RTest
+{
+};
+
+TEST_F(TrieValueTestCases, TrieValueCase_SubscriptDoesNotCopy)
+{
+    rtv::Trie<char, CountedValue> aTrie('\0');
+
+    CountedValue::reset();
+    aTrie["karma"].mValue = 1;
+    EXPECT_TRUE(aTrie["karma"].mValue == 1);
+    EXPECT_TRUE(aTrie.size() == 1);
+#ifdef RTV_HAS_CXX11
+    EXPECT_TRUE(CountedValue::constructed == 1);
+    EXPECT_TRUE(CountedValue::copied == 0);
+#endif
+}
+
+TEST_F(TrieValueTestCases, TrieValueCase_InsertOrAssign)
+{
+    rtv::Trie<char, CountedValue> aTrie('\0');
+
+    CountedValue value(1, "one");
+    EXPECT_TRUE(aTrie.insertOrAssign("karma", value).second);
+    value.mValue = 2;
+    std::pair<rtv::Trie<char, CountedValue>::Iterator, bool> res = aTrie.insertOrAssign("karma", value);
+    EXPECT_FALSE(res.second);
+    EXPECT_TRUE(res.first->second->mValue == 2);
+    EXPECT_TRUE(aTrie.size() == 1);
+}
+
+#ifdef RTV_HAS_CXX11
+TEST_F(TrieValueTestCases, TrieValueCase_InsertMovesValue)
+{
+    rtv::Trie<char, CountedValue> aTrie('\0');
+
+    CountedValue::reset();
+    CountedValue value(1, "one");
+    EXPECT_TRUE(aTrie.insert("karma", std::move(value)).second);
+    EXPECT_TRUE(CountedValue::copied == 0);
+    EXPECT_TRUE(CountedValue::moved == 1);
+    EXPECT_TRUE(aTrie.get("karma")->mName == "one");
+
+    // the value is not moved from when the key is present
+    CountedValue other(2, "two");
+    EXPECT_FALSE(aTrie.insert("karma", std::move(other)).second);
+    EXPECT_TRUE(other.mName == "two");
+    EXPECT_TRUE(CountedValue::moved == 1);
+
+    EXPECT_FALSE(aTrie.insertOrAssign("karma", std::move(other)).second);
+    EXPECT_TRUE(aTrie.get("karma")->mName == "two");
+    EXPECT_TRUE(CountedValue::copied == 0);
+}
+
+TEST_F(TrieValueTestCases, TrieValueCase_Emplace)
+{
+    rtv::Trie<char, CountedValue> aTrie('\0');
+
+    CountedValue::reset();
+    std::pair<rtv::Trie<char, CountedValue>::Iterator, bool> res = aTrie.emplace("karma", 1, "one");
+    EXPECT_TRUE(res.second);
+    EXPECT_TRUE(res.first->second->mValue == 1);
+    EXPECT_TRUE(aTrie.tryEmplace("karma", 2, "two").second == false);
+    EXPECT_TRUE(aTrie.get("karma")->mName == "one");
+    EXPECT_TRUE(aTrie.tryEmplace("dharma", 3, "three").second);
+    EXPECT_TRUE(CountedValue::constructed == 2);
+    EXPECT_TRUE(CountedValue::copied == 0);
+    EXPECT_TRUE(CountedValue::moved == 0);
+    EXPECT_TRUE(aTrie.size() == 2);
+}
+
+TEST_F(TrieValueTestCases, TrieValueCase_MoveOnlyValue)
+{
+    rtv::Trie<char, std::unique_ptr<int>, std::less<char>,
+              rtv::AdaptiveItems<char, std::unique_ptr<int>, std::less<char> > > aTrie('\0', true);
+
+    EXPECT_TRUE(aTrie.insert("karma", std::unique_ptr<int>(new int(1))).second);
+    EXPECT_TRUE(aTrie.emplace("karmic", new int(2)).second);
+    aTrie["kar"].reset(new int(3));
+    EXPECT_TRUE(**aTrie.get("karma") == 1);
+    EXPECT_TRUE(**aTrie.get("karmic") == 2);
+    EXPECT_TRUE(**aTrie.get("kar") == 3);
+    EXPECT_TRUE(aTrie.erase("karma"));
+    EXPECT_TRUE(aTrie.size() == 2);
+}
+#endif
+
+}
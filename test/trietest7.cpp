@@ -0,0 +1,344 @@
+/*
+ * Copyright (c) 2012, Ranjith TV
+ * All rights reserved.
+ *
+ * Licensed under the BSD 3-Clause ("BSD New" or "BSD Simplified") license.
+ * You may obtain a copy of the License at
+ *
+ * http://www.opensource.org/licenses/BSD-3-Clause
+ *
+ */
+
+#include "concurrent_trie.h"
+#include "trietest.h"
+#include "testsuite.h"
+
+#include <map>
+#include <string>
+#include <vector>
+#include <cstdlib>
+
+#ifdef RTV_HAS_CXX11
+#include <atomic>
+#include <thread>
+#endif
+
+using namespace rtv;
+
+namespace
+{
+
+#ifdef RTV_HAS_CXX11
+
+// Collects the keys visited by ConcurrentTrie::startsWith
+class KeyCollector
+{
+public:
+    void operator()(const char *key, std::size_t length, int const &value) {
+        mKeys[std::string(key, length)] = value;
+    }
+
+    std::map<std::string, int> mKeys;
+};
+
+class ConcurrentTrieTestCases : public rtv::RTest
+{
+protected:
+    typedef rtv::ConcurrentTrie<char, int> TheTrie;
+    typedef std::map<std::string, int> Expected;
+
+    void checkContents(TheTrie &aTrie, Expected const &expected) {
+        EXPECT_TRUE(aTrie.size() == expected.size());
+        EXPECT_TRUE(aTrie.startsWith("", KeyCollector()).mKeys == expected);
+
+        for (Expected::const_iterator iter = expected.begin(); iter != expected.end(); ++iter) {
+            int value = -1;
+            EXPECT_TRUE(aTrie.get(iter->first.c_str(), value) && value == iter->second);
+            TheTrie::ReadGuard guard(aTrie);
+            const int *found = aTrie.find(guard, iter->first.c_str(), iter->first.length());
+            EXPECT_TRUE(found && *found == iter->second);
+
+            std::string prefix = iter->first.substr(0, iter->first.length() / 2);
+            Expected withPrefix;
+            for (Expected::const_iterator piter = expected.lower_bound(prefix);
+                 piter != expected.end() && piter->first.compare(0, prefix.length(), prefix) == 0; ++piter) {
+                withPrefix.insert(*piter);
+            }
+            EXPECT_TRUE(aTrie.startsWith(prefix.c_str(), KeyCollector()).mKeys == withPrefix);
+        }
+    }
+};
+
+TEST_F(ConcurrentTrieTestCases, ConcurrentTrieCase_Oracle)
+{
+    const char *parts[] = {"a", "ab", "abc", "b", "ba", "karma", "dharma", ""};
+
+    TheTrie aTrie('\0');
+    Expected expected;
+
+    std::srand(5);
+    for (int round = 0; round < 3000; ++round) {
+        std::string key;
+        int depth = std::rand() % 4;
+        for (int i = 0; i < depth; ++i) {
+            key += parts[std::rand() % 8];
+        }
+
+        int op = std::rand() % 4;
+        if (op == 0) {
+            bool inserted = aTrie.insert(key.c_str(), round);
+            EXPECT_TRUE(inserted == (expected.find(key) == expected.end()));
+            expected.insert(std::make_pair(key, round));
+        } else if (op == 1) {
+            bool inserted = aTrie.insertOrAssign(key.c_str(), key.length(), round);
+            EXPECT_TRUE(inserted == (expected.find(key) == expected.end()));
+            expected[key] = round;
+        } else {
+            bool erased = aTrie.erase(key.c_str());
+            EXPECT_TRUE(erased == (expected.erase(key) == 1));
+        }
+        EXPECT_TRUE(aTrie.hasKey(key.c_str()) == (expected.find(key) != expected.end()));
+        EXPECT_TRUE(aTrie.hasKey(key.c_str(), key.length()) == (expected.find(key) != expected.end()));
+
+        if (round % 500 == 0) {
+            checkContents(aTrie, expected);
+        }
+    }
+    checkContents(aTrie, expected);
+
+    aTrie.clear();
+    expected.clear();
+    checkContents(aTrie, expected);
+    EXPECT_TRUE(aTrie.empty());
+}
+
+TEST_F(ConcurrentTrieTestCases, ConcurrentTrieCase_ReadersWhileWriting)
+{
+    // the value of a key is always its index, so the readers can check what they find
+    std::vector<std::string> keys;
+    for (int i = 0; i < 200; ++i) {
+        std::string key(1, 'a' + i % 7);
+        for (int n = i; n > 0; n /= 5) {
+            key += (char)('a' + n % 5);
+        }
+        keys.push_back(key);
+    }
+
+    TheTrie aTrie('\0');
+    for (std::size_t i = 0; i < keys.size(); i += 2) {
+        aTrie.insert(keys[i].c_str(), (int)i);
+    }
+
+    std::atomic<bool> done(false);
+    std::atomic<int> wrong(0);
+    std::atomic<long> lookups(0);
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 4; ++r) {
+        readers.push_back(std::thread([&]() {
+            while (!done.load()) {
+                for (std::size_t i = 0; i < keys.size(); ++i) {
+                    int value = -1;
+                    if (aTrie.get(keys[i].c_str(), value) && value != (int)i) {
+                        ++wrong;
+                    }
+                    TheTrie::ReadGuard guard(aTrie);
+                    const int *found = aTrie.find(guard, keys[i].c_str());
+                    if (found && *found != (int)i) {
+                        ++wrong;
+                    }
+                }
+                aTrie.startsWith("a", [&](const char *key, std::size_t length, int const &value) {
+                    if (keys[value] != std::string(key, length)) {
+                        ++wrong;
+                    }
+                });
+                ++lookups;
+            }
+        }));
+    }
+
+    while (lookups.load() == 0) {
+        std::this_thread::yield();
+    }
+
+    // odd keys come and go while the even keys stay
+    for (int round = 0; round < 50; ++round) {
+        for (std::size_t i = 1; i < keys.size(); i += 2) {
+            aTrie.insertOrAssign(keys[i].c_str(), (int)i);
+        }
+        for (std::size_t i = 1; i < keys.size(); i += 2) {
+            aTrie.erase(keys[i].c_str());
+        }
+        std::this_thread::yield();
+    }
+    done.store(true);
+    for (std::size_t r = 0; r < readers.size(); ++r) {
+        readers[r].join();
+    }
+
+    EXPECT_TRUE(wrong.load() == 0);
+    EXPECT_TRUE(aTrie.size() == keys.size() / 2);
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        EXPECT_TRUE(aTrie.hasKey(keys[i].c_str()) == (i % 2 == 0));
+    }
+}
+
+TEST_F(ConcurrentTrieTestCases, ConcurrentTrieCase_ParallelWriters)
+{
+    const char *parts[] = {"a", "ab", "abc", "b", "ba", "karma", "dharma", ""};
+    const unsigned int writers = 4;
+
+    // the keys share their prefixes but each key is modified by one writer, which keeps its own oracle
+    TheTrie aTrie('\0');
+    std::vector<Expected> expected(writers);
+    std::atomic<int> wrong(0);
+    std::atomic<bool> done(false);
+    std::vector<std::thread> threads;
+    for (unsigned int w = 0; w < writers; ++w) {
+        threads.push_back(std::thread([&, w]() {
+            unsigned int seed = w + 1;
+            for (int round = 0; round < 20000; ++round) {
+                seed = seed * 1103515245 + 12345;
+                std::string key;
+                int depth = (seed >> 8) % 5;
+                for (int i = 0; i < depth; ++i) {
+                    seed = seed * 1103515245 + 12345;
+                    key += parts[(seed >> 8) % 8];
+                }
+                if (std::hash<std::string>()(key) % writers != w) {
+                    continue;
+                }
+
+                Expected &mine = expected[w];
+                seed = seed * 1103515245 + 12345;
+                int op = (seed >> 8) % 3;
+                if (op == 0) {
+                    bool inserted = aTrie.insert(key.c_str(), round);
+                    if (inserted != (mine.find(key) == mine.end())) {
+                        ++wrong;
+                    }
+                    mine.insert(std::make_pair(key, round));
+                } else if (op == 1) {
+                    bool inserted = aTrie.insertOrAssign(key.c_str(), key.length(), round);
+                    if (inserted != (mine.find(key) == mine.end())) {
+                        ++wrong;
+                    }
+                    mine[key] = round;
+                } else if (aTrie.erase(key.c_str()) != (mine.erase(key) == 1)) {
+                    ++wrong;
+                }
+
+                int value = -1;
+                Expected::const_iterator iter = mine.find(key);
+                if (aTrie.get(key.c_str(), value) != (iter != mine.end()) ||
+                    (iter != mine.end() && value != iter->second)) {
+                    ++wrong;
+                }
+            }
+        }));
+    }
+
+    // a reader walks through the nodes which are being unlinked and linked again
+    std::thread reader([&]() {
+        while (!done.load()) {
+            aTrie.startsWith("ab", [&](const char *key, std::size_t length, int const &) {
+                if (std::string(key, length).compare(0, 2, "ab") != 0) {
+                    ++wrong;
+                }
+            });
+        }
+    });
+
+    for (unsigned int w = 0; w < writers; ++w) {
+        threads[w].join();
+    }
+    done.store(true);
+    reader.join();
+
+    EXPECT_TRUE(wrong.load() == 0);
+    Expected all;
+    for (unsigned int w = 0; w < writers; ++w) {
+        all.insert(expected[w].begin(), expected[w].end());
+    }
+    checkContents(aTrie, all);
+}
+
+TEST_F(ConcurrentTrieTestCases, ConcurrentTrieCase_ClearWhileWriting)
+{
+    TheTrie aTrie('\0');
+    std::atomic<bool> done(false);
+    std::vector<std::thread> threads;
+    for (int w = 0; w < 3; ++w) {
+        threads.push_back(std::thread([&, w]() {
+            for (int i = 0; i < 5000; ++i) {
+                std::string key(1, 'a' + w);
+                for (int n = i % 300; n > 0; n /= 4) {
+                    key += (char)('a' + n % 4);
+                }
+                if (i % 3 == 2) {
+                    aTrie.erase(key.c_str());
+                } else {
+                    aTrie.insertOrAssign(key.c_str(), i);
+                }
+            }
+        }));
+    }
+    std::thread clearer([&]() {
+        while (!done.load()) {
+            aTrie.clear();
+            std::this_thread::yield();
+        }
+    });
+
+    for (std::size_t w = 0; w < threads.size(); ++w) {
+        threads[w].join();
+    }
+    done.store(true);
+    clearer.join();
+
+    // the size counts exactly the keys which survived the clears
+    Expected found = aTrie.startsWith("", KeyCollector()).mKeys;
+    checkContents(aTrie, found);
+}
+
+TEST_F(ConcurrentTrieTestCases, ConcurrentTrieCase_ThrowingValue)
+{
+    typedef rtv::ConcurrentTrie<char, ThrowingValue> ThrowingTrie;
+    ThrowingTrie aTrie('\0');
+    EXPECT_TRUE(aTrie.insert("karma", ThrowingValue(1)));
+
+    // new branches, a node already there without a value and a value replaced, each copy throws
+    const char *keys[] = {"karmic", "dharma", "kar", "karma"};
+    ThrowingValue::armed() = true;
+    int thrown = 0;
+    for (int i = 0; i < 4; ++i) {
+        try {
+            aTrie.insertOrAssign(keys[i], ThrowingValue(-1));
+        } catch (std::runtime_error const &) {
+            ++thrown;
+        }
+    }
+    ThrowingValue::armed() = false;
+    EXPECT_TRUE(thrown == 4);
+    EXPECT_TRUE(aTrie.size() == 1);
+    ThrowingValue value(0);
+    EXPECT_TRUE(aTrie.get("karma", value) && value.mValue == 1);
+    EXPECT_TRUE(!aTrie.hasKey("karmic") && !aTrie.hasKey("dharma") && !aTrie.hasKey("kar"));
+
+    // no node is left locked, another thread reads and writes the same keys
+    std::thread other([&]() {
+        for (int i = 0; i < 4; ++i) {
+            aTrie.insertOrAssign(keys[i], ThrowingValue(i + 2));
+        }
+        aTrie.erase("kar");
+    });
+    other.join();
+    EXPECT_TRUE(aTrie.size() == 3);
+    EXPECT_TRUE(aTrie.get("karma", value) && value.mValue == 5);
+    EXPECT_TRUE(aTrie.get("karmic", value) && value.mValue == 2);
+    EXPECT_TRUE(aTrie.erase("karmic") && aTrie.erase("karma") && aTrie.erase("dharma") && aTrie.empty());
+}
+
+#endif
+
+}
@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2012, Ranjith TV
+ * All rights reserved.
+ *
+ * Licensed under the BSD 3-Clause ("BSD New" or "BSD Simplified") license.
+ * You may obtain a copy of the License at
+ *
+ * http://www.opensource.org/licenses/BSD-3-Clause
+ *
+ */
+
+#include "persistent_trie.h"
+#include "testsuite.h"
+
+#include <map>
+#include <string>
+#include <vector>
+#include <cstdlib>
+
+#ifdef RTV_HAS_CXX11
+#include <atomic>
+#include <thread>
+#endif
+
+using namespace rtv;
+
+namespace
+{
+
+#ifdef RTV_HAS_CXX11
+
+class PersistentTrieTestCases : public rtv::RTest
+{
+protected:
+    typedef rtv::PersistentTrie<char, int> TheTrie;
+    typedef TheTrie::Snapshot Snapshot;
+    typedef std::map<std::string, int> Expected;
+
+    void checkContents(Snapshot const &snapshot, Expected const &expected) {
+        EXPECT_TRUE(snapshot.size() == expected.size());
+
+        Expected::const_iterator eiter = expected.begin();
+        for (TheTrie::ConstIterator iter = snapshot.begin(); iter != snapshot.end(); ++iter, ++eiter) {
+            EXPECT_TRUE(eiter != expected.end() && eiter->first.compare(iter->first) == 0);
+            EXPECT_TRUE(eiter != expected.end() && *iter->second == eiter->second);
+        }
+        EXPECT_TRUE(eiter == expected.end());
+
+        for (Expected::const_iterator iter = expected.begin(); iter != expected.end(); ++iter) {
+            EXPECT_TRUE(snapshot.get(iter->first.c_str()) && *snapshot.get(iter->first.c_str()) == iter->second);
+            EXPECT_TRUE(snapshot.hasKey(iter->first.c_str(), iter->first.length()));
+
+            std::string prefix = iter->first.substr(0, iter->first.length() / 2);
+            Expected::const_iterator piter = expected.lower_bound(prefix);
+            TheTrie::ConstIterator siter = snapshot.startsWith(prefix.c_str(), prefix.length());
+            for (; siter != snapshot.end(); ++siter, ++piter) {
+                EXPECT_TRUE(piter != expected.end() && piter->first.compare(siter->first) == 0);
+            }
+            EXPECT_TRUE(piter == expected.end() || piter->first.compare(0, prefix.length(), prefix) != 0);
+        }
+    }
+};
+
+TEST_F(PersistentTrieTestCases, PersistentTrieCase_SnapshotsKeepTheirVersion)
+{
+    const char *parts[] = {"a", "ab", "abc", "b", "ba", "karma", "dharma", ""};
+
+    TheTrie aTrie('\0');
+    Expected expected;
+    std::vector<Snapshot> snapshots;
+    std::vector<Expected> versions;
+
+    std::srand(3);
+    for (int round = 0; round < 3000; ++round) {
+        std::string key;
+        int depth = std::rand() % 4;
+        for (int i = 0; i < depth; ++i) {
+            key += parts[std::rand() % 8];
+        }
+
+        int op = std::rand() % 4;
+        if (op == 0) {
+            bool inserted = aTrie.insert(key.c_str(), round);
+            EXPECT_TRUE(inserted == (expected.find(key) == expected.end()));
+            expected.insert(std::make_pair(key, round));
+        } else if (op == 1) {
+            bool inserted = aTrie.insertOrAssign(key.c_str(), key.length(), round);
+            EXPECT_TRUE(inserted == (expected.find(key) == expected.end()));
+            expected[key] = round;
+        } else {
+            bool erased = aTrie.erase(key.c_str());
+            EXPECT_TRUE(erased == (expected.erase(key) == 1));
+        }
+        EXPECT_TRUE(aTrie.size() == expected.size());
+
+        if (round % 250 == 0) {
+            snapshots.push_back(aTrie.snapshot());
+            versions.push_back(expected);
+        }
+    }
+    checkContents(aTrie.snapshot(), expected);
+
+    for (std::size_t i = 0; i < snapshots.size(); ++i) {
+        checkContents(snapshots[i], versions[i]);
+    }
+
+    // the snapshots outlive the Trie and each other
+    Snapshot last = snapshots.back();
+    aTrie.clear();
+    EXPECT_TRUE(aTrie.empty());
+    checkContents(aTrie.snapshot(), Expected());
+    snapshots.clear();
+    checkContents(last, versions.back());
+}
+
+TEST_F(PersistentTrieTestCases, PersistentTrieCase_IterateWhileWriting)
+{
+    TheTrie aTrie('\0');
+    Expected expected;
+    for (int i = 0; i < 300; ++i) {
+        std::string key(1, 'a' + i % 11);
+        for (int n = i; n > 0; n /= 7) {
+            key += (char)('a' + n % 7);
+        }
+        aTrie.insert(key.c_str(), i);
+        expected[key] = i;
+    }
+    Snapshot snapshot = aTrie.snapshot();
+
+    std::atomic<bool> done(false);
+    std::atomic<int> wrong(0);
+    std::thread reader([&]() {
+        while (!done.load()) {
+            Expected::const_iterator eiter = expected.begin();
+            for (TheTrie::ConstIterator iter = snapshot.begin(); iter != snapshot.end(); ++iter, ++eiter) {
+                if (eiter == expected.end() || eiter->first.compare(iter->first) != 0 ||
+                    *iter->second != eiter->second) {
+                    ++wrong;
+                }
+            }
+            if (eiter != expected.end()) {
+                ++wrong;
+            }
+            // snapshots taken by the reader itself while the writer goes on
+            Snapshot current = aTrie.snapshot();
+            std::size_t count = 0;
+            for (TheTrie::ConstIterator iter = current.begin(); iter != current.end(); ++iter) {
+                ++count;
+            }
+            if (count != current.size()) {
+                ++wrong;
+            }
+        }
+    });
+
+    for (int round = 0; round < 20; ++round) {
+        for (Expected::const_iterator iter = expected.begin(); iter != expected.end(); ++iter) {
+            if ((iter->second + round) % 3 == 0) {
+                aTrie.erase(iter->first.c_str());
+            } else {
+                aTrie.insertOrAssign(iter->first.c_str(), -iter->second);
+            }
+        }
+        std::this_thread::yield();
+    }
+    done.store(true);
+    reader.join();
+
+    EXPECT_TRUE(wrong.load() == 0);
+    checkContents(snapshot, expected);
+}
+
+#endif
+
+}
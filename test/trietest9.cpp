@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2012, Ranjith TV
+ * All rights reserved.
+ *
+ * Licensed under the BSD 3-Clause ("BSD New" or "BSD Simplified") license.
+ * You may obtain a copy of the License at
+ *
+ * http://www.opensource.org/licenses/BSD-3-Clause
+ *
+ */
+
+#include "sharded_trie.h"
+#include "testsuite.h"
+
+#include <map>
+#include <string>
+#include <vector>
+#include <cstdlib>
+
+#ifdef RTV_HAS_CXX11
+#include <atomic>
+#include <thread>
+#endif
+
+using namespace rtv;
+
+namespace
+{
+
+#ifdef RTV_HAS_CXX11
+
+class ShardedTrieTestCases : public rtv::RTest
+{
+protected:
+    typedef rtv::ShardedTrie<char, int> TheTrie;
+    typedef std::map<std::string, int> Expected;
+
+    void checkContents(TheTrie const &aTrie, Expected const &expected) {
+        EXPECT_TRUE(aTrie.size() == expected.size());
+
+        Expected::const_iterator eiter = expected.begin();
+        for (TheTrie::ConstIterator iter = aTrie.begin(); iter != aTrie.end(); ++iter, ++eiter) {
+            EXPECT_TRUE(eiter != expected.end() && eiter->first.compare(iter->first) == 0);
+            EXPECT_TRUE(eiter != expected.end() && *iter->second == eiter->second);
+        }
+        EXPECT_TRUE(eiter == expected.end());
+
+        for (Expected::const_iterator iter = expected.begin(); iter != expected.end(); ++iter) {
+            int value = -1;
+            EXPECT_TRUE(aTrie.get(iter->first.c_str(), value) && value == iter->second);
+            EXPECT_TRUE(aTrie.hasKey(iter->first.c_str(), iter->first.length()));
+
+            // prefixes both shorter and longer than the symbols which choose the shard
+            for (std::size_t length = 0; length <= iter->first.length(); ++length) {
+                std::string prefix = iter->first.substr(0, length);
+                Expected::const_iterator piter = expected.lower_bound(prefix);
+                TheTrie::ConstIterator siter = aTrie.startsWith(prefix.c_str(), prefix.length());
+                for (; siter != aTrie.end(); ++siter, ++piter) {
+                    EXPECT_TRUE(piter != expected.end() && piter->first.compare(siter->first) == 0);
+                }
+                EXPECT_TRUE(piter == expected.end() || piter->first.compare(0, prefix.length(), prefix) != 0);
+            }
+        }
+    }
+};
+
+TEST_F(ShardedTrieTestCases, ShardedTrieCase_Oracle)
+{
+    const char *parts[] = {"a", "ab", "abc", "b", "ba", "karma", "dharma", ""};
+
+    std::size_t prefixLengths[] = {1, 2, 3};
+    for (std::size_t p = 0; p < 3; ++p) {
+        TheTrie aTrie('\0', 7, prefixLengths[p]);
+        Expected expected;
+
+        std::srand(7);
+        for (int round = 0; round < 2000; ++round) {
+            std::string key;
+            int depth = std::rand() % 4;
+            for (int i = 0; i < depth; ++i) {
+                key += parts[std::rand() % 8];
+            }
+
+            int op = std::rand() % 4;
+            if (op == 0) {
+                bool inserted = aTrie.insert(key.c_str(), round);
+                EXPECT_TRUE(inserted == (expected.find(key) == expected.end()));
+                expected.insert(std::make_pair(key, round));
+            } else if (op == 1) {
+                bool inserted = aTrie.insertOrAssign(key.c_str(), key.length(), round);
+                EXPECT_TRUE(inserted == (expected.find(key) == expected.end()));
+                expected[key] = round;
+            } else {
+                bool erased = aTrie.erase(key.c_str());
+                EXPECT_TRUE(erased == (expected.erase(key) == 1));
+            }
+            EXPECT_TRUE(aTrie.hasKey(key.c_str()) == (expected.find(key) != expected.end()));
+        }
+        checkContents(aTrie, expected);
+
+        aTrie.clear();
+        EXPECT_TRUE(aTrie.empty());
+        checkContents(aTrie, Expected());
+    }
+}
+
+TEST_F(ShardedTrieTestCases, ShardedTrieCase_EndSymbolOrder)
+{
+    // '$' sorts above '!' and '#', a key still comes before its extensions in the other shards
+    const char *keys[] = {"$", "a$", "a!$", "ab$", "ab!$", "ab#$", "b#$", "b$", "!$"};
+
+    std::size_t prefixLengths[] = {1, 2, 3};
+    for (std::size_t p = 0; p < 3; ++p) {
+        TheTrie aTrie('$', 16, prefixLengths[p]);
+        rtv::Trie<char, int> oracle('$');
+        for (int i = 0; i < 9; ++i) {
+            EXPECT_TRUE(aTrie.insert(keys[i], i));
+            oracle.insert(keys[i], i);
+        }
+
+        rtv::Trie<char, int>::ConstIterator oiter = oracle.begin();
+        for (TheTrie::ConstIterator iter = aTrie.begin(); iter != aTrie.end(); ++iter, ++oiter) {
+            EXPECT_TRUE(oiter != oracle.end() && *iter->second == *oiter->second);
+        }
+        EXPECT_TRUE(oiter == oracle.end());
+
+        oiter = oracle.startsWith("a$");
+        for (TheTrie::ConstIterator iter = aTrie.startsWith("a$"); iter != aTrie.end(); ++iter, ++oiter) {
+            EXPECT_TRUE(oiter != oracle.end() && *iter->second == *oiter->second);
+        }
+        EXPECT_TRUE(oiter == oracle.end());
+    }
+}
+
+TEST_F(ShardedTrieTestCases, ShardedTrieCase_ParallelWriters)
+{
+    std::vector<std::string> keys;
+    for (int i = 0; i < 2000; ++i) {
+        std::string key(1, 'a' + i % 13);
+        for (int n = i; n > 0; n /= 6) {
+            key += (char)('a' + n % 6);
+        }
+        keys.push_back(key);
+    }
+
+    TheTrie aTrie('\0', 8);
+    std::atomic<int> wrong(0);
+    std::vector<std::thread> writers;
+    for (std::size_t w = 0; w < 4; ++w) {
+        writers.push_back(std::thread([&, w]() {
+            // each writer owns a quarter of the keys and reads the others' keys
+            for (std::size_t i = w; i < keys.size(); i += 4) {
+                if (!aTrie.insert(keys[i].c_str(), (int)i)) {
+                    ++wrong;
+                }
+                int value = -1;
+                std::size_t other = (i + 1) % keys.size();
+                if (aTrie.get(keys[other].c_str(), value) && value != (int)other) {
+                    ++wrong;
+                }
+            }
+            for (std::size_t i = w; i < keys.size(); i += 8) {
+                if (!aTrie.erase(keys[i].c_str())) {
+                    ++wrong;
+                }
+            }
+        }));
+    }
+    for (std::size_t w = 0; w < writers.size(); ++w) {
+        writers[w].join();
+    }
+
+    EXPECT_TRUE(wrong.load() == 0);
+
+    Expected expected;
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        if (i % 8 >= 4) {
+            expected[keys[i]] = (int)i;
+        }
+    }
+    checkContents(aTrie, expected);
+}
+
+#endif
+
+}